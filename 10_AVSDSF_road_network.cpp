@@ -0,0 +1,593 @@
+/*
+AVSDSF - Road-network distance engine with contraction hierarchies
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include "avsdsf_model.h"
+
+// Contraction parameters
+const int WITNESS_SETTLE_LIMIT = 500;  // Nodes settled per witness search before giving up
+const double DISTANCE_REFERENCE = 110.0; // Road distance (m) at which transferCost applies unscaled
+const double INF_DISTANCE = std::numeric_limits<double>::infinity();
+
+struct RoadEdge {
+    int to;
+    double length; // metres
+};
+
+// Undirected road graph (roads are treated as two-way)
+struct RoadGraph {
+    int numNodes = 0;
+    std::vector<std::vector<RoadEdge>> adjacency;
+    std::vector<double> x; // Planar position of each node (metres)
+    std::vector<double> y;
+
+    void addEdge(int a, int b, double length) {
+        if (a == b) return;
+        adjacency[a].push_back({b, length});
+        adjacency[b].push_back({a, length});
+    }
+};
+
+// Synthetic Manhattan grid with congestion-weighted blocks and closed segments
+RoadGraph buildGridGraph(int width, int height, double spacing, unsigned seed) {
+    RoadGraph graph;
+    graph.numNodes = width * height;
+    graph.adjacency.resize(graph.numNodes);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> congestion(1.0, 1.6);
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            int node = row * width + column;
+            graph.x.push_back(column * spacing);
+            graph.y.push_back(row * spacing);
+            if (column + 1 < width && unit(gen) > 0.08) graph.addEdge(node, node + 1, spacing * congestion(gen));
+            if (row + 1 < height && unit(gen) > 0.08) graph.addEdge(node, node + width, spacing * congestion(gen));
+        }
+    }
+    return graph;
+}
+
+// Value of an XML attribute on a single line, or empty
+std::string xmlAttribute(const std::string& line, const std::string& name) {
+    std::string key = " " + name + "=\"";
+    size_t start = line.find(key);
+    if (start == std::string::npos) return "";
+    start += key.size();
+    size_t end = line.find('"', start);
+    return end == std::string::npos ? "" : line.substr(start, end - start);
+}
+
+// Load the drivable ways of a local OSM XML extract (one element per line, as
+// written by osmium/osmconvert). Returns false if the file cannot be read.
+bool loadOsmGraph(const std::string& path, RoadGraph& graph) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::unordered_map<long long, int> nodeIndex;
+    std::vector<double> lat, lon;
+    std::vector<std::pair<long long, long long>> segments;
+    std::vector<long long> wayNodes;
+    bool inWay = false, drivable = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find("<node ") != std::string::npos) {
+            std::string id = xmlAttribute(line, "id");
+            if (id.empty()) continue;
+            nodeIndex[std::stoll(id)] = static_cast<int>(lat.size());
+            lat.push_back(std::stod(xmlAttribute(line, "lat")));
+            lon.push_back(std::stod(xmlAttribute(line, "lon")));
+        } else if (line.find("<way ") != std::string::npos) {
+            inWay = true;
+            drivable = false;
+            wayNodes.clear();
+        } else if (inWay && line.find("<nd ") != std::string::npos) {
+            wayNodes.push_back(std::stoll(xmlAttribute(line, "ref")));
+        } else if (inWay && line.find("k=\"highway\"") != std::string::npos) {
+            std::string value = xmlAttribute(line, "v");
+            drivable = value != "footway" && value != "cycleway" && value != "path" && value != "steps" && value != "pedestrian";
+        } else if (inWay && line.find("</way>") != std::string::npos) {
+            if (drivable) {
+                for (size_t i = 1; i < wayNodes.size(); ++i) segments.push_back({wayNodes[i - 1], wayNodes[i]});
+            }
+            inWay = false;
+        }
+    }
+    if (lat.empty() || segments.empty()) return false;
+
+    // Equirectangular projection around the extract's first node
+    const double earthRadius = 6371000.0;
+    const double degToRad = M_PI / 180.0;
+    graph.numNodes = static_cast<int>(lat.size());
+    graph.adjacency.assign(graph.numNodes, {});
+    graph.x.resize(graph.numNodes);
+    graph.y.resize(graph.numNodes);
+    for (int i = 0; i < graph.numNodes; ++i) {
+        graph.x[i] = (lon[i] - lon[0]) * degToRad * earthRadius * std::cos(lat[0] * degToRad);
+        graph.y[i] = (lat[i] - lat[0]) * degToRad * earthRadius;
+    }
+    for (const auto& [a, b] : segments) {
+        auto ia = nodeIndex.find(a), ib = nodeIndex.find(b);
+        if (ia == nodeIndex.end() || ib == nodeIndex.end()) continue;
+        graph.addEdge(ia->second, ib->second, std::hypot(graph.x[ia->second] - graph.x[ib->second],
+                                                         graph.y[ia->second] - graph.y[ib->second]));
+    }
+    return true;
+}
+
+// Contraction hierarchy over an undirected road graph. Queries run upward
+// searches from both ends; many-to-many RSU distances use per-node buckets.
+class ContractionHierarchy {
+private:
+    int numNodes;
+    std::vector<int> rank;
+    // Upward graph in CSR form: edges to higher-ranked nodes
+    std::vector<int> upOffset;
+    std::vector<RoadEdge> upEdges;
+
+    // Query scratch space, reset lazily with a generation stamp
+    mutable std::vector<double> distForward, distBackward;
+    mutable std::vector<uint32_t> stampForward, stampBackward;
+    mutable uint32_t generation = 0;
+    mutable std::vector<int> settled;
+
+    // Many-to-many buckets: for each node, (target index, distance) from the targets' upward searches
+    std::vector<int> bucketOffset;
+    std::vector<std::pair<int, double>> bucketEntries;
+    int numTargets = 0;
+
+    using QueueEntry = std::pair<double, int>;
+    using MinQueue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+    // Local Dijkstra on the remaining graph from `source`, skipping `skip`
+    static void witnessSearch(const std::vector<std::unordered_map<int, double>>& graph, const std::vector<bool>& contracted,
+                              int source, int skip, double limit, std::unordered_map<int, double>& dist) {
+        dist.clear();
+        MinQueue queue;
+        dist[source] = 0.0;
+        queue.push({0.0, source});
+        int settledCount = 0;
+        while (!queue.empty() && settledCount < WITNESS_SETTLE_LIMIT) {
+            auto [d, node] = queue.top();
+            queue.pop();
+            if (d > dist[node]) continue;
+            if (d > limit) break;
+            settledCount++;
+            for (const auto& [next, length] : graph[node]) {
+                if (next == skip || contracted[next]) continue;
+                double nd = d + length;
+                auto it = dist.find(next);
+                if (it == dist.end() || nd < it->second) {
+                    dist[next] = nd;
+                    queue.push({nd, next});
+                }
+            }
+        }
+    }
+
+    // Shortcuts needed to contract `node`; only counted when `apply` is false
+    static int contractNode(std::vector<std::unordered_map<int, double>>& graph, const std::vector<bool>& contracted,
+                            int node, bool apply, std::vector<std::tuple<int, int, double>>* added) {
+        std::vector<std::pair<int, double>> neighbors;
+        double maxLength = 0.0;
+        for (const auto& [next, length] : graph[node]) {
+            if (!contracted[next]) {
+                neighbors.push_back({next, length});
+                maxLength = std::max(maxLength, length);
+            }
+        }
+        int shortcuts = 0;
+        std::unordered_map<int, double> dist;
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            auto [u, lengthU] = neighbors[i];
+            witnessSearch(graph, contracted, u, node, lengthU + maxLength, dist);
+            for (size_t j = i + 1; j < neighbors.size(); ++j) {
+                auto [w, lengthW] = neighbors[j];
+                double via = lengthU + lengthW;
+                auto it = dist.find(w);
+                if (it != dist.end() && it->second <= via) continue; // Witness path exists
+                shortcuts++;
+                if (apply) added->emplace_back(u, w, via);
+            }
+        }
+        return shortcuts;
+    }
+
+    // Settle the full upward search space of `source` into `settled`/`dist`
+    void upwardSearch(int source, std::vector<double>& dist, std::vector<uint32_t>& stamp) const {
+        settled.clear();
+        MinQueue queue;
+        dist[source] = 0.0;
+        stamp[source] = generation;
+        queue.push({0.0, source});
+        while (!queue.empty()) {
+            auto [d, node] = queue.top();
+            queue.pop();
+            if (d > dist[node]) continue;
+            settled.push_back(node);
+            for (int e = upOffset[node]; e < upOffset[node + 1]; ++e) {
+                const RoadEdge& edge = upEdges[e];
+                double nd = d + edge.length;
+                if (stamp[edge.to] != generation || nd < dist[edge.to]) {
+                    stamp[edge.to] = generation;
+                    dist[edge.to] = nd;
+                    queue.push({nd, edge.to});
+                }
+            }
+        }
+    }
+
+public:
+    long long shortcutCount = 0;
+
+    explicit ContractionHierarchy(const RoadGraph& road) : numNodes(road.numNodes), rank(road.numNodes, -1) {
+        std::vector<std::unordered_map<int, double>> graph(numNodes);
+        for (int node = 0; node < numNodes; ++node) {
+            for (const auto& edge : road.adjacency[node]) {
+                auto it = graph[node].find(edge.to);
+                if (it == graph[node].end() || edge.length < it->second) graph[node][edge.to] = edge.length;
+            }
+        }
+        std::vector<std::unordered_map<int, double>> allEdges = graph; // Original edges plus shortcuts
+        std::vector<bool> contracted(numNodes, false);
+        std::vector<int> deletedNeighbors(numNodes, 0);
+        std::vector<int> level(numNodes, 0); // Depth in the hierarchy, keeps search spaces shallow
+
+        auto priority = [&](int node) {
+            int degree = 0;
+            for (const auto& entry : graph[node]) {
+                if (!contracted[entry.first]) degree++;
+            }
+            return 2 * (contractNode(graph, contracted, node, false, nullptr) - degree) + deletedNeighbors[node] + level[node];
+        };
+
+        // Lazy-update node ordering by edge difference, contracted neighbours and level
+        MinQueue order;
+        for (int node = 0; node < numNodes; ++node) order.push({static_cast<double>(priority(node)), node});
+        int nextRank = 0;
+        std::vector<std::tuple<int, int, double>> added;
+        while (!order.empty()) {
+            auto [p, node] = order.top();
+            order.pop();
+            if (contracted[node]) continue;
+            double current = priority(node);
+            if (!order.empty() && current > order.top().first) {
+                order.push({current, node});
+                continue;
+            }
+            added.clear();
+            contractNode(graph, contracted, node, true, &added);
+            for (const auto& [u, w, length] : added) {
+                for (auto [a, b] : {std::pair<int, int>{u, w}, std::pair<int, int>{w, u}}) {
+                    auto it = graph[a].find(b);
+                    if (it == graph[a].end() || length < it->second) {
+                        graph[a][b] = length;
+                        allEdges[a][b] = length;
+                    }
+                }
+                shortcutCount++;
+            }
+            contracted[node] = true;
+            rank[node] = nextRank++;
+            for (const auto& entry : graph[node]) {
+                if (!contracted[entry.first]) {
+                    deletedNeighbors[entry.first]++;
+                    level[entry.first] = std::max(level[entry.first], level[node] + 1);
+                }
+            }
+        }
+
+        // Keep only upward edges
+        upOffset.assign(numNodes + 1, 0);
+        for (int node = 0; node < numNodes; ++node) {
+            for (const auto& entry : allEdges[node]) {
+                if (rank[entry.first] > rank[node]) upOffset[node + 1]++;
+            }
+        }
+        for (int node = 0; node < numNodes; ++node) upOffset[node + 1] += upOffset[node];
+        upEdges.resize(upOffset[numNodes]);
+        std::vector<int> fill(upOffset.begin(), upOffset.end() - 1);
+        for (int node = 0; node < numNodes; ++node) {
+            for (const auto& [next, length] : allEdges[node]) {
+                if (rank[next] > rank[node]) upEdges[fill[node]++] = {next, length};
+            }
+        }
+
+        distForward.assign(numNodes, INF_DISTANCE);
+        distBackward.assign(numNodes, INF_DISTANCE);
+        stampForward.assign(numNodes, 0);
+        stampBackward.assign(numNodes, 0);
+    }
+
+    size_t upwardEdgeCount() const { return upEdges.size(); }
+
+    // Point-to-point shortest road distance
+    double query(int source, int target) const {
+        ++generation;
+        upwardSearch(source, distForward, stampForward);
+        upwardSearch(target, distBackward, stampBackward);
+        double best = INF_DISTANCE;
+        for (int node : settled) {
+            if (stampForward[node] == generation) best = std::min(best, distForward[node] + distBackward[node]);
+        }
+        return best;
+    }
+
+    // Precompute buckets for a fixed target set (the RSU road nodes)
+    void buildBuckets(const std::vector<int>& targets) {
+        numTargets = static_cast<int>(targets.size());
+        std::vector<std::vector<std::pair<int, double>>> buckets(numNodes);
+        for (int t = 0; t < numTargets; ++t) {
+            ++generation;
+            upwardSearch(targets[t], distBackward, stampBackward);
+            for (int node : settled) buckets[node].push_back({t, distBackward[node]});
+        }
+        bucketOffset.assign(numNodes + 1, 0);
+        bucketEntries.clear();
+        for (int node = 0; node < numNodes; ++node) {
+            bucketEntries.insert(bucketEntries.end(), buckets[node].begin(), buckets[node].end());
+            bucketOffset[node + 1] = static_cast<int>(bucketEntries.size());
+        }
+    }
+
+    // Distances from `source` to every bucketed target in one upward search
+    void distancesToTargets(int source, std::vector<double>& out) const {
+        out.assign(numTargets, INF_DISTANCE);
+        ++generation;
+        upwardSearch(source, distForward, stampForward);
+        for (int node : settled) {
+            double d = distForward[node];
+            for (int b = bucketOffset[node]; b < bucketOffset[node + 1]; ++b) {
+                const auto& [target, distance] = bucketEntries[b];
+                if (d + distance < out[target]) out[target] = d + distance;
+            }
+        }
+    }
+};
+
+// Plain Dijkstra, used to validate the hierarchy
+double dijkstra(const RoadGraph& graph, int source, int target) {
+    std::vector<double> dist(graph.numNodes, INF_DISTANCE);
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> queue;
+    dist[source] = 0.0;
+    queue.push({0.0, source});
+    while (!queue.empty()) {
+        auto [d, node] = queue.top();
+        queue.pop();
+        if (node == target) return d;
+        if (d > dist[node]) continue;
+        for (const auto& edge : graph.adjacency[node]) {
+            if (d + edge.length < dist[edge.to]) {
+                dist[edge.to] = d + edge.length;
+                queue.push({dist[edge.to], edge.to});
+            }
+        }
+    }
+    return INF_DISTANCE;
+}
+
+// Main algorithm loop with per-RSU road distances in scheduling and transfer
+void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, std::vector<PrefetchedService>& services,
+                    const RoadGraph& graph, const ContractionHierarchy& hierarchy, std::vector<int>& vehicleNodes) {
+    DecisionVariables decisions;
+    std::vector<double> weights;
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<> dis(0.1, 0.3);
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> anyNode(0, graph.numNodes - 1);
+
+    std::vector<std::vector<double>> distance(requests.size());
+    for (int t = 0; t < T; ++t) {
+        // Simulate varying request loads and RSU parameters over time
+        for (auto& request : requests) {
+            double y = dis(gen);
+            request.computationLoad *= y;
+            request.transferCost *= y;
+        }
+        for (auto& rsu : rsus) {
+            rsu.computationCost *= dis(gen);
+            rsu.retentionCost *= dis(gen);
+        }
+
+        // Vehicles move: a third of them are at a new road node this slot
+        for (auto& node : vehicleNodes) {
+            if (unit(gen) < 1.0 / 3) node = anyNode(gen);
+        }
+
+        // Per-RSU road distances for every request
+        auto startDistances = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < requests.size(); ++r) {
+            hierarchy.distancesToTargets(vehicleNodes[r], distance[r]);
+        }
+        auto endDistances = std::chrono::high_resolution_clock::now();
+        double distanceMs = std::chrono::duration<double, std::milli>(endDistances - startDistances).count();
+
+        double load = computeSystemLoad(rsus);
+        weights = computeDynamicWeights(load);
+
+        // Prefetch services
+        for (auto& rsu : rsus) {
+            double remainingCapacity = rsu.maxCapacity - rsu.usedCapacity;
+            for (auto& service : services) {
+                if (service.size <= remainingCapacity) {
+                    decisions.P[service.id] = 1;
+                    remainingCapacity -= service.size;
+                    rsu.usedCapacity += service.size;
+                }
+            }
+        }
+
+        // Schedule requests: transfer term scaled by the road distance to each candidate
+        for (size_t r = 0; r < requests.size(); ++r) {
+            auto& request = requests[r];
+            double minCost = std::numeric_limits<double>::max();
+            int bestRSU = -1;
+            for (auto& rsu : rsus) {
+                if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity && distance[r][rsu.id] < INF_DISTANCE) {
+                    ServiceRequest candidate = request;
+                    candidate.transferCost = request.transferCost * distance[r][rsu.id] / DISTANCE_REFERENCE;
+                    double cost = computePlacementCost(candidate, rsu, weights);
+                    if (cost < minCost) {
+                        minCost = cost;
+                        bestRSU = rsu.id;
+                    }
+                }
+            }
+            if (bestRSU != -1) {
+                decisions.X[request.id] = bestRSU;
+                rsus[bestRSU].usedCapacity += request.computationLoad;
+            }
+        }
+
+        // Transfer requests using the true distance to each RSU
+        int changedByDistance = 0;
+        for (size_t r = 0; r < requests.size(); ++r) {
+            auto& request = requests[r];
+            double minTransferCost = std::numeric_limits<double>::max();
+            double minStaticCost = std::numeric_limits<double>::max();
+            int bestRSU = -1, staticRSU = -1;
+            for (auto& rsu : rsus) {
+                if (rsu.usedCapacity + request.demand <= rsu.maxCapacity) {
+                    double workloadPenalty = rsu.usedCapacity / rsu.maxCapacity;
+                    double transferCost = distance[r][rsu.id] + TRANSFER_COST_MULTIPLIER * workloadPenalty;
+                    double staticCost = request.distanceToRSU + TRANSFER_COST_MULTIPLIER * workloadPenalty;
+                    if (transferCost < minTransferCost) {
+                        minTransferCost = transferCost;
+                        bestRSU = rsu.id;
+                    }
+                    if (staticCost < minStaticCost) {
+                        minStaticCost = staticCost;
+                        staticRSU = rsu.id;
+                    }
+                }
+            }
+            if (bestRSU != -1) {
+                decisions.T[request.id] = bestRSU;
+                rsus[bestRSU].usedCapacity += request.demand;
+                request.distanceToRSU = distance[r][bestRSU];
+                if (bestRSU != staticRSU) changedByDistance++;
+            }
+        }
+
+        // Compute total cost and total latency
+        double totalCost = 0.0;
+        double totalLatency = 0.0;
+        for (size_t r = 0; r < requests.size(); ++r) {
+            const auto& request = requests[r];
+            auto it = decisions.X.find(request.id);
+            if (it == decisions.X.end()) continue;
+            const auto& rsu = rsus[it->second];
+            double transferCost = request.transferCost * distance[r][rsu.id] / DISTANCE_REFERENCE;
+            totalCost += rsu.computationCost * request.computationLoad + rsu.retentionCost + transferCost + request.preparationCost;
+            totalLatency += request.computationLoad * rsu.computationCost + transferCost;
+        }
+        for (const auto& service : services) {
+            if (decisions.P[service.id] == 1) totalCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
+        }
+
+        std::cout << "Time Slot " << t << ": Total Cost = " << totalCost << std::endl;
+        std::cout << "Time Slot " << t << ": Total Latency = " << totalLatency << " microseconds" << std::endl;
+        std::cout << "Time Slot " << t << ": Distance Queries = " << requests.size() * rsus.size() << " in "
+                  << distanceMs << " ms, Transfers Changed by Per-RSU Distance = " << changedByDistance << std::endl;
+
+        // Release capacity held by this slot's requests before the next one
+        for (auto& rsu : rsus) rsu.usedCapacity = 0.0;
+    }
+}
+
+int main(int argc, char** argv) {
+    RoadGraph graph;
+    if (argc > 1 && loadOsmGraph(argv[1], graph)) {
+        std::cout << "Loaded OSM extract " << argv[1] << std::endl;
+    } else {
+        if (argc > 1) std::cout << "Could not read " << argv[1] << ", using synthetic grid" << std::endl;
+        graph = buildGridGraph(100, 100, 100.0, 3);
+    }
+    size_t roadEdges = 0;
+    for (const auto& edges : graph.adjacency) roadEdges += edges.size();
+
+    auto startBuild = std::chrono::high_resolution_clock::now();
+    ContractionHierarchy hierarchy(graph);
+    auto endBuild = std::chrono::high_resolution_clock::now();
+    std::cout << "Road network: " << graph.numNodes << " nodes, " << roadEdges / 2 << " segments; CH built in "
+              << std::chrono::duration<double, std::milli>(endBuild - startBuild).count() << " ms with "
+              << hierarchy.shortcutCount << " shortcuts, " << hierarchy.upwardEdgeCount() << " upward edges" << std::endl;
+
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(64, 2000, 3, 5, rsus, requests, services);
+
+    // RSUs sit at the road node nearest to an evenly spaced grid position
+    double maxX = *std::max_element(graph.x.begin(), graph.x.end());
+    double maxY = *std::max_element(graph.y.begin(), graph.y.end());
+    std::vector<RSULocation> locations = generateRSUGrid(rsus, std::max(maxX, maxY) / 8.0, 0.0);
+    std::vector<int> rsuNodes;
+    for (const auto& location : locations) {
+        int best = 0;
+        double bestDistance = INF_DISTANCE;
+        for (int node = 0; node < graph.numNodes; ++node) {
+            double d = std::hypot(graph.x[node] - location.x, graph.y[node] - location.y);
+            if (d < bestDistance && !graph.adjacency[node].empty()) {
+                bestDistance = d;
+                best = node;
+            }
+        }
+        rsuNodes.push_back(best);
+    }
+    hierarchy.buildBuckets(rsuNodes);
+
+    // Validate the hierarchy against Dijkstra on random pairs
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<int> anyNode(0, graph.numNodes - 1);
+    int mismatches = 0;
+    const int validationPairs = 200;
+    for (int i = 0; i < validationPairs; ++i) {
+        int s = anyNode(gen), t = anyNode(gen);
+        double expected = dijkstra(graph, s, t), actual = hierarchy.query(s, t);
+        if (!(std::isinf(expected) && std::isinf(actual)) && std::fabs(expected - actual) > 1e-6) mismatches++;
+    }
+    std::cout << "Validation: " << mismatches << " mismatches in " << validationPairs << " Dijkstra comparisons" << std::endl;
+
+    // Throughput: point-to-point and vehicle -> all RSUs
+    const int benchQueries = 100000;
+    double sink = 0.0;
+    auto startP2P = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < benchQueries; ++i) sink += std::min(hierarchy.query(anyNode(gen), anyNode(gen)), 1e9);
+    auto endP2P = std::chrono::high_resolution_clock::now();
+    std::vector<double> distances;
+    auto startM2M = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < benchQueries; ++i) {
+        hierarchy.distancesToTargets(anyNode(gen), distances);
+        sink += std::min(distances[0], 1e9);
+    }
+    auto endM2M = std::chrono::high_resolution_clock::now();
+    double p2pSeconds = std::chrono::duration<double>(endP2P - startP2P).count();
+    double m2mSeconds = std::chrono::duration<double>(endM2M - startM2M).count();
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "Point-to-point: " << benchQueries / p2pSeconds << " queries/sec" << std::endl;
+    std::cout << "Vehicle->RSU (" << rsus.size() << " RSUs per search): "
+              << benchQueries * rsus.size() / m2mSeconds << " distance queries/sec (checksum " << sink << ")\n" << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(6);
+
+    std::vector<int> vehicleNodes(requests.size());
+    for (auto& node : vehicleNodes) node = anyNode(gen);
+
+    int T = 5; // Number of time slots
+    main_algorithm(T, requests, rsus, services, graph, hierarchy, vehicleNodes);
+
+    return 0;
+}
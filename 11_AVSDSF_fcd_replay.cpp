@@ -0,0 +1,451 @@
+/*
+AVSDSF - SUMO FCD mobility trace ingestion and replay
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+#include "avsdsf_model.h"
+
+// Binary trace format: FcdHeader, then per timestep a float time, a uint32
+// record count and that many FcdRecords, then the vehicle id table
+// (uint16 length + bytes per vehicle).
+const char FCD_MAGIC[4] = {'F', 'C', 'D', '1'};
+const double REQUEST_PROBABILITY_PER_STEP = 0.02; // Chance a vehicle issues a service request each step
+
+struct FcdHeader {
+    char magic[4];
+    uint32_t vehicleCount;
+    uint32_t stepCount;
+    uint32_t reserved;
+    uint64_t recordCount;
+};
+
+struct FcdRecord {
+    uint32_t vehicle; // Index into the vehicle id table
+    float x;
+    float y;
+    float speed;      // m/s
+};
+
+// Read `name="value"` from a line as a double; returns false if absent
+bool parseNumericAttribute(const char* line, const char* name, double& value) {
+    const char* at = std::strstr(line, name);
+    while (at != nullptr) {
+        size_t length = std::strlen(name);
+        if ((at == line || at[-1] == ' ') && at[length] == '=' && at[length + 1] == '"') {
+            value = std::strtod(at + length + 2, nullptr);
+            return true;
+        }
+        at = std::strstr(at + 1, name);
+    }
+    return false;
+}
+
+bool parseStringAttribute(const char* line, const char* name, std::string& value) {
+    const char* at = std::strstr(line, name);
+    while (at != nullptr) {
+        size_t length = std::strlen(name);
+        if ((at == line || at[-1] == ' ') && at[length] == '=' && at[length + 1] == '"') {
+            const char* start = at + length + 2;
+            const char* end = std::strchr(start, '"');
+            if (end == nullptr) return false;
+            value.assign(start, end);
+            return true;
+        }
+        at = std::strstr(at + 1, name);
+    }
+    return false;
+}
+
+// Streaming converter from a SUMO FCD export (XML, or the semicolon CSV
+// written by xml2csv.py) to the binary trace. Only one timestep is held in
+// memory at a time.
+class FcdConverter {
+private:
+    std::ofstream out;
+    FcdHeader header{};
+    std::unordered_map<std::string, uint32_t> vehicleIndex;
+    std::vector<std::string> vehicleIds;
+    std::vector<FcdRecord> step;
+    double stepTime = 0.0;
+    bool stepOpen = false;
+
+    uint32_t indexOf(const std::string& id) {
+        auto it = vehicleIndex.find(id);
+        if (it != vehicleIndex.end()) return it->second;
+        uint32_t index = static_cast<uint32_t>(vehicleIds.size());
+        vehicleIndex.emplace(id, index);
+        vehicleIds.push_back(id);
+        return index;
+    }
+
+    void flushStep() {
+        if (!stepOpen) return;
+        float time = static_cast<float>(stepTime);
+        uint32_t count = static_cast<uint32_t>(step.size());
+        out.write(reinterpret_cast<const char*>(&time), sizeof(time));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(step.data()), step.size() * sizeof(FcdRecord));
+        header.stepCount++;
+        header.recordCount += step.size();
+        step.clear();
+        stepOpen = false;
+    }
+
+    void beginStep(double time) {
+        flushStep();
+        stepTime = time;
+        stepOpen = true;
+    }
+
+    bool convertXml(std::ifstream& in) {
+        std::string line, id;
+        double value = 0.0, x = 0.0, y = 0.0, speed = 0.0;
+        while (std::getline(in, line)) {
+            const char* text = line.c_str();
+            if (std::strstr(text, "<timestep") != nullptr) {
+                if (parseNumericAttribute(text, "time", value)) beginStep(value);
+            } else if (std::strstr(text, "<vehicle") != nullptr && stepOpen) {
+                if (parseStringAttribute(text, "id", id) && parseNumericAttribute(text, "x", x) &&
+                    parseNumericAttribute(text, "y", y) && parseNumericAttribute(text, "speed", speed)) {
+                    step.push_back({indexOf(id), static_cast<float>(x), static_cast<float>(y), static_cast<float>(speed)});
+                }
+            }
+        }
+        return true;
+    }
+
+    bool convertCsv(std::ifstream& in) {
+        std::string line;
+        if (!std::getline(in, line)) return false;
+        // Locate the needed columns in the header
+        std::vector<std::string> columns;
+        size_t start = 0;
+        while (start <= line.size()) {
+            size_t end = line.find(';', start);
+            if (end == std::string::npos) end = line.size();
+            columns.push_back(line.substr(start, end - start));
+            start = end + 1;
+        }
+        auto column = [&](const std::string& name) {
+            auto it = std::find(columns.begin(), columns.end(), name);
+            return it == columns.end() ? -1 : static_cast<int>(it - columns.begin());
+        };
+        int timeColumn = column("timestep_time"), idColumn = column("vehicle_id");
+        int xColumn = column("vehicle_x"), yColumn = column("vehicle_y"), speedColumn = column("vehicle_speed");
+        if (timeColumn < 0 || idColumn < 0 || xColumn < 0 || yColumn < 0 || speedColumn < 0) return false;
+
+        std::vector<std::string> fields;
+        while (std::getline(in, line)) {
+            fields.clear();
+            start = 0;
+            while (start <= line.size()) {
+                size_t end = line.find(';', start);
+                if (end == std::string::npos) end = line.size();
+                fields.push_back(line.substr(start, end - start));
+                start = end + 1;
+            }
+            if (fields.size() < columns.size() || fields[idColumn].empty()) continue; // Empty timestep rows
+            double time = std::strtod(fields[timeColumn].c_str(), nullptr);
+            if (!stepOpen || time != stepTime) beginStep(time);
+            step.push_back({indexOf(fields[idColumn]), std::strtof(fields[xColumn].c_str(), nullptr),
+                            std::strtof(fields[yColumn].c_str(), nullptr), std::strtof(fields[speedColumn].c_str(), nullptr)});
+        }
+        return true;
+    }
+
+public:
+    // Convert `inputPath` into `outputPath`; returns false on unreadable input.
+    // The trace is written to a temporary file that replaces `outputPath` only
+    // once complete, so an interrupted conversion is never replayed.
+    bool convert(const std::string& inputPath, const std::string& outputPath) {
+        std::ifstream in(inputPath);
+        if (!in) return false;
+        std::string partialPath = outputPath + ".partial";
+        out.open(partialPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        std::memcpy(header.magic, FCD_MAGIC, sizeof(FCD_MAGIC));
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header)); // Rewritten at the end
+
+        bool isCsv = inputPath.size() > 4 && inputPath.compare(inputPath.size() - 4, 4, ".csv") == 0;
+        bool ok = isCsv ? convertCsv(in) : convertXml(in);
+        flushStep();
+
+        // Id table after the steps, then the final header
+        for (const auto& id : vehicleIds) {
+            uint16_t length = static_cast<uint16_t>(id.size());
+            out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.write(id.data(), length);
+        }
+        header.vehicleCount = static_cast<uint32_t>(vehicleIds.size());
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+
+        std::error_code error;
+        if (ok && out.good()) std::filesystem::rename(partialPath, outputPath, error);
+        else error = std::make_error_code(std::errc::io_error);
+        if (error) std::filesystem::remove(partialPath, error);
+        return !error;
+    }
+};
+
+// Replays a binary trace step by step from a single buffered read
+class FcdReplay {
+private:
+    std::vector<char> buffer;
+    FcdHeader header{};
+    size_t cursor = 0;
+    size_t stepsEnd = 0;
+
+public:
+    // Load and validate a trace; returns false if it is unreadable, truncated
+    // or inconsistent with its header
+    bool open(const std::string& path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        std::streamsize size = in.tellg();
+        if (size < static_cast<std::streamsize>(sizeof(FcdHeader))) return false;
+        buffer.resize(size);
+        in.seekg(0);
+        if (!in.read(buffer.data(), size)) return false;
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        if (std::memcmp(header.magic, FCD_MAGIC, sizeof(FCD_MAGIC)) != 0) return false;
+        cursor = sizeof(FcdHeader);
+
+        // Walk the step headers to locate the end of the step data, checking
+        // every step and vehicle index against the buffer and the id table
+        const size_t stepHeader = sizeof(float) + sizeof(uint32_t);
+        size_t position = cursor;
+        uint64_t records = 0;
+        for (uint32_t s = 0; s < header.stepCount; ++s) {
+            if (buffer.size() - position < stepHeader) return false;
+            uint32_t count;
+            std::memcpy(&count, buffer.data() + position + sizeof(float), sizeof(count));
+            position += stepHeader;
+            if ((buffer.size() - position) / sizeof(FcdRecord) < count) return false;
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t vehicle;
+                std::memcpy(&vehicle, buffer.data() + position + i * sizeof(FcdRecord), sizeof(vehicle));
+                if (vehicle >= header.vehicleCount) return false;
+            }
+            position += count * sizeof(FcdRecord);
+            records += count;
+        }
+        if (records != header.recordCount) return false;
+        stepsEnd = position;
+
+        // The id table must hold exactly vehicleCount names
+        for (uint32_t v = 0; v < header.vehicleCount; ++v) {
+            if (buffer.size() - position < sizeof(uint16_t)) return false;
+            uint16_t length;
+            std::memcpy(&length, buffer.data() + position, sizeof(length));
+            position += sizeof(length);
+            if (buffer.size() - position < length) return false;
+            position += length;
+        }
+        return position == buffer.size();
+    }
+
+    const FcdHeader& getHeader() const { return header; }
+
+    void rewind() { cursor = sizeof(FcdHeader); }
+
+    // Next timestep; records point into the replay buffer
+    bool next(float& time, const FcdRecord*& records, uint32_t& count) {
+        if (cursor >= stepsEnd) return false;
+        std::memcpy(&time, buffer.data() + cursor, sizeof(time));
+        std::memcpy(&count, buffer.data() + cursor + sizeof(float), sizeof(count));
+        records = reinterpret_cast<const FcdRecord*>(buffer.data() + cursor + sizeof(float) + sizeof(uint32_t));
+        cursor += sizeof(float) + sizeof(uint32_t) + count * sizeof(FcdRecord);
+        return true;
+    }
+};
+
+// Write a synthetic SUMO FCD XML export: vehicles driving straight segments
+// across a grid city at 30-80 km/h, entering and leaving over time.
+void writeSyntheticFcd(const std::string& path, int vehicles, int steps, double citySize, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> coord(0.0, citySize);
+    std::uniform_real_distribution<> speedKmh(30.0, 80.0);
+    std::uniform_int_distribution<int> axis(0, 3);
+    std::uniform_int_distribution<int> depart(0, steps / 2);
+
+    struct SyntheticVehicle {
+        double x, y, dx, dy, speed;
+        int departStep;
+    };
+    std::vector<SyntheticVehicle> fleet;
+    for (int v = 0; v < vehicles; ++v) {
+        int direction = axis(gen);
+        double dx = direction == 0 ? 1 : direction == 1 ? -1 : 0;
+        double dy = direction == 2 ? 1 : direction == 3 ? -1 : 0;
+        fleet.push_back({coord(gen), coord(gen), dx, dy, speedKmh(gen) / 3.6, depart(gen)});
+    }
+
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr) return;
+    std::fprintf(out, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<fcd-export>\n");
+    for (int s = 0; s < steps; ++s) {
+        std::fprintf(out, "    <timestep time=\"%.2f\">\n", static_cast<double>(s));
+        for (int v = 0; v < vehicles; ++v) {
+            auto& vehicle = fleet[v];
+            if (s < vehicle.departStep) continue;
+            if (vehicle.x < 0 || vehicle.y < 0 || vehicle.x > citySize || vehicle.y > citySize) continue; // Left the map
+            std::fprintf(out, "        <vehicle id=\"veh%d\" x=\"%.2f\" y=\"%.2f\" angle=\"0.00\" type=\"DEFAULT_VEHTYPE\" "
+                              "speed=\"%.2f\" pos=\"0.00\" lane=\"e0_0\" slope=\"0.00\"/>\n",
+                         v, vehicle.x, vehicle.y, vehicle.speed);
+            vehicle.x += vehicle.dx * vehicle.speed;
+            vehicle.y += vehicle.dy * vehicle.speed;
+        }
+        std::fprintf(out, "    </timestep>\n");
+    }
+    std::fprintf(out, "</fcd-export>\n");
+    std::fclose(out);
+}
+
+// Replay the trace: associate vehicles with RSUs and generate service requests
+void main_algorithm(FcdReplay& replay, std::vector<RSU>& rsus, const std::vector<RSULocation>& locations, const RSUGridIndex& index) {
+    std::mt19937 gen(21);
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    std::uniform_real_distribution<> deadline(2.0, 5.0);
+    std::uniform_real_distribution<> load(1.0, 4.0);
+
+    uint32_t vehicleCount = replay.getHeader().vehicleCount;
+    std::vector<int> associatedRSU(vehicleCount, -1);
+    std::vector<float> lastX(vehicleCount, 0.0f), lastY(vehicleCount, 0.0f);
+    std::vector<bool> seen(vehicleCount, false);
+
+    // Success rate per 10 km/h speed bucket over the notebook's 30-80 km/h
+    // evaluation range, plus one bucket below and one above it
+    const int buckets = 7;
+    std::vector<long long> requestsPerBucket(buckets, 0), successPerBucket(buckets, 0);
+    long long vehicleSteps = 0, handovers = 0, requestId = 0;
+
+    float time;
+    const FcdRecord* records;
+    uint32_t count;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (replay.next(time, records, count)) {
+        for (auto& rsu : rsus) rsu.usedCapacity = 0.0; // Per-step compute budget
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const FcdRecord& record = records[i];
+            int rsuId = index.coveringRSU(record.x, record.y);
+            if (rsuId != associatedRSU[record.vehicle] && associatedRSU[record.vehicle] != -1) handovers++;
+
+            // Heading from the previous step, used to predict coverage dwell time
+            double dx = seen[record.vehicle] ? record.x - lastX[record.vehicle] : 0.0;
+            double dy = seen[record.vehicle] ? record.y - lastY[record.vehicle] : 0.0;
+            associatedRSU[record.vehicle] = rsuId;
+            lastX[record.vehicle] = record.x;
+            lastY[record.vehicle] = record.y;
+            seen[record.vehicle] = true;
+            vehicleSteps++;
+
+            if (unit(gen) >= REQUEST_PROBABILITY_PER_STEP) continue;
+            double speedKmh = record.speed * 3.6;
+            int bucket = speedKmh < 30.0 ? 0 : std::min(1 + static_cast<int>((speedKmh - 30.0) / 10.0), buckets - 1);
+            requestsPerBucket[bucket]++;
+            if (rsuId == -1) continue;
+
+            const RSULocation& location = locations[rsuId];
+            ServiceRequest request{static_cast<int>(requestId++), deadline(gen), load(gen), 0.02, 0.02, 0.0,
+                                   std::hypot(location.x - record.x, location.y - record.y)};
+
+            // Remaining distance inside the coverage disc along the current heading
+            double norm = std::hypot(dx, dy);
+            double dwellSeconds = std::numeric_limits<double>::infinity();
+            if (norm > 0.0 && record.speed > 0.0f) {
+                double ux = dx / norm, uy = dy / norm;
+                double px = record.x - location.x, py = record.y - location.y;
+                double b = px * ux + py * uy;
+                double c = px * px + py * py - location.coverageRadius * location.coverageRadius;
+                double exitDistance = -b + std::sqrt(std::max(0.0, b * b - c));
+                dwellSeconds = exitDistance / record.speed;
+            }
+
+            RSU& rsu = rsus[rsuId];
+            if (dwellSeconds >= request.deadline && rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                rsu.usedCapacity += request.computationLoad;
+                successPerBucket[bucket]++;
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (int b = 0; b < buckets; ++b) {
+        double rate = requestsPerBucket[b] ? 100.0 * successPerBucket[b] / requestsPerBucket[b] : 0.0;
+        std::string range = b == 0 ? "0-30" : b == buckets - 1 ? "80+" : std::to_string(20 + 10 * b) + "-" + std::to_string(30 + 10 * b);
+        std::cout << "Speed " << range << " km/h: Requests = " << requestsPerBucket[b] << ", Success Rate = " << rate << "%"
+                  << std::endl;
+    }
+    std::cout << "Vehicle-steps = " << vehicleSteps << ", Handovers = " << handovers << ", Replay Throughput = "
+              << vehicleSteps / seconds / 1e6 << " M vehicle-steps/sec" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    const double citySize = 5000.0;
+
+    // Input: a SUMO FCD export given on the command line, or a synthetic one
+    std::string input;
+    if (argc > 1) {
+        input = argv[1];
+    } else {
+        input = (fs::temp_directory_path() / "avsdsf_synthetic_fcd.xml").string();
+        if (!fs::exists(input)) {
+            writeSyntheticFcd(input, 3000, 600, citySize, 17);
+        }
+    }
+    std::string binary = input + ".fcdb";
+
+    // Convert once; later runs replay the binary trace directly
+    if (!fs::exists(binary) || fs::last_write_time(binary) < fs::last_write_time(input)) {
+        auto start = std::chrono::high_resolution_clock::now();
+        FcdConverter converter;
+        if (!converter.convert(input, binary)) {
+            std::cerr << "Could not convert FCD trace " << input << std::endl;
+            return 1;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Converted " << input << " (" << fs::file_size(input) / (1024 * 1024) << " MiB) to "
+                  << binary << " (" << fs::file_size(binary) / (1024 * 1024) << " MiB) in "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    }
+
+    FcdReplay replay;
+    if (!replay.open(binary)) {
+        std::cerr << "Could not read binary trace " << binary << std::endl;
+        return 1;
+    }
+    std::cout << "Trace: " << replay.getHeader().vehicleCount << " vehicles, " << replay.getHeader().stepCount
+              << " steps, " << replay.getHeader().recordCount << " records" << std::endl;
+
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(100, 0, 3, 5, rsus, requests, services);
+    for (auto& rsu : rsus) rsu.maxCapacity = 40.0;
+    std::vector<RSULocation> locations = generateRSUGrid(rsus, citySize / 10.0, 300.0);
+    RSUGridIndex index(locations, citySize / 10.0, citySize, citySize);
+
+    main_algorithm(replay, rsus, locations, index);
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+AVSDSF - Power-of-d-choices sampled placement for RS-MAS
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include "avsdsf_model.h"
+#include "avsdsf_perf.h"
+
+const int NEIGHBOR_LIST_SIZE = 32; // Nearest RSUs kept per RSU for locality-aware sampling
+const int SAMPLE_RETRIES = 3;      // Fresh samples drawn when no sampled RSU has capacity
+
+enum class PlacementMode {
+    Exact,          // Full argmin over all RSUs
+    Random,         // d uniformly random candidates
+    NearestRandom   // d nearest to the vehicle's RSU plus d random
+};
+
+// Small, fast generator for candidate sampling (splitmix64)
+struct SampleRng {
+    uint64_t state;
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    // Uniform integer in [0, bound) without division
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(static_cast<uint32_t>(next())) * bound) >> 32);
+    }
+};
+
+struct PlacementResult {
+    double totalCost = 0.0;
+    long long placed = 0;
+    long long fallbacks = 0; // Requests that needed the exact scan after sampling failed
+    long long dropped = 0;
+    double seconds = 0.0;
+    CounterSample counters; // Hardware counters over the placement loop (AVSDSF_PERF)
+};
+
+// Nearest RSUs of every RSU (by location), closest first, excluding itself
+std::vector<std::vector<int>> buildNeighborLists(const std::vector<RSULocation>& locations, int size) {
+    std::vector<std::vector<int>> neighbors(locations.size());
+    std::vector<std::pair<double, int>> order;
+    for (size_t i = 0; i < locations.size(); ++i) {
+        order.clear();
+        for (size_t j = 0; j < locations.size(); ++j) {
+            if (i == j) continue;
+            order.push_back({std::hypot(locations[i].x - locations[j].x, locations[i].y - locations[j].y), static_cast<int>(j)});
+        }
+        size_t keep = std::min(order.size(), static_cast<size_t>(size));
+        std::partial_sort(order.begin(), order.begin() + keep, order.end());
+        for (size_t k = 0; k < keep; ++k) neighbors[i].push_back(order[k].second);
+    }
+    return neighbors;
+}
+
+// Exact argmin over all RSUs (the loop in 6_AVSDSF_final.cpp)
+int exactPlacement(const ServiceRequest& request, const std::vector<RSU>& rsus, const std::vector<double>& weights, double& bestCost) {
+    bestCost = std::numeric_limits<double>::max();
+    int bestRSU = -1;
+    for (const auto& rsu : rsus) {
+        if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+            double cost = computePlacementCost(request, rsu, weights);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestRSU = rsu.id;
+            }
+        }
+    }
+    return bestRSU;
+}
+
+// Evaluate one candidate with the same weighted cost as the exact scan
+inline void considerCandidate(const ServiceRequest& request, const RSU& rsu, const std::vector<double>& weights,
+                              double& bestCost, int& bestRSU) {
+    if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+        double cost = computePlacementCost(request, rsu, weights);
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestRSU = rsu.id;
+        }
+    }
+}
+
+// Sampled placement: best of d candidates, retried a few times, exact scan as last resort
+int sampledPlacement(const ServiceRequest& request, int homeRSU, const std::vector<RSU>& rsus, const std::vector<double>& weights,
+                     const std::vector<std::vector<int>>& neighbors, PlacementMode mode, int d, SampleRng& rng,
+                     double& bestCost, bool& usedFallback) {
+    uint32_t numRSUs = static_cast<uint32_t>(rsus.size());
+    usedFallback = false;
+    for (int attempt = 0; attempt < SAMPLE_RETRIES; ++attempt) {
+        bestCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        if (mode == PlacementMode::NearestRandom && attempt == 0) {
+            considerCandidate(request, rsus[homeRSU], weights, bestCost, bestRSU);
+            const auto& near = neighbors[homeRSU];
+            for (int k = 0; k < d - 1 && k < static_cast<int>(near.size()); ++k) {
+                considerCandidate(request, rsus[near[k]], weights, bestCost, bestRSU);
+            }
+        }
+        for (int k = 0; k < d; ++k) {
+            considerCandidate(request, rsus[rng.below(numRSUs)], weights, bestCost, bestRSU);
+        }
+        if (bestRSU != -1) return bestRSU;
+    }
+    usedFallback = true;
+    return exactPlacement(request, rsus, weights, bestCost);
+}
+
+// Place every request once with the given mode on a fresh copy of the RSU state
+PlacementResult runPlacement(const std::vector<ServiceRequest>& requests, const std::vector<int>& homeRSUs, std::vector<RSU> rsus,
+                             const std::vector<std::vector<int>>& neighbors, PlacementMode mode, int d, uint64_t seed) {
+    PlacementResult result;
+    SampleRng rng{seed};
+    std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+
+    bool counting = PerfCounters::requested();
+    CounterSample countersStart;
+    if (counting) countersStart = PerfCounters::forThread().read();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < requests.size(); ++r) {
+        const auto& request = requests[r];
+        double cost = 0.0;
+        bool usedFallback = false;
+        int bestRSU = mode == PlacementMode::Exact
+            ? exactPlacement(request, rsus, weights, cost)
+            : sampledPlacement(request, homeRSUs[r], rsus, weights, neighbors, mode, d, rng, cost, usedFallback);
+        if (usedFallback) result.fallbacks++;
+        if (bestRSU != -1) {
+            rsus[bestRSU].usedCapacity += request.computationLoad;
+            result.totalCost += cost;
+            result.placed++;
+        } else {
+            result.dropped++;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    if (counting) result.counters = PerfCounters::forThread().read() - countersStart;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    // Optional arguments: d (candidates per request) and number of requests
+    int d = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2;
+    int numRequests = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200000;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Requests per run = " << numRequests << ", configured d = " << d << "\n" << std::endl;
+    bool counters = PerfCounters::requested() && PerfCounters::forThread().ok();
+    if (PerfCounters::requested() && !counters) {
+        std::cout << "Hardware counters unavailable (" << PerfCounters::forThread().unavailableReason << "); wall-clock only\n" << std::endl;
+    }
+
+    for (int numRSUs : {100, 1000, 10000}) {
+        std::vector<RSU> rsus;
+        std::vector<ServiceRequest> requests;
+        std::vector<PrefetchedService> services;
+        generateScenario(numRSUs, numRequests, 3, 42, rsus, requests, services, 1.3);
+
+        std::vector<RSULocation> locations = generateRSUGrid(rsus, 500.0, 300.0);
+        std::vector<std::vector<int>> neighbors = buildNeighborLists(locations, NEIGHBOR_LIST_SIZE);
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<int> anyRSU(0, numRSUs - 1);
+        std::vector<int> homeRSUs(requests.size());
+        for (auto& home : homeRSUs) home = anyRSU(gen);
+
+        PlacementResult exact = runPlacement(requests, homeRSUs, rsus, neighbors, PlacementMode::Exact, 0, 7);
+        std::cout << "RSUs = " << numRSUs << ": Exact argmin: " << exact.placed / exact.seconds / 1e6
+                  << " M placements/sec, Total Cost = " << exact.totalCost << ", Dropped = " << exact.dropped << std::endl;
+        if (counters) std::cout << "    " << describeCounters(exact.counters, exact.placed + exact.dropped) << std::endl;
+
+        std::vector<int> choices = {1, 2, 4, 8};
+        if (std::find(choices.begin(), choices.end(), d) == choices.end()) choices.push_back(d);
+        for (PlacementMode mode : {PlacementMode::Random, PlacementMode::NearestRandom}) {
+            for (int choice : choices) {
+                PlacementResult sampled = runPlacement(requests, homeRSUs, rsus, neighbors, mode, choice, 7);
+                double costRatio = sampled.totalCost / exact.totalCost * exact.placed / std::max(1LL, sampled.placed);
+                std::cout << "  " << (mode == PlacementMode::Random ? "d random" : "d nearest + d random")
+                          << ", d = " << choice << (choice == d ? " *" : "") << ": "
+                          << sampled.placed / sampled.seconds / 1e6 << " M placements/sec ("
+                          << exact.seconds / sampled.seconds << "x), Mean Cost vs Exact = " << costRatio
+                          << ", Fallbacks = " << sampled.fallbacks << ", Dropped = " << sampled.dropped << std::endl;
+                if (counters) std::cout << "    " << describeCounters(sampled.counters, sampled.placed + sampled.dropped) << std::endl;
+            }
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
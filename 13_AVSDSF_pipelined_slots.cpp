@@ -0,0 +1,425 @@
+/*
+AVSDSF - Pipelined slot execution (prefetch planning and accounting overlap scheduling)
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "avsdsf_model.h"
+#include "avsdsf_trace.h"
+#include "avsdsf_perf.h"
+
+const double PREFETCH_HIT_FACTOR = 0.2;  // Preparation cost left when the image is prefetched on the RSU
+const double FORECAST_SMOOTHING = 0.5;   // EWMA weight of the newest slot in the demand forecast
+const double IMAGE_CAPACITY_SHARE = 0.3; // Fraction of RSU capacity usable for prefetched images
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Prefetch plan for one slot: prefetched[rsu * numServices + service]
+struct PrefetchPlan {
+    int slot;
+    std::vector<char> prefetched;
+};
+
+// Immutable RSU state and decisions published at the end of a slot
+struct SlotSnapshot {
+    int version; // Slot that produced it
+    std::vector<RSU> rsus;
+    std::vector<int> X; // Request -> RSU (-1 if not scheduled)
+    std::vector<int> T; // Request -> transfer RSU (-1 if none)
+    std::shared_ptr<const PrefetchPlan> plan;
+};
+
+// Versioned snapshot store: each version is handed to a fixed number of
+// consumers and dropped once all of them have taken it.
+class SnapshotStore {
+private:
+    std::mutex mutex;
+    std::condition_variable published;
+    std::map<int, std::pair<std::shared_ptr<const SlotSnapshot>, int>> versions;
+    int consumers;
+
+public:
+    explicit SnapshotStore(int numConsumers) : consumers(numConsumers) {}
+
+    void publish(std::shared_ptr<const SlotSnapshot> snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            int version = snapshot->version;
+            versions[version] = {std::move(snapshot), consumers};
+        }
+        published.notify_all();
+    }
+
+    std::shared_ptr<const SlotSnapshot> acquire(int version) {
+        std::unique_lock<std::mutex> lock(mutex);
+        published.wait(lock, [&] { return versions.count(version) != 0; });
+        auto& entry = versions[version];
+        std::shared_ptr<const SlotSnapshot> snapshot = entry.first;
+        if (--entry.second == 0) versions.erase(version);
+        return snapshot;
+    }
+};
+
+// Single-slot handoff of prefetch plans from the planner to the scheduler
+class PlanChannel {
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::map<int, std::shared_ptr<const PrefetchPlan>> plans;
+
+public:
+    void put(std::shared_ptr<const PrefetchPlan> plan) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            int slot = plan->slot;
+            plans[slot] = std::move(plan);
+        }
+        ready.notify_all();
+    }
+
+    std::shared_ptr<const PrefetchPlan> take(int slot) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&] { return plans.count(slot) != 0; });
+        auto plan = plans[slot];
+        plans.erase(slot);
+        return plan;
+    }
+};
+
+// Workload shared by both executors
+struct Workload {
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    std::vector<int> requestService;
+};
+
+struct SlotResult {
+    double totalCost = 0.0;
+    double totalLatency = 0.0;
+    int scheduled = 0;
+};
+
+struct StageTimes {
+    double schedule = 0.0;
+    double plan = 0.0;
+    double accounting = 0.0;
+    double wall = 0.0;
+};
+
+// Demand forecast per (RSU, service), folded from completed slots
+class DemandForecast {
+private:
+    int numServices;
+    std::vector<double> demand;
+    std::vector<double> observed;
+
+public:
+    DemandForecast(int numRSUs, int services) : numServices(services), demand(numRSUs * services, 0.0), observed(numRSUs * services) {}
+
+    void fold(const SlotSnapshot& snapshot, const std::vector<int>& requestService) {
+        std::fill(observed.begin(), observed.end(), 0.0);
+        for (size_t r = 0; r < snapshot.X.size(); ++r) {
+            if (snapshot.X[r] >= 0) observed[snapshot.X[r] * numServices + requestService[r]] += 1.0;
+        }
+        for (size_t i = 0; i < demand.size(); ++i) {
+            demand[i] = FORECAST_SMOOTHING * observed[i] + (1.0 - FORECAST_SMOOTHING) * demand[i];
+        }
+    }
+
+    // Greedy per-RSU plan: services with the highest forecast demand per unit size while they fit
+    std::shared_ptr<PrefetchPlan> plan(int slot, const std::vector<RSU>& rsus, const std::vector<PrefetchedService>& services) const {
+        auto result = std::make_shared<PrefetchPlan>();
+        result->slot = slot;
+        result->prefetched.assign(rsus.size() * numServices, 0);
+        std::vector<std::pair<double, int>> ranking(numServices);
+        for (size_t r = 0; r < rsus.size(); ++r) {
+            for (int s = 0; s < numServices; ++s) {
+                ranking[s] = {demand[r * numServices + s] / services[s].size, s};
+            }
+            std::sort(ranking.rbegin(), ranking.rend());
+            double remainingCapacity = rsus[r].maxCapacity * IMAGE_CAPACITY_SHARE;
+            for (const auto& [score, s] : ranking) {
+                if (score <= 0.0) break;
+                if (services[s].size <= remainingCapacity) {
+                    result->prefetched[r * numServices + s] = 1;
+                    remainingCapacity -= services[s].size;
+                }
+            }
+        }
+        return result;
+    }
+};
+
+// Scheduler stage for one slot: parameter update, weights, plan application, schedule and transfer
+std::shared_ptr<SlotSnapshot> scheduleSlot(int t, Workload& w, const std::shared_ptr<const PrefetchPlan>& plan, std::mt19937& gen) {
+    TracePhase phase("schedule");
+    std::uniform_real_distribution<> dis(0.9, 1.1); // Stationary variation so load stays comparable across slots
+    int numServices = static_cast<int>(w.services.size());
+    for (auto& request : w.requests) {
+        double y = dis(gen);
+        request.computationLoad = std::clamp(request.computationLoad * y, 5.0, 40.0);
+        request.transferCost = std::clamp(request.transferCost * y, 0.005, 0.05);
+    }
+    for (auto& rsu : w.rsus) {
+        rsu.computationCost = std::clamp(rsu.computationCost * dis(gen), 0.005, 0.08);
+        rsu.retentionCost = std::clamp(rsu.retentionCost * dis(gen), 0.005, 0.08);
+        rsu.usedCapacity = 0.0;
+    }
+
+    // Prefetched images occupy capacity
+    for (size_t r = 0; r < w.rsus.size(); ++r) {
+        for (int s = 0; s < numServices; ++s) {
+            if (plan->prefetched[r * numServices + s]) w.rsus[r].usedCapacity += w.services[s].size;
+        }
+    }
+    std::vector<double> weights = computeDynamicWeights(computeSystemLoad(w.rsus));
+
+    auto snapshot = std::make_shared<SlotSnapshot>();
+    snapshot->version = t;
+    snapshot->plan = plan;
+    snapshot->X.assign(w.requests.size(), -1);
+    snapshot->T.assign(w.requests.size(), -1);
+
+    for (size_t i = 0; i < w.requests.size(); ++i) {
+        const auto& request = w.requests[i];
+        double minCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : w.rsus) {
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                double preparation = plan->prefetched[rsu.id * numServices + w.requestService[i]]
+                    ? request.preparationCost * PREFETCH_HIT_FACTOR : request.preparationCost;
+                double cost = computePlacementCost(request, rsu, weights) - weights[3] * (request.preparationCost - preparation);
+                if (cost < minCost) {
+                    minCost = cost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            snapshot->X[i] = bestRSU;
+            w.rsus[bestRSU].usedCapacity += request.computationLoad;
+        }
+    }
+
+    TracePhase transfer("transfer");
+    for (size_t i = 0; i < w.requests.size(); ++i) {
+        const auto& request = w.requests[i];
+        double minTransferCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : w.rsus) {
+            if (rsu.usedCapacity + request.demand <= rsu.maxCapacity) {
+                double transferCost = request.distanceToRSU + TRANSFER_COST_MULTIPLIER * rsu.usedCapacity / rsu.maxCapacity;
+                if (transferCost < minTransferCost) {
+                    minTransferCost = transferCost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            snapshot->T[i] = bestRSU;
+            w.rsus[bestRSU].usedCapacity += request.demand;
+        }
+    }
+
+    snapshot->rsus = w.rsus;
+    return snapshot;
+}
+
+// Accounting stage: cost and latency of a completed slot
+SlotResult accountSlot(const SlotSnapshot& snapshot, const std::vector<ServiceRequest>& requests, const Workload& w) {
+    TracePhase phase("cost");
+    SlotResult result;
+    int numServices = static_cast<int>(w.services.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (snapshot.X[i] < 0) continue;
+        const auto& request = requests[i];
+        const auto& rsu = snapshot.rsus[snapshot.X[i]];
+        double preparation = snapshot.plan->prefetched[rsu.id * numServices + w.requestService[i]]
+            ? request.preparationCost * PREFETCH_HIT_FACTOR : request.preparationCost;
+        result.totalCost += rsu.computationCost * request.computationLoad + rsu.retentionCost + request.transferCost + preparation;
+        result.totalLatency += request.computationLoad * rsu.computationCost + request.transferCost;
+        result.scheduled++;
+    }
+    for (size_t r = 0; r < snapshot.rsus.size(); ++r) {
+        for (int s = 0; s < numServices; ++s) {
+            if (snapshot.plan->prefetched[r * numServices + s]) result.totalCost += PREFETCH_COST_MULTIPLIER * w.services[s].prefetchCost;
+        }
+    }
+    return result;
+}
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Sequential executor: every stage of slot t runs after the previous one.
+// The plan for slot t uses the forecast folded through slot t-2, the same
+// information the pipelined planner has while slot t-1 is still scheduling.
+std::vector<SlotResult> runSequential(int T, Workload w, StageTimes& times, PhaseCounters& counters) {
+    std::mt19937 gen(3);
+    DemandForecast forecast(static_cast<int>(w.rsus.size()), static_cast<int>(w.services.size()));
+    std::vector<std::shared_ptr<const SlotSnapshot>> history;
+    std::vector<SlotResult> results;
+    long long decisions = static_cast<long long>(w.requests.size());
+    auto wallStart = Clock::now();
+    for (int t = 0; t < T; ++t) {
+        std::shared_ptr<const PrefetchPlan> plan;
+        auto start = Clock::now();
+        {
+            PhaseCounters::Scope counted(counters, "plan", "sequential", decisions);
+            traceBegin("prefetch");
+            if (t >= 2) forecast.fold(*history[t - 2], w.requestService);
+            plan = forecast.plan(t, w.rsus, w.services);
+            traceEnd();
+        }
+        times.plan += elapsedMs(start);
+
+        start = Clock::now();
+        {
+            PhaseCounters::Scope counted(counters, "schedule", "sequential", decisions);
+            history.push_back(scheduleSlot(t, w, plan, gen));
+        }
+        times.schedule += elapsedMs(start);
+
+        start = Clock::now();
+        {
+            PhaseCounters::Scope counted(counters, "accounting", "sequential", decisions);
+            results.push_back(accountSlot(*history.back(), w.requests, w));
+        }
+        times.accounting += elapsedMs(start);
+    }
+    times.wall = elapsedMs(wallStart);
+    return results;
+}
+
+// Pipelined executor: the planner thread builds the plan for slot t+1 while
+// slot t schedules, and the accounting thread drains slot t-1 asynchronously.
+// Stages hand off through versioned, immutable snapshots.
+std::vector<SlotResult> runPipelined(int T, Workload w, StageTimes& times, PhaseCounters& counters) {
+    SnapshotStore store(2); // Consumed by the planner and the accountant
+    PlanChannel plans;
+    std::vector<SlotResult> results(T);
+
+    // The scheduler owns `w`; the other stages read an unchanging copy plus
+    // the per-slot request parameters handed over with each snapshot
+    const Workload shared = w;
+    std::vector<std::vector<ServiceRequest>> requestVersions(T);
+    long long decisions = static_cast<long long>(w.requests.size());
+
+    std::thread planner([&] {
+        traceThreadName("planner");
+        DemandForecast forecast(static_cast<int>(shared.rsus.size()), static_cast<int>(shared.services.size()));
+        for (int t = 0; t < T; ++t) {
+            std::shared_ptr<const SlotSnapshot> previous;
+            if (t >= 2) {
+                TracePhase wait("wait for snapshot");
+                previous = store.acquire(t - 2);
+            }
+            auto start = Clock::now();
+            PhaseCounters::Scope counted(counters, "plan", "planner", decisions);
+            traceBegin("prefetch");
+            if (previous) forecast.fold(*previous, shared.requestService);
+            plans.put(forecast.plan(t, shared.rsus, shared.services)); // Capacities are static
+            traceEnd();
+            times.plan += elapsedMs(start);
+        }
+        // Release the snapshots nobody will fold
+        for (int t = std::max(0, T - 2); t < T; ++t) store.acquire(t);
+    });
+
+    std::thread accountant([&] {
+        traceThreadName("accountant");
+        for (int t = 0; t < T; ++t) {
+            traceBegin("wait for snapshot");
+            std::shared_ptr<const SlotSnapshot> snapshot = store.acquire(t);
+            traceEnd();
+            auto start = Clock::now();
+            PhaseCounters::Scope counted(counters, "accounting", "accountant", decisions);
+            results[t] = accountSlot(*snapshot, requestVersions[t], shared);
+            requestVersions[t].clear();
+            times.accounting += elapsedMs(start);
+        }
+    });
+
+    std::mt19937 gen(3);
+    auto wallStart = Clock::now();
+    for (int t = 0; t < T; ++t) {
+        traceBegin("wait for plan");
+        std::shared_ptr<const PrefetchPlan> plan = plans.take(t);
+        traceEnd();
+        auto start = Clock::now();
+        std::shared_ptr<SlotSnapshot> snapshot;
+        {
+            PhaseCounters::Scope counted(counters, "schedule", "scheduler", decisions);
+            snapshot = scheduleSlot(t, w, plan, gen);
+        }
+        requestVersions[t] = w.requests; // Written before publish, read after acquire
+        times.schedule += elapsedMs(start);
+        store.publish(std::move(snapshot));
+    }
+    planner.join();
+    accountant.join();
+    times.wall = elapsedMs(wallStart);
+    return results;
+}
+
+int main() {
+    const int numRSUs = 1500;
+    const int numRequests = 15000;
+    const int numServices = 400;
+    const int T = 10; // Number of time slots
+
+    Workload workload;
+    generateScenario(numRSUs, numRequests, numServices, 19, workload.rsus, workload.requests, workload.services, 2.0);
+    std::mt19937 gen(5);
+    std::vector<double> popularity;
+    for (int s = 0; s < numServices; ++s) popularity.push_back(1.0 / (s + 1));
+    std::discrete_distribution<int> serviceOf(popularity.begin(), popularity.end());
+    for (int r = 0; r < numRequests; ++r) workload.requestService.push_back(serviceOf(gen));
+
+    StageTimes sequentialTimes, pipelinedTimes;
+    PhaseCounters counters; // Filled only when AVSDSF_PERF is set
+    std::vector<SlotResult> sequential = runSequential(T, workload, sequentialTimes, counters);
+    std::vector<SlotResult> pipelined = runPipelined(T, workload, pipelinedTimes, counters);
+
+    bool identical = true;
+    for (int t = 0; t < T; ++t) {
+        std::cout << "Time Slot " << t << ": Total Cost = " << pipelined[t].totalCost
+                  << ", Total Latency = " << pipelined[t].totalLatency << " microseconds"
+                  << ", Scheduled = " << pipelined[t].scheduled << std::endl;
+        identical = identical && std::fabs(sequential[t].totalCost - pipelined[t].totalCost) < 1e-9 &&
+                    sequential[t].scheduled == pipelined[t].scheduled;
+    }
+
+    auto report = [&](const char* name, const StageTimes& times) {
+        double slowest = std::max({times.schedule, times.plan, times.accounting}) / T;
+        std::cout << name << ": Wall/slot = " << times.wall / T << " ms (schedule " << times.schedule / T
+                  << ", plan " << times.plan / T << ", accounting " << times.accounting / T
+                  << " ms; slowest stage " << slowest << " ms)" << std::endl;
+    };
+    std::cout << std::fixed << std::setprecision(3) << std::endl;
+    report("Sequential", sequentialTimes);
+    report("Pipelined ", pipelinedTimes);
+    std::cout << "Speedup = " << sequentialTimes.wall / pipelinedTimes.wall << "x, Results "
+              << (identical ? "identical" : "DIFFER") << " to the sequential executor" << std::endl;
+    // The bound is the slowest stage; it is only reachable with a core per stage
+    std::cout << "Hardware threads = " << std::thread::hardware_concurrency()
+              << ", pipelined bound = " << sequentialTimes.wall / T / (std::max({sequentialTimes.schedule, sequentialTimes.plan, sequentialTimes.accounting}) / T)
+              << "x" << std::endl;
+    if (PerfCounters::requested()) {
+        std::cout << "\nHardware counters per phase and thread:" << std::endl;
+        counters.report(std::cout);
+    }
+    return identical ? 0 : 1;
+}
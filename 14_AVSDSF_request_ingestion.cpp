@@ -0,0 +1,290 @@
+/*
+AVSDSF - Lock-free MPSC request ingestion in front of the RS-MAS scheduler
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include "avsdsf_model.h"
+
+const size_t RING_CAPACITY = 4096;       // Slots in the ingestion ring (power of two)
+const size_t DRAIN_BATCH = 256;          // Requests taken per drain call in continuous mode
+const int REQUESTS_PER_RUN = 400000;     // Requests submitted per benchmark run, split over producers
+const int NUM_RSUS = 64;                 // RSUs considered by the scheduler
+const double SLOT_MS = 2.0;              // Slot length; RSU capacity is released at each boundary
+
+using Clock = std::chrono::steady_clock;
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// Request as submitted by a vehicle gateway
+struct Submission {
+    ServiceRequest request;
+    int gateway;
+    int64_t submittedNs;
+};
+
+// Bounded lock-free multi-producer single-consumer ring. Every cell carries a
+// sequence number: a producer claims a position with a CAS on the tail and
+// publishes the cell by bumping its sequence; the single consumer reads cells
+// in order without any atomic read-modify-write. tryPush returns false when
+// the ring is full, which is the backpressure signal to the producer.
+template <typename T>
+class MPSCRing {
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::vector<Cell> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail{0}; // Next position to claim (producers)
+    alignas(64) std::atomic<size_t> head{0}; // Next position to read (written by the consumer only)
+
+public:
+    explicit MPSCRing(size_t capacity) : cells(capacity), mask(capacity - 1) {
+        for (size_t i = 0; i < capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool tryPush(const T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full: the consumer has not freed this cell yet
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pop up to maxItems published values in order; returns how many were taken
+    template <typename F>
+    size_t drain(size_t maxItems, F&& consume) {
+        size_t position = head.load(std::memory_order_relaxed);
+        size_t taken = 0;
+        while (taken < maxItems) {
+            Cell& cell = cells[position & mask];
+            if (cell.sequence.load(std::memory_order_acquire) != position + 1) break; // Empty or not yet published
+            consume(cell.value);
+            cell.sequence.store(position + mask + 1, std::memory_order_release);
+            ++position;
+            ++taken;
+        }
+        head.store(position, std::memory_order_relaxed);
+        return taken;
+    }
+
+    // Approximate occupancy, for producers that want to throttle before the ring is full
+    size_t approximateSize() const {
+        size_t claimed = tail.load(std::memory_order_relaxed);
+        size_t read = head.load(std::memory_order_relaxed);
+        return claimed > read ? claimed - read : 0;
+    }
+};
+
+// Mutex-protected bounded deque with the same interface, for comparison
+template <typename T>
+class LockedQueue {
+private:
+    std::mutex mutex;
+    std::deque<T> items;
+    size_t capacity;
+
+public:
+    explicit LockedQueue(size_t cap) : capacity(cap) {}
+
+    bool tryPush(const T& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.size() >= capacity) return false;
+        items.push_back(value);
+        return true;
+    }
+
+    template <typename F>
+    size_t drain(size_t maxItems, F&& consume) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t taken = 0;
+        while (taken < maxItems && !items.empty()) {
+            consume(items.front());
+            items.pop_front();
+            ++taken;
+        }
+        return taken;
+    }
+};
+
+// RS-MAS placement of drained requests; capacity is released at slot boundaries
+class IngestingScheduler {
+private:
+    std::vector<RSU> rsus;
+    std::vector<double> weights;
+
+public:
+    long long scheduled = 0;
+    long long rejected = 0;
+    double totalCost = 0.0;
+
+    explicit IngestingScheduler(const std::vector<RSU>& initial) : rsus(initial) { startSlot(); }
+
+    // Weights follow the load the previous slot left behind, then its capacity is released
+    void startSlot() {
+        weights = computeDynamicWeights(computeSystemLoad(rsus));
+        for (auto& rsu : rsus) rsu.usedCapacity = 0.0;
+    }
+
+    void schedule(const ServiceRequest& request) {
+        double minCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                double cost = computePlacementCost(request, rsu, weights);
+                if (cost < minCost) {
+                    minCost = cost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            rsus[bestRSU].usedCapacity += request.computationLoad;
+            totalCost += minCost;
+            scheduled++;
+        } else {
+            rejected++;
+        }
+    }
+};
+
+enum class DrainMode {
+    SlotBoundary, // Drain everything at each slot boundary
+    Continuous    // Drain in batches as soon as requests arrive
+};
+
+struct IngestionResult {
+    double seconds = 0.0;
+    long long backpressureEvents = 0; // Failed pushes (ring full)
+    long long drainCalls = 0;
+    long long scheduled = 0;
+    std::vector<double> latencyUs;    // Submit -> scheduled
+};
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Producers submit their share of `requests`, retrying with a yield whenever
+// the queue pushes back; the calling thread is the single consumer.
+template <typename Queue>
+IngestionResult runIngestion(int numProducers, DrainMode mode, const std::vector<ServiceRequest>& requests,
+                             const std::vector<RSU>& rsus) {
+    Queue queue(RING_CAPACITY);
+    IngestingScheduler scheduler(rsus);
+    IngestionResult result;
+    result.latencyUs.reserve(requests.size());
+    std::atomic<long long> backpressure{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            long long retries = 0;
+            for (size_t r = p; r < requests.size(); r += numProducers) {
+                Submission submission{requests[r], p, nowNs()};
+                while (!queue.tryPush(submission)) {
+                    ++retries;
+                    std::this_thread::yield();
+                }
+            }
+            backpressure.fetch_add(retries, std::memory_order_relaxed);
+        });
+    }
+
+    auto consume = [&](const Submission& submission) {
+        scheduler.schedule(submission.request);
+        result.latencyUs.push_back((nowNs() - submission.submittedNs) / 1000.0);
+    };
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    auto nextSlot = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(SLOT_MS));
+    long long consumed = 0;
+    while (consumed < static_cast<long long>(requests.size())) {
+        if (mode == DrainMode::SlotBoundary) {
+            std::this_thread::sleep_until(nextSlot);
+            size_t taken;
+            do {
+                taken = queue.drain(std::numeric_limits<size_t>::max(), consume);
+                consumed += taken;
+                result.drainCalls++;
+            } while (taken > 0 && consumed < static_cast<long long>(requests.size()));
+        } else {
+            size_t taken = queue.drain(DRAIN_BATCH, consume);
+            consumed += taken;
+            result.drainCalls++;
+            if (taken == 0) std::this_thread::yield();
+        }
+        if (Clock::now() >= nextSlot) {
+            scheduler.startSlot();
+            nextSlot += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(SLOT_MS));
+        }
+    }
+    for (auto& producer : producers) producer.join();
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.backpressureEvents = backpressure.load();
+    result.scheduled = scheduler.scheduled;
+    return result;
+}
+
+void report(const std::string& name, int producers, IngestionResult result, long long total) {
+    std::cout << std::setw(24) << std::left << name << std::right << std::setw(4) << producers << " producers: "
+              << std::setw(7) << total / result.seconds / 1e6 << " M req/s, latency p50 = "
+              << std::setw(9) << percentile(result.latencyUs, 0.50) << " us, p99 = "
+              << std::setw(9) << percentile(result.latencyUs, 0.99) << " us, backpressure = "
+              << result.backpressureEvents << ", mean batch = " << static_cast<double>(total) / result.drainCalls
+              << ", scheduled = " << result.scheduled << std::endl;
+}
+
+int main() {
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(NUM_RSUS, REQUESTS_PER_RUN, 1, 11, rsus, requests, services);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Ring capacity = " << RING_CAPACITY << ", requests per run = " << REQUESTS_PER_RUN
+              << ", RSUs = " << NUM_RSUS << ", hardware threads = " << std::thread::hardware_concurrency() << "\n" << std::endl;
+
+    for (int producers : {8, 16, 32}) {
+        long long total = static_cast<long long>(requests.size());
+        report("MPSC ring, continuous", producers, runIngestion<MPSCRing<Submission>>(producers, DrainMode::Continuous, requests, rsus), total);
+        report("MPSC ring, slot drain", producers, runIngestion<MPSCRing<Submission>>(producers, DrainMode::SlotBoundary, requests, rsus), total);
+        report("Mutex deque, continuous", producers, runIngestion<LockedQueue<Submission>>(producers, DrainMode::Continuous, requests, rsus), total);
+        std::cout << std::endl;
+    }
+    return 0;
+}
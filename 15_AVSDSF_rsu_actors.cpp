@@ -0,0 +1,457 @@
+/*
+AVSDSF - Actor-per-RSU execution model with batched mailboxes
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <limits>
+#include "avsdsf_model.h"
+
+const int CANDIDATES_PER_REQUEST = 16;    // Cheapest RSUs a request is offered to, in order
+const int NEIGHBOURHOOD_SIZE = 32;        // RSUs around the vehicle's home RSU that it can reach
+const int PREFETCHED_SERVICES = 12;       // Most popular services pushed to every RSU each slot
+const double IMAGE_CAPACITY_SHARE = 0.3;  // Fraction of RSU capacity usable for prefetched images
+const double MIGRATION_PROBABILITY = 0.1; // Placed requests whose vehicle moves to another RSU
+const int SCHEDULER_ACTOR = 0;            // Actor id of the scheduler; RSU r is actor r + 1
+
+enum class MessageType {
+    Offer,          // Driver -> scheduler: offer `request` to its cheapest candidate
+    Reserve,        // Scheduler -> RSU: reserve `amount` for `request`
+    Release,        // Scheduler -> RSU: free the reservation of `request`
+    Prefetch,       // Scheduler -> RSU: install image `service` of size `amount`
+    Migrate,        // Scheduler -> source RSU: hand `request` over to RSU `peer`
+    MigrateIn,      // Source RSU -> target RSU: accept `request` with load `amount`
+    Granted,        // RSU -> scheduler: reservation made on RSU `peer`, `prefetchHit` if its image was there
+    Denied,         // RSU -> scheduler: no capacity on RSU `peer`
+    Migrated,       // Target RSU -> scheduler: `request` now runs on RSU `peer`
+    MigrationFailed // Target RSU -> scheduler: target full, `request` was lost
+};
+
+struct Message {
+    MessageType type;
+    int request;
+    int service;
+    double amount;
+    int peer;
+    bool prefetchHit = false; // Granted only
+};
+
+class ActorSystem;
+
+// An actor owns its state exclusively; it is only ever run by one worker at a time
+class Actor {
+    friend class ActorSystem;
+
+private:
+    std::mutex mailboxMutex;
+    std::vector<Message> mailbox;
+    std::atomic<bool> queued{false}; // Already on the run queue
+
+public:
+    virtual ~Actor() = default;
+    virtual void receive(const Message& message, ActorSystem& system) = 0;
+};
+
+// Actors multiplexed over a fixed worker pool. A worker takes an actor from the
+// run queue and handles its whole mailbox as one batch before moving on.
+class ActorSystem {
+private:
+    std::vector<Actor*> actors;
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::condition_variable runReady;
+    std::deque<int> runQueue;
+    bool stopping = false;
+
+    std::atomic<long long> pending{0}; // Messages sent but not yet handled
+    std::mutex idleMutex;
+    std::condition_variable idle;
+
+    void schedule(int actor) {
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            runQueue.push_back(actor);
+        }
+        runReady.notify_one();
+    }
+
+    void workerLoop() {
+        std::vector<Message> batch;
+        for (;;) {
+            int id;
+            {
+                std::unique_lock<std::mutex> lock(runMutex);
+                runReady.wait(lock, [&] { return stopping || !runQueue.empty(); });
+                if (runQueue.empty()) return;
+                id = runQueue.front();
+                runQueue.pop_front();
+            }
+            Actor& actor = *actors[id];
+            {
+                std::lock_guard<std::mutex> lock(actor.mailboxMutex);
+                batch.swap(actor.mailbox);
+            }
+            for (const auto& message : batch) actor.receive(message, *this);
+            delivered.fetch_add(batch.size(), std::memory_order_relaxed);
+            drains.fetch_add(1, std::memory_order_relaxed);
+            long long handled = static_cast<long long>(batch.size());
+            batch.clear();
+
+            // Requeue if messages arrived while the batch was being handled
+            actor.queued.store(false, std::memory_order_release);
+            bool more;
+            {
+                std::lock_guard<std::mutex> lock(actor.mailboxMutex);
+                more = !actor.mailbox.empty();
+            }
+            if (more && !actor.queued.exchange(true, std::memory_order_acq_rel)) schedule(id);
+
+            if (pending.fetch_sub(handled, std::memory_order_acq_rel) == handled) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                idle.notify_all();
+            }
+        }
+    }
+
+public:
+    std::atomic<long long> delivered{0};
+    std::atomic<long long> drains{0};
+
+    int spawn(Actor* actor) {
+        actors.push_back(actor);
+        return static_cast<int>(actors.size()) - 1;
+    }
+
+    void start(int numWorkers) {
+        for (int w = 0; w < numWorkers; ++w) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    void send(int target, const Message& message) {
+        pending.fetch_add(1, std::memory_order_acq_rel);
+        Actor& actor = *actors[target];
+        {
+            std::lock_guard<std::mutex> lock(actor.mailboxMutex);
+            actor.mailbox.push_back(message);
+        }
+        if (!actor.queued.exchange(true, std::memory_order_acq_rel)) schedule(target);
+    }
+
+    // Block until every message, including the ones sent by handlers, has been handled
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [&] { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            stopping = true;
+        }
+        runReady.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+};
+
+// RSU actor: capacity, reservations and prefetched images are private to it
+class RSUActor : public Actor {
+private:
+    RSU rsu;
+    std::vector<char> prefetched;
+    double imageStorageUsed = 0.0;
+    std::unordered_map<int, double> reservations; // Request -> reserved load
+
+public:
+    RSUActor(const RSU& state, int numServices) : rsu(state), prefetched(numServices, 0) {}
+
+    void receive(const Message& message, ActorSystem& system) override {
+        switch (message.type) {
+        case MessageType::Reserve:
+            if (rsu.usedCapacity + message.amount <= rsu.maxCapacity) {
+                rsu.usedCapacity += message.amount;
+                reservations[message.request] = message.amount;
+                system.send(SCHEDULER_ACTOR, {MessageType::Granted, message.request, message.service, message.amount, rsu.id,
+                                              prefetched[message.service] != 0});
+            } else {
+                system.send(SCHEDULER_ACTOR, {MessageType::Denied, message.request, message.service, message.amount, rsu.id});
+            }
+            break;
+        case MessageType::Release: {
+            auto it = reservations.find(message.request);
+            if (it != reservations.end()) {
+                rsu.usedCapacity -= it->second;
+                reservations.erase(it);
+            }
+            break;
+        }
+        case MessageType::Prefetch:
+            if (!prefetched[message.service] && imageStorageUsed + message.amount <= IMAGE_CAPACITY_SHARE * rsu.maxCapacity) {
+                prefetched[message.service] = 1;
+                imageStorageUsed += message.amount;
+            }
+            break;
+        case MessageType::Migrate: {
+            auto it = reservations.find(message.request);
+            if (it == reservations.end()) break;
+            double load = it->second;
+            rsu.usedCapacity -= load;
+            reservations.erase(it);
+            system.send(message.peer + 1, {MessageType::MigrateIn, message.request, message.service, load, rsu.id});
+            break;
+        }
+        case MessageType::MigrateIn:
+            if (rsu.usedCapacity + message.amount <= rsu.maxCapacity) {
+                rsu.usedCapacity += message.amount;
+                reservations[message.request] = message.amount;
+                system.send(SCHEDULER_ACTOR, {MessageType::Migrated, message.request, message.service, message.amount, rsu.id});
+            } else {
+                system.send(SCHEDULER_ACTOR, {MessageType::MigrationFailed, message.request, message.service, message.amount, rsu.id});
+            }
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+struct SlotStats {
+    int placed = 0;
+    int dropped = 0;
+    int prefetchHits = 0;
+    int migrated = 0;
+    int migrationsFailed = 0;
+    double totalCost = 0.0;
+};
+
+// Scheduler actor: turns placement decisions into Reserve messages and walks
+// each request down its candidate list on denial
+class SchedulerActor : public Actor {
+private:
+    const std::vector<ServiceRequest>& requests;
+    const std::vector<int>& requestService;
+
+public:
+    std::vector<std::vector<int>> candidates; // Request -> RSUs, cheapest first
+    std::vector<std::vector<double>> candidateCosts;
+    std::vector<int> nextCandidate;
+    std::vector<int> assigned;                // Request -> RSU (-1 if none)
+    SlotStats stats;
+
+    SchedulerActor(const std::vector<ServiceRequest>& reqs, const std::vector<int>& services)
+        : requests(reqs), requestService(services), candidates(reqs.size()), candidateCosts(reqs.size()),
+          nextCandidate(reqs.size(), 0), assigned(reqs.size(), -1) {}
+
+    void offer(int request, ActorSystem& system) {
+        int rsu = candidates[request][nextCandidate[request]++];
+        system.send(rsu + 1, {MessageType::Reserve, request, requestService[request], requests[request].computationLoad, -1});
+    }
+
+    void receive(const Message& message, ActorSystem& system) override {
+        int request = message.request;
+        switch (message.type) {
+        case MessageType::Offer:
+            offer(request, system);
+            break;
+        case MessageType::Granted:
+            assigned[request] = message.peer;
+            stats.placed++;
+            if (message.prefetchHit) stats.prefetchHits++;
+            stats.totalCost += candidateCosts[request][nextCandidate[request] - 1];
+            break;
+        case MessageType::Denied:
+            if (nextCandidate[request] < static_cast<int>(candidates[request].size())) {
+                offer(request, system);
+            } else {
+                stats.dropped++;
+            }
+            break;
+        case MessageType::Migrated:
+            assigned[request] = message.peer;
+            stats.migrated++;
+            break;
+        case MessageType::MigrationFailed:
+            assigned[request] = -1;
+            stats.migrationsFailed++;
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+// Cheapest CANDIDATES_PER_REQUEST RSUs in the vehicle's neighbourhood under the slot's weights
+void rankCandidates(const ServiceRequest& request, int homeRSU, const std::vector<RSU>& profiles, const std::vector<double>& weights,
+                    std::vector<std::pair<double, int>>& scratch, std::vector<int>& ids, std::vector<double>& costs) {
+    scratch.clear();
+    for (int k = 0; k < NEIGHBOURHOOD_SIZE && k < static_cast<int>(profiles.size()); ++k) {
+        const RSU& rsu = profiles[(homeRSU + k) % profiles.size()];
+        if (request.computationLoad <= rsu.maxCapacity) scratch.push_back({computePlacementCost(request, rsu, weights), rsu.id});
+    }
+    size_t keep = std::min(scratch.size(), static_cast<size_t>(CANDIDATES_PER_REQUEST));
+    std::partial_sort(scratch.begin(), scratch.begin() + keep, scratch.end());
+    ids.clear();
+    costs.clear();
+    for (size_t k = 0; k < keep; ++k) {
+        ids.push_back(scratch[k].second);
+        costs.push_back(scratch[k].first);
+    }
+}
+
+struct RunResult {
+    std::vector<SlotStats> slots;
+    double seconds = 0.0;
+    long long messages = 0;
+    long long drains = 0;
+};
+
+// One run of T slots on the actor runtime with the given number of workers
+RunResult runActors(int T, int numWorkers, const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests,
+                    const std::vector<PrefetchedService>& services, const std::vector<int>& requestService,
+                    const std::vector<int>& homeRSUs) {
+    ActorSystem system;
+    SchedulerActor scheduler(requests, requestService);
+    system.spawn(&scheduler);
+    std::vector<std::unique_ptr<RSUActor>> rsuActors;
+    for (const auto& rsu : rsus) {
+        rsuActors.push_back(std::make_unique<RSUActor>(rsu, static_cast<int>(services.size())));
+        system.spawn(rsuActors.back().get());
+    }
+
+    // Static RSU attributes are the only thing the scheduler reads directly
+    std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+    std::vector<std::pair<double, int>> scratch;
+    for (size_t r = 0; r < requests.size(); ++r) {
+        rankCandidates(requests[r], homeRSUs[r], rsus, weights, scratch, scheduler.candidates[r], scheduler.candidateCosts[r]);
+    }
+
+    RunResult result;
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> anyRSU(0, static_cast<int>(rsus.size()) - 1);
+    auto start = std::chrono::high_resolution_clock::now();
+    system.start(numWorkers);
+    for (int t = 0; t < T; ++t) {
+        scheduler.stats = SlotStats();
+        std::fill(scheduler.nextCandidate.begin(), scheduler.nextCandidate.end(), 0);
+        std::fill(scheduler.assigned.begin(), scheduler.assigned.end(), -1);
+
+        // Prefetch: rotate through the popular services so each slot adds images
+        for (int k = 0; k < PREFETCHED_SERVICES; ++k) {
+            const auto& service = services[(t * PREFETCHED_SERVICES / 2 + k) % services.size()];
+            for (const auto& rsu : rsus) system.send(rsu.id + 1, {MessageType::Prefetch, -1, service.id, service.size, -1});
+        }
+        system.waitIdle();
+
+        // Placement: every request is offered to its cheapest candidate at once,
+        // through the scheduler's mailbox like every other interaction
+        for (size_t r = 0; r < requests.size(); ++r) {
+            if (!scheduler.candidates[r].empty()) system.send(SCHEDULER_ACTOR, {MessageType::Offer, static_cast<int>(r), requestService[r], 0.0, -1});
+        }
+        system.waitIdle();
+
+        // Mobility: some vehicles move and their requests follow them
+        for (size_t r = 0; r < requests.size(); ++r) {
+            if (scheduler.assigned[r] >= 0 && coin(gen) < MIGRATION_PROBABILITY) {
+                int target = anyRSU(gen);
+                if (target != scheduler.assigned[r]) {
+                    system.send(scheduler.assigned[r] + 1, {MessageType::Migrate, static_cast<int>(r), requestService[r], 0.0, target});
+                }
+            }
+        }
+        system.waitIdle();
+
+        // End of slot: release every reservation
+        for (size_t r = 0; r < requests.size(); ++r) {
+            if (scheduler.assigned[r] >= 0) system.send(scheduler.assigned[r] + 1, {MessageType::Release, static_cast<int>(r), 0, 0.0, -1});
+        }
+        system.waitIdle();
+        result.slots.push_back(scheduler.stats);
+    }
+    system.stop();
+    result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    result.messages = system.delivered.load();
+    result.drains = system.drains.load();
+    return result;
+}
+
+// The same candidate lists placed directly on shared RSU state from one loop,
+// as a rough comparison only. Requests are offered in rounds (every request's
+// k-th candidate before any (k+1)-th). The actor runtime delivers Reserve
+// messages and replies in a worker-dependent order, so its placed count and
+// cost differ from this loop's, and from run to run, by a small margin.
+SlotStats runDirect(std::vector<RSU> rsus, const std::vector<ServiceRequest>& requests, const std::vector<int>& homeRSUs) {
+    std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+    std::vector<std::pair<double, int>> scratch;
+    std::vector<std::vector<int>> candidates(requests.size());
+    std::vector<std::vector<double>> candidateCosts(requests.size());
+    for (size_t r = 0; r < requests.size(); ++r) {
+        rankCandidates(requests[r], homeRSUs[r], rsus, weights, scratch, candidates[r], candidateCosts[r]);
+    }
+
+    SlotStats stats;
+    std::vector<char> placed(requests.size(), 0);
+    for (int k = 0; k < CANDIDATES_PER_REQUEST; ++k) {
+        for (size_t r = 0; r < requests.size(); ++r) {
+            if (placed[r] || k >= static_cast<int>(candidates[r].size())) continue;
+            RSU& rsu = rsus[candidates[r][k]];
+            if (rsu.usedCapacity + requests[r].computationLoad <= rsu.maxCapacity) {
+                rsu.usedCapacity += requests[r].computationLoad;
+                stats.totalCost += candidateCosts[r][k];
+                stats.placed++;
+                placed[r] = 1;
+            }
+        }
+    }
+    stats.dropped = static_cast<int>(requests.size()) - stats.placed;
+    return stats;
+}
+
+int main() {
+    const int numRSUs = 1000;
+    const int numRequests = 20000;
+    const int numServices = 60;
+    const int T = 5; // Number of time slots
+
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(numRSUs, numRequests, numServices, 23, rsus, requests, services, 1.5);
+    std::mt19937 gen(29);
+    std::uniform_int_distribution<int> anyService(0, numServices / 4); // Demand concentrated on popular services
+    std::vector<int> requestService(numRequests);
+    for (auto& service : requestService) service = anyService(gen);
+    std::uniform_int_distribution<int> anyRSU(0, numRSUs - 1);
+    std::vector<int> homeRSUs(numRequests);
+    for (auto& home : homeRSUs) home = anyRSU(gen);
+
+    SlotStats direct = runDirect(rsus, requests, homeRSUs);
+
+    std::cout << std::fixed << std::setprecision(3);
+    RunResult baseline = runActors(T, 4, rsus, requests, services, requestService, homeRSUs);
+    for (int t = 0; t < T; ++t) {
+        const SlotStats& slot = baseline.slots[t];
+        std::cout << "Time Slot " << t << ": Placed = " << slot.placed << ", Dropped = " << slot.dropped
+                  << ", Prefetch Hits = " << slot.prefetchHits << ", Migrated = " << slot.migrated
+                  << ", Migrations Failed = " << slot.migrationsFailed << ", Total Cost = " << slot.totalCost << std::endl;
+    }
+    std::cout << "Direct loop (shared RSU state, rough comparison): Placed = " << direct.placed << ", Dropped = " << direct.dropped
+              << ", Total Cost = " << direct.totalCost << "\n" << std::endl;
+
+    std::cout << "Hardware threads = " << std::thread::hardware_concurrency() << std::endl;
+    for (int workers : {1, 2, 4, 8}) {
+        RunResult run = runActors(T, workers, rsus, requests, services, requestService, homeRSUs);
+        std::cout << "Workers = " << workers << ": " << run.messages / run.seconds / 1e6 << " M messages/sec, "
+                  << run.seconds * 1000.0 / T << " ms/slot, mean mailbox batch = "
+                  << static_cast<double>(run.messages) / run.drains << ", Placed (slot 0) = " << run.slots[0].placed << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,456 @@
+/*
+AVSDSF - Coroutine-based asynchronous image fetch, migration and offload simulation (C++20)
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include "avsdsf_model.h"
+
+const double BACKHAUL_BANDWIDTH = 100.0;   // Base station -> RSU image bandwidth (MB/s)
+const double BACKHAUL_LATENCY = 0.004;     // Backhaul propagation delay (s)
+const double PEER_BANDWIDTH = 250.0;       // RSU -> RSU migration bandwidth (MB/s)
+const double PEER_LATENCY = 0.001;         // RSU -> RSU propagation delay (s)
+const double CLOUD_BANDWIDTH = 40.0;       // RSU <-> cloud bandwidth (MB/s)
+const double CLOUD_LATENCY = 0.030;        // RSU <-> cloud round trip share per direction (s)
+const double RSU_COMPUTE_RATE = 400.0;     // Computation load processed per second on an RSU
+const double CLOUD_COMPUTE_RATE = 2000.0;  // Computation load processed per second in the cloud
+const double IMAGE_STORAGE = 200.0;        // Image storage per RSU (MB); images beyond it are streamed
+const double MIGRATION_PROBABILITY = 0.1;  // Requests whose vehicle leaves the RSU while running
+const double WEIGHT_REFRESH = 0.1;         // Simulated seconds between dynamic weight updates
+const int NEIGHBOURHOOD_SIZE = 16;         // RSUs around the vehicle's home RSU that it can reach
+
+// Bytes held by live coroutine frames (all tasks below allocate through it)
+struct FrameCounter {
+    static inline size_t live = 0;
+    static inline size_t peak = 0;
+    static inline size_t frames = 0;
+
+    static void* allocate(size_t size) {
+        live += size;
+        peak = std::max(peak, live);
+        frames++;
+        return ::operator new(size);
+    }
+    static void release(void* pointer, size_t size) {
+        live -= size;
+        ::operator delete(pointer);
+    }
+};
+
+// Lazily started coroutine returning T. Awaiting it starts the body and
+// resumes the awaiter when it finishes (symmetric transfer, no recursion).
+template <typename T>
+struct TaskResult {
+    T value{};
+    void return_value(T result) { value = std::move(result); }
+    T take() { return std::move(value); }
+};
+
+template <>
+struct TaskResult<void> {
+    void return_void() {}
+    void take() {}
+};
+
+template <typename T = void>
+class Task {
+public:
+    struct promise_type : TaskResult<T> {
+        std::coroutine_handle<> continuation;
+
+        static void* operator new(size_t size) { return FrameCounter::allocate(size); }
+        static void operator delete(void* pointer, size_t size) { FrameCounter::release(pointer, size); }
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    auto continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() { return handle.promise().take(); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Fire-and-forget wrapper: starts immediately and frees its frame when done
+struct Detached {
+    struct promise_type {
+        static void* operator new(size_t size) { return FrameCounter::allocate(size); }
+        static void operator delete(void* pointer, size_t size) { FrameCounter::release(pointer, size); }
+
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+inline Detached spawn(Task<void> task) {
+    co_await task;
+}
+
+// Single-threaded discrete-event loop over simulated time. Coroutines suspend
+// on timers or on the ready queue; run() resumes them in time order.
+class EventLoop {
+private:
+    struct Timer {
+        double time;
+        uint64_t sequence; // FIFO among equal times
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::deque<std::coroutine_handle<>> ready;
+    double current = 0.0;
+    uint64_t nextSequence = 0;
+
+public:
+    uint64_t resumes = 0;
+
+    struct TimerAwaiter {
+        EventLoop& loop;
+        double wake;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop.timers.push({wake, loop.nextSequence++, handle}); }
+        void await_resume() const noexcept {}
+    };
+
+    struct YieldAwaiter {
+        EventLoop& loop;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop.ready.push_back(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    double now() const { return current; }
+    TimerAwaiter sleepUntil(double time) { return {*this, std::max(time, current)}; }
+    TimerAwaiter delay(double seconds) { return {*this, current + std::max(0.0, seconds)}; }
+    YieldAwaiter yield() { return {*this}; }
+    void post(std::coroutine_handle<> handle) { ready.push_back(handle); }
+
+    void run() {
+        for (;;) {
+            while (!ready.empty()) {
+                auto handle = ready.front();
+                ready.pop_front();
+                resumes++;
+                handle.resume();
+            }
+            if (timers.empty()) break;
+            Timer timer = timers.top();
+            timers.pop();
+            current = timer.time;
+            resumes++;
+            timer.handle.resume();
+        }
+    }
+};
+
+// FIFO link: transfers are serialised at the link bandwidth, then delayed by its latency
+struct Link {
+    double bandwidth;
+    double latency;
+    double busyUntil = 0.0;
+};
+
+inline EventLoop::TimerAwaiter transfer(EventLoop& loop, Link& link, double megabytes) {
+    double start = std::max(loop.now(), link.busyUntil);
+    link.busyUntil = start + megabytes / link.bandwidth;
+    return loop.sleepUntil(link.busyUntil + link.latency);
+}
+
+// Image presence on an RSU; requests arriving during a fetch wait for it
+struct ImageState {
+    bool cached = false;
+    bool fetching = false;
+    std::vector<std::coroutine_handle<>> waiters;
+};
+
+struct SimulationStats {
+    long long served = 0;
+    long long offloaded = 0;
+    long long fetches = 0;
+    long long coalescedFetches = 0;
+    long long streamedImages = 0;
+    long long migrations = 0;
+    double totalCost = 0.0;
+    std::vector<double> latencies;
+};
+
+class TransferSimulation {
+private:
+    EventLoop& loop;
+    std::vector<RSU> rsus;
+    const std::vector<ServiceRequest>& requests;
+    const std::vector<PrefetchedService>& services;
+    const std::vector<int>& requestService;
+    const std::vector<int>& homeRSUs;
+    std::vector<Link> backhaul;
+    std::vector<Link> peerLinks;
+    std::vector<Link> cloudLinks;
+    std::vector<ImageState> images; // rsu * numServices + service
+    std::vector<double> imageStorageUsed;
+    std::vector<double> weights;
+    int pendingRequests;
+
+    struct ImageWait {
+        ImageState& image;
+        bool await_ready() const noexcept { return image.cached; }
+        void await_suspend(std::coroutine_handle<> handle) { image.waiters.push_back(handle); }
+        void await_resume() const noexcept {}
+    };
+
+public:
+    SimulationStats stats;
+
+    TransferSimulation(EventLoop& eventLoop, const std::vector<RSU>& initial, const std::vector<ServiceRequest>& reqs,
+                       const std::vector<PrefetchedService>& svcs, const std::vector<int>& reqService, const std::vector<int>& homes)
+        : loop(eventLoop), rsus(initial), requests(reqs), services(svcs), requestService(reqService), homeRSUs(homes),
+          backhaul(initial.size(), {BACKHAUL_BANDWIDTH, BACKHAUL_LATENCY}), peerLinks(initial.size(), {PEER_BANDWIDTH, PEER_LATENCY}),
+          cloudLinks(initial.size(), {CLOUD_BANDWIDTH, CLOUD_LATENCY}), images(initial.size() * svcs.size()),
+          imageStorageUsed(initial.size(), 0.0), weights(computeDynamicWeights(0.0)), pendingRequests(static_cast<int>(reqs.size())) {}
+
+    // Suspends until the image is on the RSU; concurrent requests share one fetch
+    Task<double> fetchImage(int rsu, int service) {
+        ImageState& image = images[rsu * services.size() + service];
+        double start = loop.now();
+        if (image.cached) co_return 0.0;
+        if (image.fetching) {
+            stats.coalescedFetches++;
+            co_await ImageWait{image};
+            co_return loop.now() - start;
+        }
+        image.fetching = true;
+        co_await transfer(loop, backhaul[rsu], services[service].size);
+        stats.fetches++;
+        image.fetching = false;
+        if (imageStorageUsed[rsu] + services[service].size <= IMAGE_STORAGE) {
+            imageStorageUsed[rsu] += services[service].size;
+            image.cached = true;
+        } else {
+            stats.streamedImages++; // Used once and dropped; the next request fetches again
+        }
+        for (auto waiter : image.waiters) loop.post(waiter);
+        image.waiters.clear();
+        co_return loop.now() - start;
+    }
+
+    // Follows the vehicle to another RSU: state over the peer link, image on the target
+    Task<void> migrate(int from, int to, int service, double stateSize) {
+        co_await transfer(loop, peerLinks[from], stateSize);
+        co_await fetchImage(to, service);
+        stats.migrations++;
+    }
+
+    // Uplink the input, compute in the cloud, downlink the result
+    Task<void> offloadToCloud(int rsu, const ServiceRequest& request) {
+        co_await transfer(loop, cloudLinks[rsu], request.demand);
+        co_await loop.delay(request.computationLoad / CLOUD_COMPUTE_RATE);
+        co_await transfer(loop, cloudLinks[rsu], request.demand * 0.1);
+        stats.offloaded++;
+    }
+
+    Task<void> refreshWeights() {
+        while (pendingRequests > 0) {
+            weights = computeDynamicWeights(computeSystemLoad(rsus));
+            co_await loop.delay(WEIGHT_REFRESH);
+        }
+    }
+
+    int pickRSU(const ServiceRequest& request, int home, double& bestCost) const {
+        bestCost = std::numeric_limits<double>::max();
+        int best = -1;
+        for (int k = 0; k < NEIGHBOURHOOD_SIZE; ++k) {
+            const RSU& rsu = rsus[(home + k) % rsus.size()];
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                double cost = computePlacementCost(request, rsu, weights);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = rsu.id;
+                }
+            }
+        }
+        return best;
+    }
+
+    Task<void> serveRequest(int r, double arrival, bool migrates, int migrationTarget) {
+        co_await loop.sleepUntil(arrival);
+        const ServiceRequest& request = requests[r];
+        double cost = 0.0;
+        int rsu = pickRSU(request, homeRSUs[r], cost);
+        if (rsu < 0) {
+            co_await offloadToCloud(homeRSUs[r], request);
+        } else {
+            rsus[rsu].usedCapacity += request.computationLoad;
+            co_await fetchImage(rsu, requestService[r]);
+            co_await loop.delay(request.computationLoad / RSU_COMPUTE_RATE);
+            rsus[rsu].usedCapacity -= request.computationLoad;
+            if (migrates) co_await migrate(rsu, migrationTarget, requestService[r], request.demand);
+            stats.totalCost += cost;
+            stats.served++;
+        }
+        stats.latencies.push_back(loop.now() - arrival);
+        pendingRequests--;
+    }
+};
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Switch overhead: coroutines that do nothing but yield back to the loop
+Task<void> yielder(EventLoop& loop, int rounds) {
+    for (int i = 0; i < rounds; ++i) co_await loop.yield();
+}
+
+Task<int> leaf(int value) {
+    co_return value + 1;
+}
+
+// Await overhead: nested task calls that complete without suspending. The
+// periodic yield unwinds the stack in builds where symmetric transfer is not
+// compiled to a tail call (unoptimised or sanitizer builds).
+Task<void> awaitChain(EventLoop& loop, int calls, long long& sink) {
+    for (int i = 0; i < calls; ++i) {
+        sink += co_await leaf(i);
+        if ((i & 1023) == 1023) co_await loop.yield();
+    }
+}
+
+// One in-flight transfer for the concurrency benchmark
+Task<void> transferJob(EventLoop& loop, Link& link, double megabytes, double& finished) {
+    co_await transfer(loop, link, megabytes);
+    finished += 1.0;
+}
+
+int main() {
+    using Clock = std::chrono::high_resolution_clock;
+    std::cout << std::fixed << std::setprecision(3);
+
+    // Scenario: requests arrive over ten simulated seconds and suspend on transfers
+    const int numRSUs = 400;
+    const int numRequests = 100000;
+    const int numServices = 30;
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(numRSUs, numRequests, numServices, 31, rsus, requests, services, 0.05);
+    std::mt19937 gen(37);
+    std::uniform_int_distribution<int> anyService(0, numServices - 1);
+    std::uniform_int_distribution<int> anyRSU(0, numRSUs - 1);
+    std::uniform_real_distribution<> arrival(0.0, 10.0);
+    std::uniform_real_distribution<> coin(0.0, 1.0);
+    std::vector<int> requestService(numRequests), homeRSUs(numRequests);
+    for (int r = 0; r < numRequests; ++r) {
+        requestService[r] = anyService(gen);
+        homeRSUs[r] = anyRSU(gen);
+    }
+
+    {
+        EventLoop loop;
+        TransferSimulation simulation(loop, rsus, requests, services, requestService, homeRSUs);
+        spawn(simulation.refreshWeights());
+        for (int r = 0; r < numRequests; ++r) {
+            bool migrates = coin(gen) < MIGRATION_PROBABILITY;
+            spawn(simulation.serveRequest(r, arrival(gen), migrates, anyRSU(gen)));
+        }
+        auto start = Clock::now();
+        loop.run();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        SimulationStats& stats = simulation.stats;
+        std::cout << "Simulated " << numRequests << " requests over " << loop.now() << " s in " << seconds * 1000.0 << " ms wall" << std::endl;
+        std::cout << "Served on RSUs = " << stats.served << ", Offloaded to cloud = " << stats.offloaded
+                  << ", Total Cost = " << stats.totalCost << std::endl;
+        std::cout << "Image fetches = " << stats.fetches << ", Coalesced = " << stats.coalescedFetches
+                  << ", Streamed (storage full) = " << stats.streamedImages << ", Migrations = " << stats.migrations << std::endl;
+        std::cout << "Latency mean = " << std::accumulate(stats.latencies.begin(), stats.latencies.end(), 0.0) / stats.latencies.size() * 1000.0
+                  << " ms, p50 = " << percentile(stats.latencies, 0.50) * 1000.0
+                  << " ms, p99 = " << percentile(stats.latencies, 0.99) * 1000.0 << " ms\n" << std::endl;
+    }
+
+    // Switch overhead through the ready queue
+    {
+        const int coroutines = 1000, rounds = 2000;
+        EventLoop loop;
+        for (int c = 0; c < coroutines; ++c) spawn(yielder(loop, rounds));
+        auto start = Clock::now();
+        loop.run();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "Yield round trip: " << seconds * 1e9 / loop.resumes << " ns per suspend/resume ("
+                  << loop.resumes << " resumes)" << std::endl;
+    }
+
+    // Nested task await without suspension (frame allocation + symmetric transfer)
+    {
+        const int calls = 5000000;
+        long long sink = 0;
+        EventLoop loop;
+        auto start = Clock::now();
+        spawn(awaitChain(loop, calls, sink));
+        loop.run();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "Nested co_await of a Task: " << seconds * 1e9 / calls << " ns per call (checksum " << sink % 1000 << ")" << std::endl;
+    }
+
+    // A million transfers in flight at once, each suspended on a timer
+    {
+        const int inFlight = 1000000;
+        EventLoop loop;
+        std::vector<Link> links(1000, {BACKHAUL_BANDWIDTH, BACKHAUL_LATENCY});
+        std::uniform_real_distribution<> size(0.5, 4.0);
+        double finished = 0.0;
+        size_t baseline = FrameCounter::live;
+        auto start = Clock::now();
+        for (int i = 0; i < inFlight; ++i) spawn(transferJob(loop, links[i % links.size()], size(gen), finished));
+        size_t peakFrames = FrameCounter::live - baseline;
+        loop.run();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "Concurrent transfers: " << static_cast<long long>(finished) << " in flight, "
+                  << peakFrames / static_cast<double>(inFlight) << " bytes of frames each, "
+                  << seconds * 1e9 / inFlight << " ns per transfer (spawn + timer + completion), "
+                  << "simulated makespan " << loop.now() << " s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,428 @@
+/*
+AVSDSF - Geographic sharding of the RSU fleet with thread-per-shard scheduling
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "avsdsf_model.h"
+
+const double RSU_SPACING = 500.0;  // Distance between neighbouring RSUs on the grid (metres)
+const double REACH = 800.0;        // Vehicles can be served by RSUs within this distance (metres)
+const int REACH_CELLS = 2;         // Grid rows/columns scanned around the vehicle (REACH / RSU_SPACING, rounded up)
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Vehicle {
+    double x;
+    double y;
+};
+
+// Rectangular partition of the RSU grid into shardsX x shardsY regions
+struct ShardMap {
+    int columns;
+    int rows;
+    int shardsX;
+    int shardsY;
+
+    int numShards() const { return shardsX * shardsY; }
+    int shardOfCell(int column, int row) const {
+        int sx = std::min(shardsX - 1, column * shardsX / columns);
+        int sy = std::min(shardsY - 1, row * shardsY / rows);
+        return sy * shardsX + sx;
+    }
+    int shardOfRSU(int rsu) const { return shardOfCell(rsu % columns, rsu / columns); }
+    int nearestColumn(double x) const { return std::clamp(static_cast<int>(x / RSU_SPACING), 0, columns - 1); }
+    int nearestRow(double y) const { return std::clamp(static_cast<int>(y / RSU_SPACING), 0, rows - 1); }
+    int shardOfVehicle(const Vehicle& v) const { return shardOfCell(nearestColumn(v.x), nearestRow(v.y)); }
+};
+
+// RSUs within REACH of the vehicle, in grid order
+void candidatesInReach(const Vehicle& vehicle, const ShardMap& map, const std::vector<RSULocation>& locations, std::vector<int>& out) {
+    out.clear();
+    int cx = map.nearestColumn(vehicle.x), cy = map.nearestRow(vehicle.y);
+    for (int row = std::max(0, cy - REACH_CELLS); row <= std::min(map.rows - 1, cy + REACH_CELLS); ++row) {
+        for (int column = std::max(0, cx - REACH_CELLS); column <= std::min(map.columns - 1, cx + REACH_CELLS); ++column) {
+            int rsu = row * map.columns + column;
+            if (rsu >= static_cast<int>(locations.size())) continue;
+            if (std::hypot(locations[rsu].x - vehicle.x, locations[rsu].y - vehicle.y) <= REACH) out.push_back(rsu);
+        }
+    }
+}
+
+// Cross-shard messages. A request whose cheapest RSU lies across the border is
+// handed to the owning shard; that shard either places it or declines, and the
+// origin then places it locally.
+struct ShardMessage {
+    enum Type { Handoff, Declined } type;
+    int request;
+    int origin;
+    double localCost; // Origin's best local cost (infinity if nothing local fits)
+};
+
+class ShardInbox {
+private:
+    std::mutex mutex;
+    std::vector<ShardMessage> messages;
+
+public:
+    void push(const ShardMessage& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.push_back(message);
+    }
+    void takeAll(std::vector<ShardMessage>& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        out.swap(messages);
+    }
+};
+
+// Reusable barrier for the shard threads
+class SlotBarrier {
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    int parties;
+    int waiting = 0;
+    long long generation = 0;
+
+public:
+    explicit SlotBarrier(int count) : parties(count) {}
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        long long arrived = generation;
+        if (++waiting == parties) {
+            waiting = 0;
+            generation++;
+            released.notify_all();
+        } else {
+            released.wait(lock, [&] { return generation != arrived; });
+        }
+    }
+};
+
+struct SlotStats {
+    int placed = 0;
+    int dropped = 0;
+    int handoffs = 0;
+    int placedRemotely = 0; // Handoffs accepted by the neighbour shard
+    double totalCost = 0.0;
+};
+
+// Read-only inputs shared by all shards for one run
+struct Fleet {
+    ShardMap map;
+    std::vector<RSU> rsus;
+    std::vector<RSULocation> locations;
+    std::vector<ServiceRequest> requests;
+    std::vector<std::vector<Vehicle>> positions; // Slot -> request -> vehicle position
+};
+
+// One shard: owns its RSUs, load, weights and decisions. Only its own thread
+// touches them; other shards reach it through its inbox.
+class Shard {
+private:
+    int id;
+    const Fleet& fleet;
+    std::vector<RSU> rsus;    // Full-size vector, only owned entries are used
+    std::vector<char> owned;
+    std::vector<double> weights;
+    std::vector<int> scratch;
+
+    // Cheapest owned RSU within reach that fits, or -1
+    int bestOwned(int request, const Vehicle& vehicle, double& bestCost) {
+        candidatesInReach(vehicle, fleet.map, fleet.locations, scratch);
+        bestCost = std::numeric_limits<double>::max();
+        int best = -1;
+        const ServiceRequest& r = fleet.requests[request];
+        for (int rsu : scratch) {
+            if (!owned[rsu] || rsus[rsu].usedCapacity + r.computationLoad > rsus[rsu].maxCapacity) continue;
+            double cost = computePlacementCost(r, rsus[rsu], weights);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = rsu;
+            }
+        }
+        return best;
+    }
+
+    void place(int request, int rsu, double cost) {
+        rsus[rsu].usedCapacity += fleet.requests[request].computationLoad;
+        decisions.push_back({request, rsu});
+        stats.placed++;
+        stats.totalCost += cost;
+    }
+
+    void placeLocallyOrDrop(int request, const Vehicle& vehicle) {
+        double cost;
+        int rsu = bestOwned(request, vehicle, cost);
+        if (rsu >= 0) {
+            place(request, rsu, cost);
+        } else {
+            stats.dropped++;
+        }
+    }
+
+public:
+    std::vector<std::pair<int, int>> decisions; // Request -> RSU placed by this shard (current slot)
+    SlotStats stats;
+
+    Shard(int shardId, const Fleet& f) : id(shardId), fleet(f), rsus(f.rsus), owned(f.rsus.size(), 0) {
+        for (size_t r = 0; r < rsus.size(); ++r) owned[r] = fleet.map.shardOfRSU(static_cast<int>(r)) == id;
+        weights = computeDynamicWeights(0.0);
+    }
+
+    // Start of a slot: weights from the load this shard carried in the previous slot, then release capacity
+    void startSlot() {
+        double used = 0.0, total = 0.0;
+        for (size_t r = 0; r < rsus.size(); ++r) {
+            if (!owned[r]) continue;
+            used += rsus[r].usedCapacity;
+            total += rsus[r].maxCapacity;
+            rsus[r].usedCapacity = 0.0;
+        }
+        weights = computeDynamicWeights(total > 0.0 ? used / total : 0.0);
+        decisions.clear();
+        stats = SlotStats();
+    }
+
+    // Local request: place here unless an RSU across the border is cheaper
+    void schedule(int request, const Vehicle& vehicle, std::vector<std::unique_ptr<ShardInbox>>& inboxes,
+                  std::atomic<long long>& inFlight) {
+        double localCost;
+        int local = bestOwned(request, vehicle, localCost);
+
+        // Foreign candidates (bestOwned left all candidates in reach in scratch) are
+        // ranked on their static cost terms; their capacity is unknown here
+        double foreignCost = std::numeric_limits<double>::max();
+        int foreign = -1;
+        const ServiceRequest& r = fleet.requests[request];
+        for (int rsu : scratch) {
+            if (owned[rsu] || r.computationLoad > rsus[rsu].maxCapacity) continue;
+            double cost = computePlacementCost(r, fleet.rsus[rsu], weights);
+            if (cost < foreignCost) {
+                foreignCost = cost;
+                foreign = rsu;
+            }
+        }
+
+        if (foreign >= 0 && foreignCost < localCost) {
+            stats.handoffs++;
+            inFlight.fetch_add(1, std::memory_order_acq_rel);
+            inboxes[fleet.map.shardOfRSU(foreign)]->push({ShardMessage::Handoff, request, id, localCost});
+        } else if (local >= 0) {
+            place(request, local, localCost);
+        } else {
+            stats.dropped++;
+        }
+    }
+
+    void handle(const ShardMessage& message, int slot, std::vector<std::unique_ptr<ShardInbox>>& inboxes,
+                std::atomic<long long>& inFlight) {
+        const Vehicle& vehicle = fleet.positions[slot][message.request];
+        if (message.type == ShardMessage::Handoff) {
+            double cost;
+            int rsu = bestOwned(message.request, vehicle, cost);
+            if (rsu >= 0 && cost < message.localCost) {
+                place(message.request, rsu, cost);
+                stats.placedRemotely++;
+            } else {
+                inFlight.fetch_add(1, std::memory_order_acq_rel);
+                inboxes[message.origin]->push({ShardMessage::Declined, message.request, id, message.localCost});
+            }
+        } else {
+            placeLocallyOrDrop(message.request, vehicle);
+        }
+        inFlight.fetch_sub(1, std::memory_order_acq_rel);
+    }
+};
+
+// Pin the calling thread to one core; returns false where unsupported or refused
+bool pinToCore(int core) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+struct RunResult {
+    std::vector<SlotStats> slots;
+    double seconds = 0.0;
+    int pinned = 0;
+};
+
+RunResult runSharded(const Fleet& fleet, int T) {
+    int numShards = fleet.map.numShards();
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::unique_ptr<ShardInbox>> inboxes;
+    for (int s = 0; s < numShards; ++s) {
+        shards.push_back(std::make_unique<Shard>(s, fleet));
+        inboxes.push_back(std::make_unique<ShardInbox>());
+    }
+
+    // Route every request of every slot to the shard of its vehicle's location
+    std::vector<std::vector<std::vector<int>>> routed(T, std::vector<std::vector<int>>(numShards));
+    for (int t = 0; t < T; ++t) {
+        for (size_t r = 0; r < fleet.requests.size(); ++r) {
+            routed[t][fleet.map.shardOfVehicle(fleet.positions[t][r])].push_back(static_cast<int>(r));
+        }
+    }
+
+    RunResult result;
+    result.slots.resize(T);
+    SlotBarrier barrier(numShards);
+    std::atomic<long long> inFlight{0};
+    std::atomic<int> localDone{0};
+    std::atomic<int> pinned{0};
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::mutex statsMutex;
+
+    auto shardLoop = [&](int s) {
+        if (pinToCore(static_cast<int>(s % cores))) pinned.fetch_add(1);
+        Shard& shard = *shards[s];
+        std::vector<ShardMessage> batch;
+        for (int t = 0; t < T; ++t) {
+            shard.startSlot();
+            barrier.arriveAndWait();
+            for (int request : routed[t][s]) {
+                shard.schedule(request, fleet.positions[t][request], inboxes, inFlight);
+                inboxes[s]->takeAll(batch); // Serve handoffs between local requests to keep queues short
+                for (const auto& message : batch) shard.handle(message, t, inboxes, inFlight);
+                batch.clear();
+            }
+            localDone.fetch_add(1, std::memory_order_acq_rel);
+            // Keep serving cross-shard messages until every shard is done and none are in flight
+            while (localDone.load(std::memory_order_acquire) < numShards || inFlight.load(std::memory_order_acquire) > 0) {
+                inboxes[s]->takeAll(batch);
+                if (batch.empty()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (const auto& message : batch) shard.handle(message, t, inboxes, inFlight);
+                batch.clear();
+            }
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                SlotStats& slot = result.slots[t];
+                slot.placed += shard.stats.placed;
+                slot.dropped += shard.stats.dropped;
+                slot.handoffs += shard.stats.handoffs;
+                slot.placedRemotely += shard.stats.placedRemotely;
+                slot.totalCost += shard.stats.totalCost;
+            }
+            barrier.arriveAndWait();
+            if (s == 0) localDone.store(0, std::memory_order_release);
+            barrier.arriveAndWait();
+        }
+    };
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int s = 0; s < numShards; ++s) threads.emplace_back(shardLoop, s);
+    for (auto& thread : threads) thread.join();
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.pinned = pinned.load();
+    return result;
+}
+
+// Single-threaded reference over the global RSU vector: cheapest RSU in reach that fits
+RunResult runGlobal(const Fleet& fleet, int T) {
+    std::vector<RSU> rsus = fleet.rsus;
+    std::vector<double> weights = computeDynamicWeights(0.0);
+    std::vector<int> candidates;
+    RunResult result;
+    auto start = Clock::now();
+    for (int t = 0; t < T; ++t) {
+        weights = computeDynamicWeights(computeSystemLoad(rsus));
+        for (auto& rsu : rsus) rsu.usedCapacity = 0.0;
+        SlotStats& slot = result.slots.emplace_back();
+        for (size_t r = 0; r < fleet.requests.size(); ++r) {
+            const ServiceRequest& request = fleet.requests[r];
+            candidatesInReach(fleet.positions[t][r], fleet.map, fleet.locations, candidates);
+            double bestCost = std::numeric_limits<double>::max();
+            int best = -1;
+            for (int rsu : candidates) {
+                if (rsus[rsu].usedCapacity + request.computationLoad > rsus[rsu].maxCapacity) continue;
+                double cost = computePlacementCost(request, rsus[rsu], weights);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = rsu;
+                }
+            }
+            if (best >= 0) {
+                rsus[best].usedCapacity += request.computationLoad;
+                slot.placed++;
+                slot.totalCost += bestCost;
+            } else {
+                slot.dropped++;
+            }
+        }
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+int main() {
+    const int gridSide = 40;       // 40 x 40 RSUs
+    const int numRequests = 200000;
+    const int T = 5;               // Number of time slots
+
+    Fleet fleet;
+    std::vector<PrefetchedService> services;
+    generateScenario(gridSide * gridSide, numRequests, 1, 41, fleet.rsus, fleet.requests, services, 1.2);
+    fleet.locations = generateRSUGrid(fleet.rsus, RSU_SPACING, REACH);
+    std::mt19937 gen(43);
+    std::uniform_real_distribution<> coordinate(0.0, gridSide * RSU_SPACING);
+    fleet.positions.assign(T, std::vector<Vehicle>(numRequests));
+    for (auto& slot : fleet.positions) {
+        for (auto& vehicle : slot) vehicle = {coordinate(gen), coordinate(gen)};
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    fleet.map = {gridSide, gridSide, 1, 1};
+    RunResult global = runGlobal(fleet, T);
+    double globalCost = 0.0;
+    int globalPlaced = 0;
+    for (const auto& slot : global.slots) {
+        globalCost += slot.totalCost;
+        globalPlaced += slot.placed;
+    }
+    std::cout << "Global single-threaded: " << numRequests * T / global.seconds / 1e6 << " M requests/sec, Placed = "
+              << globalPlaced << ", Total Cost = " << globalCost << "\n" << std::endl;
+
+    std::cout << "Hardware threads = " << std::thread::hardware_concurrency() << std::endl;
+    for (auto [sx, sy] : {std::pair<int, int>{1, 1}, {2, 1}, {2, 2}, {4, 2}, {4, 4}}) {
+        fleet.map = {gridSide, gridSide, sx, sy};
+        RunResult sharded = runSharded(fleet, T);
+        SlotStats total;
+        for (const auto& slot : sharded.slots) {
+            total.placed += slot.placed;
+            total.dropped += slot.dropped;
+            total.handoffs += slot.handoffs;
+            total.placedRemotely += slot.placedRemotely;
+            total.totalCost += slot.totalCost;
+        }
+        std::cout << "Shards = " << sx * sy << " (" << sx << "x" << sy << ", pinned " << sharded.pinned << "): "
+                  << numRequests * T / sharded.seconds / 1e6 << " M requests/sec, Placed = " << total.placed
+                  << ", Dropped = " << total.dropped << ", Handoffs = " << total.handoffs
+                  << " (accepted " << total.placedRemotely << "), Cost vs Global = " << total.totalCost / globalCost << std::endl;
+    }
+    return 0;
+}
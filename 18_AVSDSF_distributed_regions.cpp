@@ -0,0 +1,763 @@
+/*
+AVSDSF - Multi-process distributed simulation of city regions over shared memory / UNIX / TCP transports
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include "avsdsf_model.h"
+
+const int GRID_SIDE = 32;               // RSUs per side of the city grid
+const double RSU_SPACING = 500.0;       // Metres between neighbouring RSUs
+const double REACH = 800.0;             // Vehicles can be served by RSUs within this distance
+const int REACH_CELLS = 2;              // Grid rows/columns scanned around the vehicle
+const int NUM_VEHICLES = 100000;
+const double REQUEST_PROBABILITY = 0.5; // Chance that a vehicle issues a request in a slot
+const double SLOT_SECONDS = 10.0;       // Simulated time per slot (vehicles move between slots)
+const int NUM_SLOTS = 10;
+const size_t SHM_RING_CAPACITY = 8192;  // Messages per directed shared-memory ring (power of two)
+const int CONNECT_TIMEOUT_MS = 5000;
+
+// ---------------------------------------------------------------------------
+// Wire format: fixed-size frames, identical on every transport
+// ---------------------------------------------------------------------------
+
+enum MessageType : int32_t {
+    VehicleHandoff = 1, // Vehicle crossed into the receiver's region; owned there from `slot`
+    CrossRequest = 2,   // Request whose cheapest RSU lies in the receiver's region
+    Declined = 3,       // Receiver of a CrossRequest had no cheaper RSU with capacity
+    EndOfPhase = 4      // Sender has sent everything for (slot, phase)
+};
+
+struct WireMessage {
+    int32_t type;
+    int32_t slot;
+    int32_t phase;
+    int32_t source;
+    int32_t vehicle;
+    int32_t padding;
+    double x, y;      // Vehicle position
+    double vx, vy;    // Vehicle velocity (handoff only)
+    double localCost; // Origin's best local cost (cross requests)
+};
+
+static_assert(sizeof(WireMessage) == 64, "WireMessage is one cache line on the wire");
+
+// ---------------------------------------------------------------------------
+// Transport abstraction
+// ---------------------------------------------------------------------------
+
+// Reliable FIFO channel per pair of regions. Arrived frames are buffered in
+// `received` so a sender that finds a channel full can keep draining its own
+// inbound channels, which rules out send/send deadlocks between regions.
+class Transport {
+protected:
+    std::deque<WireMessage> received;
+    virtual void pump() = 0; // Move arrived frames into `received` without blocking
+
+public:
+    long long messagesSent = 0;
+
+    virtual ~Transport() = default;
+    virtual void send(int peer, const WireMessage& message) = 0;
+    virtual void flush() {}   // Push buffered frames out (called at phase ends)
+    virtual void idle() = 0;  // Wait briefly for traffic
+
+    bool poll(WireMessage& message) {
+        if (received.empty()) pump();
+        if (received.empty()) return false;
+        message = received.front();
+        received.pop_front();
+        return true;
+    }
+};
+
+// Single-producer single-consumer ring living in a shared mapping
+struct ShmRing {
+    alignas(64) std::atomic<uint64_t> head; // Next frame to read (consumer)
+    alignas(64) std::atomic<uint64_t> tail; // Next frame to write (producer)
+    alignas(64) WireMessage frames[SHM_RING_CAPACITY];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring counters must be lock-free to live in shared memory");
+
+// One ring per directed pair of regions in a MAP_SHARED mapping created before fork
+class SharedMemoryTransport : public Transport {
+private:
+    ShmRing* rings;
+    int rank;
+    int ranks;
+
+    ShmRing& ring(int from, int to) { return rings[from * ranks + to]; }
+
+protected:
+    void pump() override {
+        for (int peer = 0; peer < ranks; ++peer) {
+            if (peer == rank) continue;
+            ShmRing& in = ring(peer, rank);
+            uint64_t head = in.head.load(std::memory_order_relaxed);
+            uint64_t tail = in.tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) received.push_back(in.frames[head & (SHM_RING_CAPACITY - 1)]);
+            in.head.store(head, std::memory_order_release);
+        }
+    }
+
+public:
+    static ShmRing* createMapping(int ranks) {
+        size_t bytes = sizeof(ShmRing) * ranks * ranks;
+        void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return nullptr;
+        ShmRing* rings = static_cast<ShmRing*>(memory);
+        for (int i = 0; i < ranks * ranks; ++i) {
+            new (&rings[i].head) std::atomic<uint64_t>(0);
+            new (&rings[i].tail) std::atomic<uint64_t>(0);
+        }
+        return rings;
+    }
+    static void destroyMapping(ShmRing* rings, int ranks) { munmap(rings, sizeof(ShmRing) * ranks * ranks); }
+
+    SharedMemoryTransport(ShmRing* mapping, int myRank, int numRanks) : rings(mapping), rank(myRank), ranks(numRanks) {}
+
+    void send(int peer, const WireMessage& message) override {
+        ShmRing& out = ring(rank, peer);
+        uint64_t tail = out.tail.load(std::memory_order_relaxed);
+        while (tail - out.head.load(std::memory_order_acquire) >= SHM_RING_CAPACITY) {
+            pump(); // Full: keep our own inbound rings moving while the peer catches up
+            std::this_thread::yield();
+        }
+        out.frames[tail & (SHM_RING_CAPACITY - 1)] = message;
+        out.tail.store(tail + 1, std::memory_order_release);
+        messagesSent++;
+    }
+
+    void idle() override { std::this_thread::yield(); }
+};
+
+// Full mesh of stream sockets (UNIX domain or TCP). Outgoing frames are
+// buffered per peer and written at flush(); writes never block, and reads are
+// drained while a write is pending.
+class SocketTransport : public Transport {
+public:
+    enum class Kind { Unix, Tcp };
+
+private:
+    int rank;
+    int ranks;
+    std::vector<int> fds;               // Peer -> connected socket (-1 for self)
+    std::vector<std::string> outgoing;  // Peer -> unsent bytes
+    std::vector<std::string> incoming;  // Peer -> partial frame bytes
+    int listener = -1;
+
+    static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+    static std::string unixPath(const std::string& prefix, int rank) { return prefix + "_" + std::to_string(rank) + ".sock"; }
+
+    int listenOn(Kind kind, const std::string& endpoint, int basePort) {
+        int fd = -1;
+        if (kind == Kind::Unix) {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::string path = unixPath(endpoint, rank);
+            unlink(path.c_str());
+            std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return -1;
+        } else {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            int yes = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+            address.sin_port = htons(static_cast<uint16_t>(basePort + rank));
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return -1;
+        }
+        if (listen(fd, ranks) != 0) return -1;
+        return fd;
+    }
+
+    int connectTo(Kind kind, const std::string& endpoint, const std::vector<std::string>& hosts, int basePort, int peer) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CONNECT_TIMEOUT_MS);
+        while (std::chrono::steady_clock::now() < deadline) {
+            int fd = -1;
+            int result = -1;
+            if (kind == Kind::Unix) {
+                fd = socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un address{};
+                address.sun_family = AF_UNIX;
+                std::strncpy(address.sun_path, unixPath(endpoint, peer).c_str(), sizeof(address.sun_path) - 1);
+                result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+            } else {
+                fd = socket(AF_INET, SOCK_STREAM, 0);
+                addrinfo hints{}, *info = nullptr;
+                hints.ai_family = AF_INET;
+                hints.ai_socktype = SOCK_STREAM;
+                std::string port = std::to_string(basePort + peer);
+                if (getaddrinfo(hosts[peer].c_str(), port.c_str(), &hints, &info) == 0) {
+                    result = connect(fd, info->ai_addr, info->ai_addrlen);
+                    freeaddrinfo(info);
+                }
+            }
+            if (result == 0) return fd;
+            close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Peer not listening yet
+        }
+        return -1;
+    }
+
+    void readAvailable(int peer) {
+        char buffer[1 << 16];
+        for (;;) {
+            ssize_t n = recv(fds[peer], buffer, sizeof(buffer), 0);
+            if (n <= 0) break; // EAGAIN, or peer closed after its last slot
+            incoming[peer].append(buffer, static_cast<size_t>(n));
+        }
+        size_t whole = incoming[peer].size() / sizeof(WireMessage) * sizeof(WireMessage);
+        for (size_t offset = 0; offset < whole; offset += sizeof(WireMessage)) {
+            WireMessage message;
+            std::memcpy(&message, incoming[peer].data() + offset, sizeof(message));
+            received.push_back(message);
+        }
+        incoming[peer].erase(0, whole);
+    }
+
+protected:
+    void pump() override {
+        for (int peer = 0; peer < ranks; ++peer) {
+            if (peer != rank) readAvailable(peer);
+        }
+    }
+
+public:
+    bool connected = false;
+
+    // Ranks connect to every lower rank and accept from every higher one
+    SocketTransport(Kind kind, int myRank, int numRanks, const std::string& endpoint,
+                    const std::vector<std::string>& hosts, int basePort)
+        : rank(myRank), ranks(numRanks), fds(numRanks, -1), outgoing(numRanks), incoming(numRanks) {
+        listener = listenOn(kind, endpoint, basePort);
+        if (listener < 0) return;
+        for (int peer = 0; peer < rank; ++peer) {
+            int fd = connectTo(kind, endpoint, hosts, basePort, peer);
+            if (fd < 0) return;
+            int32_t hello = rank;
+            if (write(fd, &hello, sizeof(hello)) != sizeof(hello)) return;
+            fds[peer] = fd;
+        }
+        for (int accepted = 0; accepted < ranks - 1 - rank; ++accepted) {
+            int fd = accept(listener, nullptr, nullptr);
+            int32_t hello = -1;
+            if (fd < 0 || read(fd, &hello, sizeof(hello)) != sizeof(hello) || hello <= rank || hello >= ranks) return;
+            fds[hello] = fd;
+        }
+        for (int peer = 0; peer < ranks; ++peer) {
+            if (peer == rank) continue;
+            setNonBlocking(fds[peer]);
+            if (kind == Kind::Tcp) {
+                int yes = 1;
+                setsockopt(fds[peer], IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            }
+        }
+        connected = true;
+    }
+
+    ~SocketTransport() override {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+        if (listener >= 0) close(listener);
+    }
+
+    void send(int peer, const WireMessage& message) override {
+        outgoing[peer].append(reinterpret_cast<const char*>(&message), sizeof(message));
+        messagesSent++;
+    }
+
+    void flush() override {
+        for (int peer = 0; peer < ranks; ++peer) {
+            std::string& pending = outgoing[peer];
+            size_t written = 0;
+            while (written < pending.size()) {
+                ssize_t n = ::send(fds[peer], pending.data() + written, pending.size() - written, MSG_NOSIGNAL);
+                if (n > 0) {
+                    written += static_cast<size_t>(n);
+                } else if (n < 0 && errno == EINTR) {
+                    continue;
+                } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    pump(); // Peer's buffer is full: drain ours so it can make progress too
+                    pollfd waitFor{fds[peer], POLLOUT, 0};
+                    ::poll(&waitFor, 1, 1);
+                } else {
+                    // The peer would wait for these frames forever: fail the run instead of dropping them
+                    std::cerr << "Rank " << rank << ": send to rank " << peer << " failed: "
+                              << (n < 0 ? std::strerror(errno) : "connection closed") << std::endl;
+                    _exit(4);
+                }
+            }
+            pending.clear();
+        }
+    }
+
+    void idle() override {
+        std::vector<pollfd> waitFor;
+        for (int peer = 0; peer < ranks; ++peer) {
+            if (peer != rank) waitFor.push_back({fds[peer], POLLIN, 0});
+        }
+        ::poll(waitFor.data(), waitFor.size(), 1);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Region simulation
+// ---------------------------------------------------------------------------
+
+// Deterministic per-(vehicle, slot) randomness, independent of the partition
+struct StreamRng {
+    uint64_t state;
+    StreamRng(uint64_t a, uint64_t b) : state(a * 0x9E3779B97F4A7C15ULL ^ (b + 0x632BE59BD9B4E019ULL)) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    double uniform(double low, double high) { return low + (high - low) * (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+struct VehicleState {
+    int id;
+    double x, y, vx, vy;
+};
+
+// Request issued by a vehicle in a slot (ranges follow generateScenario)
+bool requestOf(int vehicle, int slot, ServiceRequest& request) {
+    StreamRng rng(static_cast<uint64_t>(vehicle) + 1, static_cast<uint64_t>(slot) + 1);
+    if (rng.uniform(0.0, 1.0) >= REQUEST_PROBABILITY) return false;
+    request = {vehicle, rng.uniform(2.0, 5.0), rng.uniform(12.0, 35.0), rng.uniform(0.008, 0.035),
+               rng.uniform(0.008, 0.035), rng.uniform(5.0, 15.0), rng.uniform(90.0, 130.0)};
+    return true;
+}
+
+struct SlotStats {
+    long long requests = 0;
+    long long placed = 0;
+    long long dropped = 0;
+    long long crossRequests = 0;
+    long long crossAccepted = 0;
+    long long vehicleHandoffs = 0;
+    double totalCost = 0.0;
+};
+
+struct RegionReport {
+    SlotStats slots[NUM_SLOTS];
+    long long messagesSent = 0;
+};
+static_assert(sizeof(RegionReport) <= PIPE_BUF, "a rank's report must fit in its pipe so the rank can exit before it is read");
+
+// One region: the RSU columns [firstColumn, lastColumn) and the vehicles inside them
+class Region {
+private:
+    int rank;
+    int ranks;
+    Transport& transport;
+    std::vector<RSU> rsus;
+    std::vector<RSULocation> locations;
+    std::vector<double> weights;
+    std::vector<VehicleState> vehicles;
+    std::vector<int> candidates;
+
+    // Frames that arrived ahead of the phase that consumes them
+    std::vector<WireMessage> handoffs, crossRequests, declines;
+    std::map<std::pair<int, int>, int> endMarkers; // (slot, phase) -> peers that finished it
+
+    int columnOf(double x) const { return std::clamp(static_cast<int>(x / RSU_SPACING), 0, GRID_SIDE - 1); }
+    int regionOfColumn(int column) const { return column * ranks / GRID_SIDE; }
+    int regionOf(double x) const { return regionOfColumn(columnOf(x)); }
+
+    void inReach(double x, double y) {
+        candidates.clear();
+        int cx = columnOf(x), cy = std::clamp(static_cast<int>(y / RSU_SPACING), 0, GRID_SIDE - 1);
+        for (int row = std::max(0, cy - REACH_CELLS); row <= std::min(GRID_SIDE - 1, cy + REACH_CELLS); ++row) {
+            for (int column = std::max(0, cx - REACH_CELLS); column <= std::min(GRID_SIDE - 1, cx + REACH_CELLS); ++column) {
+                int rsu = row * GRID_SIDE + column;
+                if (std::hypot(locations[rsu].x - x, locations[rsu].y - y) <= REACH) candidates.push_back(rsu);
+            }
+        }
+    }
+
+    int bestLocal(const ServiceRequest& request, double x, double y, double& bestCost) {
+        inReach(x, y);
+        bestCost = std::numeric_limits<double>::max();
+        int best = -1;
+        for (int rsu : candidates) {
+            if (regionOfColumn(rsu % GRID_SIDE) != rank) continue;
+            if (rsus[rsu].usedCapacity + request.computationLoad > rsus[rsu].maxCapacity) continue;
+            double cost = computePlacementCost(request, rsus[rsu], weights);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = rsu;
+            }
+        }
+        return best;
+    }
+
+    void place(const ServiceRequest& request, int rsu, double cost, SlotStats& stats) {
+        rsus[rsu].usedCapacity += request.computationLoad;
+        stats.placed++;
+        stats.totalCost += cost;
+    }
+
+    void broadcastEnd(int slot, int phase) {
+        for (int peer = 0; peer < ranks; ++peer) {
+            if (peer != rank) transport.send(peer, {EndOfPhase, slot, phase, rank, -1, 0, 0, 0, 0, 0, 0});
+        }
+        transport.flush();
+    }
+
+    // Conservative synchronisation: block until every peer has finished (slot, phase).
+    // Channels are FIFO, so everything a peer sent for that phase has arrived by then.
+    void awaitPhase(int slot, int phase) {
+        WireMessage message;
+        while (endMarkers[{slot, phase}] < ranks - 1) {
+            if (!transport.poll(message)) {
+                transport.idle();
+                continue;
+            }
+            switch (message.type) {
+            case VehicleHandoff: handoffs.push_back(message); break;
+            case CrossRequest: crossRequests.push_back(message); break;
+            case Declined: declines.push_back(message); break;
+            case EndOfPhase: endMarkers[{message.slot, message.phase}]++; break;
+            default: break;
+            }
+        }
+        endMarkers.erase({slot, phase});
+    }
+
+    // Move frames for `slot` out of a buffer, in an order that does not depend on arrival timing
+    static std::vector<WireMessage> takeForSlot(std::vector<WireMessage>& buffer, int slot) {
+        std::vector<WireMessage> taken;
+        auto split = std::stable_partition(buffer.begin(), buffer.end(), [&](const WireMessage& m) { return m.slot != slot; });
+        taken.assign(split, buffer.end());
+        buffer.erase(split, buffer.end());
+        std::sort(taken.begin(), taken.end(), [](const WireMessage& a, const WireMessage& b) {
+            return a.source != b.source ? a.source < b.source : a.vehicle < b.vehicle;
+        });
+        return taken;
+    }
+
+public:
+    Region(int myRank, int numRanks, Transport& t) : rank(myRank), ranks(numRanks), transport(t) {
+        std::vector<ServiceRequest> unused;
+        std::vector<PrefetchedService> services;
+        int expectedRequests = static_cast<int>(NUM_VEHICLES * REQUEST_PROBABILITY);
+        generateScenario(GRID_SIDE * GRID_SIDE, expectedRequests, 1, 47, rsus, unused, services, 1.2);
+        locations = generateRSUGrid(rsus, RSU_SPACING, REACH);
+        weights = computeDynamicWeights(0.0);
+        double side = GRID_SIDE * RSU_SPACING;
+        for (int v = 0; v < NUM_VEHICLES; ++v) {
+            StreamRng rng(static_cast<uint64_t>(v) + 1, 0);
+            VehicleState vehicle{v, rng.uniform(0.0, side), rng.uniform(0.0, side), rng.uniform(-15.0, 15.0), rng.uniform(-15.0, 15.0)};
+            if (regionOf(vehicle.x) == rank) vehicles.push_back(vehicle);
+        }
+    }
+
+    void runSlot(int slot, SlotStats& stats) {
+        // Vehicles handed over at the end of the previous slot join now
+        for (const auto& message : takeForSlot(handoffs, slot)) {
+            vehicles.push_back({message.vehicle, message.x, message.y, message.vx, message.vy});
+        }
+        std::sort(vehicles.begin(), vehicles.end(), [](const VehicleState& a, const VehicleState& b) { return a.id < b.id; });
+
+        double used = 0.0, total = 0.0;
+        for (auto& rsu : rsus) {
+            if (regionOfColumn(rsu.id % GRID_SIDE) != rank) continue;
+            used += rsu.usedCapacity;
+            total += rsu.maxCapacity;
+            rsu.usedCapacity = 0.0;
+        }
+        weights = computeDynamicWeights(total > 0.0 ? used / total : 0.0);
+
+        // Phase 0: local requests; cross-region requests and border crossings go out
+        for (const auto& vehicle : vehicles) {
+            ServiceRequest request;
+            if (!requestOf(vehicle.id, slot, request)) continue;
+            stats.requests++;
+            double localCost;
+            int local = bestLocal(request, vehicle.x, vehicle.y, localCost);
+            double foreignCost = std::numeric_limits<double>::max();
+            int foreign = -1;
+            for (int rsu : candidates) {
+                if (regionOfColumn(rsu % GRID_SIDE) == rank) continue;
+                double cost = computePlacementCost(request, rsus[rsu], weights);
+                if (cost < foreignCost) {
+                    foreignCost = cost;
+                    foreign = rsu;
+                }
+            }
+            if (foreign >= 0 && foreignCost < localCost) {
+                stats.crossRequests++;
+                transport.send(regionOfColumn(foreign % GRID_SIDE), {CrossRequest, slot, 0, rank, vehicle.id, 0, vehicle.x, vehicle.y, 0, 0, localCost});
+            } else if (local >= 0) {
+                place(request, local, localCost, stats);
+            } else {
+                stats.dropped++;
+            }
+        }
+        double side = GRID_SIDE * RSU_SPACING;
+        std::vector<VehicleState> staying;
+        for (auto vehicle : vehicles) {
+            vehicle.x += vehicle.vx * SLOT_SECONDS;
+            vehicle.y += vehicle.vy * SLOT_SECONDS;
+            if (vehicle.x < 0.0 || vehicle.x > side) vehicle.vx = -vehicle.vx, vehicle.x = std::clamp(vehicle.x, 0.0, side);
+            if (vehicle.y < 0.0 || vehicle.y > side) vehicle.vy = -vehicle.vy, vehicle.y = std::clamp(vehicle.y, 0.0, side);
+            int owner = regionOf(vehicle.x);
+            if (owner == rank) {
+                staying.push_back(vehicle);
+            } else {
+                stats.vehicleHandoffs++;
+                transport.send(owner, {VehicleHandoff, slot + 1, 0, rank, vehicle.id, 0, vehicle.x, vehicle.y, vehicle.vx, vehicle.vy, 0});
+            }
+        }
+        vehicles.swap(staying);
+        broadcastEnd(slot, 0);
+        awaitPhase(slot, 0);
+
+        // Phase 1: requests handed to us by neighbouring regions
+        for (const auto& message : takeForSlot(crossRequests, slot)) {
+            ServiceRequest request;
+            requestOf(message.vehicle, slot, request);
+            double cost;
+            int rsu = bestLocal(request, message.x, message.y, cost);
+            if (rsu >= 0 && cost < message.localCost) {
+                place(request, rsu, cost, stats);
+                stats.crossAccepted++;
+            } else {
+                transport.send(message.source, {Declined, slot, 1, rank, message.vehicle, 0, message.x, message.y, 0, 0, message.localCost});
+            }
+        }
+        broadcastEnd(slot, 1);
+        awaitPhase(slot, 1);
+
+        // Phase 2: our declined requests fall back to the best local RSU
+        for (const auto& message : takeForSlot(declines, slot)) {
+            ServiceRequest request;
+            requestOf(message.vehicle, slot, request);
+            double cost;
+            int rsu = bestLocal(request, message.x, message.y, cost);
+            if (rsu >= 0) {
+                place(request, rsu, cost, stats);
+            } else {
+                stats.dropped++;
+            }
+        }
+    }
+};
+
+RegionReport runRegion(int rank, int ranks, Transport& transport) {
+    RegionReport report;
+    Region region(rank, ranks, transport);
+    for (int t = 0; t < NUM_SLOTS; ++t) region.runSlot(t, report.slots[t]);
+    report.messagesSent = transport.messagesSent;
+    return report;
+}
+
+// ---------------------------------------------------------------------------
+// Local multi-process launcher
+// ---------------------------------------------------------------------------
+
+enum class TransportKind { SharedMemory, Unix, Tcp };
+
+const char* transportName(TransportKind kind) {
+    switch (kind) {
+    case TransportKind::SharedMemory: return "shared memory";
+    case TransportKind::Unix: return "UNIX sockets";
+    default: return "TCP loopback";
+    }
+}
+
+// Fork one process per region; each reports its per-slot stats back over a pipe
+bool runLocal(TransportKind kind, int ranks, std::vector<SlotStats>& totals, long long& messages, double& seconds) {
+    ShmRing* rings = nullptr;
+    if (kind == TransportKind::SharedMemory) {
+        rings = SharedMemoryTransport::createMapping(ranks);
+        if (!rings) return false;
+    }
+    std::string endpoint = "/tmp/avsdsf_" + std::to_string(getpid());
+    int basePort = 20000 + getpid() % 20000;
+    std::vector<std::string> hosts(ranks, "127.0.0.1");
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<pid_t> children;
+    std::vector<int> pipes;
+    for (int rank = 0; rank < ranks; ++rank) {
+        int channel[2];
+        if (pipe(channel) != 0) return false;
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(channel[0]);
+            std::unique_ptr<Transport> transport;
+            if (kind == TransportKind::SharedMemory) {
+                transport = std::make_unique<SharedMemoryTransport>(rings, rank, ranks);
+            } else {
+                auto sockets = std::make_unique<SocketTransport>(kind == TransportKind::Unix ? SocketTransport::Kind::Unix : SocketTransport::Kind::Tcp,
+                                                                 rank, ranks, endpoint, hosts, basePort);
+                if (!sockets->connected) _exit(2);
+                transport = std::move(sockets);
+            }
+            RegionReport report = runRegion(rank, ranks, *transport);
+            ssize_t written = write(channel[1], &report, sizeof(report));
+            transport.reset();
+            if (kind == TransportKind::Unix) unlink((endpoint + "_" + std::to_string(rank) + ".sock").c_str());
+            _exit(written == static_cast<ssize_t>(sizeof(report)) ? 0 : 3);
+        }
+        close(channel[1]);
+        children.push_back(pid);
+        pipes.push_back(channel[0]);
+    }
+
+    // Reap the ranks first: a failed rank leaves its peers waiting in a phase
+    // barrier, so the others are stopped. Reports are smaller than PIPE_BUF and
+    // stay readable in the pipes after the writers exit.
+    bool ok = true;
+    for (size_t remaining = children.size(); remaining > 0; --remaining) {
+        int status = 0;
+        if (waitpid(-1, &status, 0) < 0) break;
+        if (ok && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+            ok = false;
+            for (pid_t child : children) kill(child, SIGKILL);
+        }
+    }
+
+    totals.assign(NUM_SLOTS, SlotStats());
+    messages = 0;
+    for (int rank = 0; rank < ranks; ++rank) {
+        RegionReport report;
+        size_t got = 0;
+        while (got < sizeof(report)) {
+            ssize_t n = read(pipes[rank], reinterpret_cast<char*>(&report) + got, sizeof(report) - got);
+            if (n <= 0) break;
+            got += static_cast<size_t>(n);
+        }
+        close(pipes[rank]);
+        if (got != sizeof(report)) {
+            ok = false;
+            continue;
+        }
+        messages += report.messagesSent;
+        for (int t = 0; t < NUM_SLOTS; ++t) {
+            SlotStats& total = totals[t];
+            const SlotStats& slot = report.slots[t];
+            total.requests += slot.requests;
+            total.placed += slot.placed;
+            total.dropped += slot.dropped;
+            total.crossRequests += slot.crossRequests;
+            total.crossAccepted += slot.crossAccepted;
+            total.vehicleHandoffs += slot.vehicleHandoffs;
+            total.totalCost += slot.totalCost;
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    if (rings) SharedMemoryTransport::destroyMapping(rings, ranks);
+    return ok;
+}
+
+bool sameResults(const std::vector<SlotStats>& a, const std::vector<SlotStats>& b) {
+    for (int t = 0; t < NUM_SLOTS; ++t) {
+        if (a[t].placed != b[t].placed || a[t].dropped != b[t].dropped || a[t].crossRequests != b[t].crossRequests ||
+            a[t].crossAccepted != b[t].crossAccepted || a[t].totalCost != b[t].totalCost) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Worker mode for several machines: <prog> worker <rank> <ranks> <host0,host1,...> <basePort>
+    if (argc == 6 && std::string(argv[1]) == "worker") {
+        int rank = std::atoi(argv[2]), ranks = std::atoi(argv[3]);
+        std::vector<std::string> hosts;
+        std::string list = argv[4];
+        for (size_t start = 0, comma; start <= list.size(); start = comma + 1) {
+            comma = list.find(',', start);
+            if (comma == std::string::npos) comma = list.size();
+            hosts.push_back(list.substr(start, comma - start));
+        }
+        if (rank < 0 || rank >= ranks || static_cast<int>(hosts.size()) != ranks) {
+            std::cerr << "Expected one host per rank" << std::endl;
+            return 1;
+        }
+        SocketTransport transport(SocketTransport::Kind::Tcp, rank, ranks, "", hosts, std::atoi(argv[5]));
+        if (!transport.connected) {
+            std::cerr << "Could not connect the region mesh" << std::endl;
+            return 1;
+        }
+        RegionReport report = runRegion(rank, ranks, transport);
+        for (int t = 0; t < NUM_SLOTS; ++t) {
+            const SlotStats& slot = report.slots[t];
+            std::cout << "Region " << rank << ", Time Slot " << t << ": Requests = " << slot.requests << ", Placed = " << slot.placed
+                      << ", Dropped = " << slot.dropped << ", Cross Requests = " << slot.crossRequests
+                      << ", Total Cost = " << slot.totalCost << std::endl;
+        }
+        return 0;
+    }
+
+    const int ranks = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Regions = " << ranks << " processes, RSUs = " << GRID_SIDE * GRID_SIDE << ", Vehicles = " << NUM_VEHICLES << "\n" << std::endl;
+
+    std::vector<SlotStats> reference;
+    bool allIdentical = true;
+    for (TransportKind kind : {TransportKind::SharedMemory, TransportKind::Unix, TransportKind::Tcp}) {
+        std::vector<SlotStats> totals;
+        long long messages = 0;
+        double seconds = 0.0;
+        if (!runLocal(kind, ranks, totals, messages, seconds)) {
+            std::cout << transportName(kind) << ": run failed" << std::endl;
+            allIdentical = false;
+            continue;
+        }
+        if (reference.empty()) {
+            reference = totals;
+            for (int t = 0; t < NUM_SLOTS; ++t) {
+                const SlotStats& slot = totals[t];
+                std::cout << "Time Slot " << t << ": Requests = " << slot.requests << ", Placed = " << slot.placed
+                          << ", Dropped = " << slot.dropped << ", Cross Requests = " << slot.crossRequests
+                          << " (accepted " << slot.crossAccepted << "), Vehicle Handoffs = " << slot.vehicleHandoffs
+                          << ", Total Cost = " << slot.totalCost << std::endl;
+            }
+            std::cout << std::endl;
+        }
+        bool identical = sameResults(reference, totals);
+        allIdentical = allIdentical && identical;
+        std::cout << std::setw(14) << std::left << transportName(kind) << std::right << ": " << seconds * 1000.0 / NUM_SLOTS
+                  << " ms/slot, " << messages << " messages, results " << (identical ? "identical" : "DIFFER") << std::endl;
+    }
+    return allIdentical ? 0 : 1;
+}
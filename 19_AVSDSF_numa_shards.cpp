@@ -0,0 +1,349 @@
+/*
+AVSDSF - NUMA-aware placement of per-shard RSU/request state and scheduler threads
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+#include "avsdsf_model.h"
+
+const int RSUS_PER_SHARD = 200000;   // Sized well beyond the last-level cache
+const int REQUESTS_PER_SHARD = 4000;
+const int SCAN_WINDOW = 2048;        // Consecutive RSUs evaluated per request
+const int PASSES = 3;                // Scheduling passes over the shard per run
+
+using Clock = std::chrono::high_resolution_clock;
+
+// NUMA nodes and their CPUs from /sys; a single node with every CPU otherwise
+struct NumaTopology {
+    std::vector<std::vector<int>> nodeCpus;
+    std::vector<int> nodeIds; // Kernel node id of each nodeCpus entry (CPU-less nodes are skipped)
+    bool fromSys = false;
+
+    // Parses a kernel list such as "0-3,8-11" (CPUs or nodes)
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream stream(list);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            if (range.empty() || range == "\n") continue;
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    // Kernel ids of the online nodes, which need not be contiguous
+    static std::vector<int> onlineNodes() {
+        std::string online;
+        std::ifstream file("/sys/devices/system/node/online");
+        if (file) std::getline(file, online);
+        return parseCpuList(online);
+    }
+
+    static NumaTopology detect() {
+        NumaTopology topology;
+        for (int node : onlineNodes()) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file) continue;
+            std::string list;
+            std::getline(file, list);
+            std::vector<int> cpus = parseCpuList(list);
+            if (cpus.empty()) continue; // Memory-only node
+            topology.nodeCpus.push_back(cpus);
+            topology.nodeIds.push_back(node);
+        }
+        topology.fromSys = !topology.nodeCpus.empty();
+        if (!topology.fromSys) {
+            std::vector<int> all;
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) all.push_back(static_cast<int>(cpu));
+            topology.nodeCpus.push_back(all);
+            topology.nodeIds.push_back(0);
+        }
+        return topology;
+    }
+};
+
+bool pinToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Fraction of the pages of [base, base + bytes) resident on `node`, via
+// move_pages(2) in query mode. Returns -1 where the call is unavailable.
+double pagesOnNode(const void* base, size_t bytes, int node) {
+#if defined(__linux__) && defined(SYS_move_pages)
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t first = reinterpret_cast<uintptr_t>(base) & ~(pageSize - 1);
+    uintptr_t last = reinterpret_cast<uintptr_t>(base) + bytes;
+    std::vector<void*> pages;
+    for (uintptr_t page = first; page < last; page += pageSize * 16) pages.push_back(reinterpret_cast<void*>(page)); // Sample every 16th page
+    std::vector<int> status(pages.size(), -1);
+    if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) return -1.0;
+    size_t onNode = 0, resident = 0;
+    for (int s : status) {
+        if (s < 0) continue;
+        resident++;
+        if (s == node) onNode++;
+    }
+    return resident ? static_cast<double>(onNode) / resident : -1.0;
+#else
+    (void)base;
+    (void)bytes;
+    (void)node;
+    return -1.0;
+#endif
+}
+
+// System-wide allocation counters from /sys/devices/system/node/node*/numastat
+struct NumaStat {
+    long long localNode = 0; // Pages allocated on the node of the allocating CPU
+    long long otherNode = 0; // Pages allocated there by a CPU of another node
+
+    static bool read(NumaStat& stat) {
+        stat = NumaStat();
+        bool any = false;
+        for (int node : NumaTopology::onlineNodes()) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/numastat");
+            if (!file) continue;
+            any = true;
+            std::string key;
+            long long value;
+            while (file >> key >> value) {
+                if (key == "local_node") stat.localNode += value;
+                if (key == "other_node") stat.otherNode += value;
+            }
+        }
+        return any;
+    }
+};
+
+// Array whose pages are reserved by mmap but not touched: the first thread to
+// construct the elements decides which node the pages land on.
+template <typename T>
+class FirstTouchArray {
+private:
+    T* items = nullptr;
+    size_t count = 0;
+    size_t bytes = 0;
+
+public:
+    FirstTouchArray() = default;
+    FirstTouchArray(const FirstTouchArray&) = delete;
+    FirstTouchArray& operator=(const FirstTouchArray&) = delete;
+    ~FirstTouchArray() {
+        if (items) munmap(items, bytes);
+    }
+
+    // Reserve address space only; throws std::bad_alloc like std::vector would
+    void reserve(size_t n) {
+        count = n;
+        bytes = std::max<size_t>(1, n * sizeof(T));
+        void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) throw std::bad_alloc();
+        items = static_cast<T*>(memory);
+    }
+
+    // Construct every element from the calling thread (the first touch)
+    template <typename F>
+    void construct(F&& make) {
+        for (size_t i = 0; i < count; ++i) new (&items[i]) T(make(i));
+    }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    size_t size() const { return count; }
+    const void* data() const { return items; }
+    size_t sizeBytes() const { return bytes; }
+};
+
+// Per-shard scheduler state, owned by one worker
+struct ShardState {
+    FirstTouchArray<RSU> rsus;
+    FirstTouchArray<ServiceRequest> requests;
+    FirstTouchArray<int> windowStart; // Request -> first RSU of its scan window
+    int node = 0;
+    int cpu = 0;
+};
+
+enum class PlacementPolicy {
+    MainThreadTouch, // Everything initialised by the main thread (what a plain std::vector does)
+    OwnerTouch       // Each worker initialises its own shard after binding to its node
+};
+
+struct RunResult {
+    double seconds = 0.0;
+    double placed = 0.0;
+    double localPages = -1.0; // Fraction of shard pages on the owning worker's node
+    int pinned = 0;
+};
+
+void initialiseShard(ShardState& shard, const std::vector<RSU>& rsuTemplate, const std::vector<ServiceRequest>& requestTemplate, int shardIndex) {
+    shard.rsus.construct([&](size_t i) {
+        RSU rsu = rsuTemplate[i % rsuTemplate.size()];
+        rsu.id = static_cast<int>(i);
+        return rsu;
+    });
+    shard.requests.construct([&](size_t i) { return requestTemplate[(i + shardIndex * 7919) % requestTemplate.size()]; });
+    shard.windowStart.construct([&](size_t i) {
+        return static_cast<int>((i * 2654435761u + shardIndex) % (RSUS_PER_SHARD - SCAN_WINDOW));
+    });
+}
+
+// RS-MAS placement of the shard's requests, each over its window of RSUs
+double scheduleShard(ShardState& shard) {
+    std::vector<double> weights = computeDynamicWeights(0.5);
+    double placed = 0.0;
+    for (int pass = 0; pass < PASSES; ++pass) {
+        for (size_t i = 0; i < shard.rsus.size(); ++i) shard.rsus[i].usedCapacity = 0.0;
+        for (size_t r = 0; r < shard.requests.size(); ++r) {
+            const ServiceRequest& request = shard.requests[r];
+            int start = shard.windowStart[r];
+            double minCost = std::numeric_limits<double>::max();
+            int best = -1;
+            for (int k = start; k < start + SCAN_WINDOW; ++k) {
+                const RSU& rsu = shard.rsus[k];
+                if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                    double cost = computePlacementCost(request, rsu, weights);
+                    if (cost < minCost) {
+                        minCost = cost;
+                        best = k;
+                    }
+                }
+            }
+            if (best >= 0) {
+                shard.rsus[best].usedCapacity += request.computationLoad;
+                placed += 1.0;
+            }
+        }
+    }
+    return placed;
+}
+
+RunResult run(PlacementPolicy policy, const NumaTopology& topology, int numWorkers,
+              const std::vector<RSU>& rsuTemplate, const std::vector<ServiceRequest>& requestTemplate) {
+    std::vector<ShardState> shards(numWorkers);
+    for (int w = 0; w < numWorkers; ++w) {
+        // Workers are spread round-robin over nodes, then over the CPUs of each node
+        int node = w % static_cast<int>(topology.nodeCpus.size());
+        const auto& cpus = topology.nodeCpus[node];
+        shards[w].node = topology.nodeIds[node];
+        shards[w].cpu = cpus[(w / topology.nodeCpus.size()) % cpus.size()];
+        shards[w].rsus.reserve(RSUS_PER_SHARD);
+        shards[w].requests.reserve(REQUESTS_PER_SHARD);
+        shards[w].windowStart.reserve(REQUESTS_PER_SHARD);
+    }
+    if (policy == PlacementPolicy::MainThreadTouch) {
+        for (int w = 0; w < numWorkers; ++w) initialiseShard(shards[w], rsuTemplate, requestTemplate, w);
+    }
+
+    RunResult result;
+    std::vector<double> placed(numWorkers, 0.0);
+    std::atomic<int> pinned{0};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<double> busySeconds(numWorkers, 0.0);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < numWorkers; ++w) {
+        workers.emplace_back([&, w] {
+            if (pinToCpu(shards[w].cpu)) pinned.fetch_add(1);
+            if (policy == PlacementPolicy::OwnerTouch) initialiseShard(shards[w], rsuTemplate, requestTemplate, w);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            auto start = Clock::now();
+            placed[w] = scheduleShard(shards[w]);
+            busySeconds[w] = std::chrono::duration<double>(Clock::now() - start).count();
+        });
+    }
+    while (ready.load() < numWorkers) std::this_thread::yield();
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) worker.join();
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.pinned = pinned.load();
+    for (double p : placed) result.placed += p;
+
+    double localSum = 0.0;
+    int measured = 0;
+    for (const auto& shard : shards) {
+        double fraction = pagesOnNode(shard.rsus.data(), shard.rsus.sizeBytes(), shard.node);
+        if (fraction >= 0.0) {
+            localSum += fraction;
+            measured++;
+        }
+    }
+    if (measured > 0) result.localPages = localSum / measured;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    NumaTopology topology = NumaTopology::detect();
+    int totalCpus = 0;
+    for (const auto& cpus : topology.nodeCpus) totalCpus += static_cast<int>(cpus.size());
+    int numWorkers = argc > 1 ? std::max(1, std::atoi(argv[1])) : std::max(2, totalCpus);
+
+    std::vector<RSU> rsuTemplate;
+    std::vector<ServiceRequest> requestTemplate;
+    std::vector<PrefetchedService> services;
+    generateScenario(4096, 4096, 1, 53, rsuTemplate, requestTemplate, services, 4.0);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "NUMA nodes = " << topology.nodeCpus.size() << (topology.fromSys ? " (from /sys)" : " (no /sys topology, single node assumed)")
+              << ", CPUs = " << totalCpus << ", workers = " << numWorkers << std::endl;
+    for (size_t node = 0; node < topology.nodeCpus.size(); ++node) {
+        std::cout << "  node " << topology.nodeIds[node] << ": " << topology.nodeCpus[node].size() << " CPUs" << std::endl;
+    }
+    std::cout << "Per-shard state = " << (RSUS_PER_SHARD * sizeof(RSU) + REQUESTS_PER_SHARD * (sizeof(ServiceRequest) + sizeof(int))) / (1024.0 * 1024.0)
+              << " MB\n" << std::endl;
+
+    for (PlacementPolicy policy : {PlacementPolicy::MainThreadTouch, PlacementPolicy::OwnerTouch}) {
+        NumaStat before, after;
+        bool haveStat = NumaStat::read(before);
+        RunResult result = run(policy, topology, numWorkers, rsuTemplate, requestTemplate);
+        haveStat = haveStat && NumaStat::read(after);
+
+        double evaluations = static_cast<double>(numWorkers) * PASSES * REQUESTS_PER_SHARD * SCAN_WINDOW;
+        std::cout << (policy == PlacementPolicy::MainThreadTouch ? "Main-thread first touch" : "Owner first touch      ")
+                  << ": " << evaluations / result.seconds / 1e6 << " M cost evaluations/sec, Placed = " << result.placed
+                  << ", pinned workers = " << result.pinned << "/" << numWorkers << std::endl;
+        if (result.localPages >= 0.0) {
+            std::cout << "    shard pages on the owner's node = " << result.localPages * 100.0 << "%" << std::endl;
+        } else {
+            std::cout << "    page placement unavailable (move_pages not permitted)" << std::endl;
+        }
+        if (haveStat) {
+            long long local = after.localNode - before.localNode, remote = after.otherNode - before.otherNode;
+            std::cout << "    numastat during run: local_node = " << local << ", other_node = " << remote
+                      << ", local ratio = " << (local + remote > 0 ? 100.0 * local / (local + remote) : 100.0) << "%" << std::endl;
+        } else {
+            std::cout << "    numastat unavailable (no /sys/devices/system/node)" << std::endl;
+        }
+    }
+    return 0;
+}
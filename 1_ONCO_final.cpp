@@ -10,6 +10,7 @@ ONCO
 #include <limits>
 #include <chrono>
 #include <iomanip>
+#include "avsdsf_trace.h"
 
 // Constants and parameters
 const double BASE_WEIGHT_C = 0.3; // Base weight for computation cost
@@ -88,6 +89,7 @@ double computeCost(const ServiceRequest& request, const RSU& rsu, const std::vec
 
 // Schedule requests to minimize cost with dynamic weights
 void scheduleRequests(std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, std::vector<double>& weights, DecisionVariables& decisions, int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+    TracePhase phase("schedule");
     auto start = std::chrono::high_resolution_clock::now();
     for (auto& request : requests) {
         double minCost = std::numeric_limits<double>::max();
@@ -115,6 +117,7 @@ void scheduleRequests(std::vector<ServiceRequest>& requests, std::vector<RSU>& r
 
 // Retain containers based on dynamic weights and system conditions
 void retainContainers(std::vector<RSU>& rsus, DecisionVariables& decisions, double load, int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+    TracePhase phase("retention");
     auto start = std::chrono::high_resolution_clock::now();
     for (auto& rsu : rsus) {
         if (load <= 0.7 && rsu.retentionCost <= RETENTION_THRESHOLD) {
@@ -130,6 +133,7 @@ void retainContainers(std::vector<RSU>& rsus, DecisionVariables& decisions, doub
 
 // Compute total cost
 double computeTotalCost(const std::vector<ServiceRequest>& requests, const std::vector<RSU>& rsus, const DecisionVariables& decisions) {
+    TracePhase phase("cost");
     double totalCost = 0.0;
 
     for (const auto& request : requests) {
@@ -150,7 +154,10 @@ void runBaseAlgorithm(int T, std::vector<ServiceRequest>& requests, std::vector<
     DecisionVariables decisions;
 
     for (int t = 0; t < T; ++t) {
+        TracePhase slot("slot");
+
         // Compute system load
+        traceBegin("weights");
         double totalCapacity = std::accumulate(rsus.begin(), rsus.end(), 0.0, [](double sum, const RSU& rsu) {
             return sum + rsu.maxCapacity;
         });
@@ -161,6 +168,7 @@ void runBaseAlgorithm(int T, std::vector<ServiceRequest>& requests, std::vector<
 
         // Calculate dynamic weights based on load
         std::vector<double> weights = calculateDynamicWeights(load);
+        traceEnd();
 
         // Start time for this slot
         auto slotStartTime = std::chrono::high_resolution_clock::now();
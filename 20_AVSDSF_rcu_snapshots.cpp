@@ -0,0 +1,341 @@
+/*
+AVSDSF - Epoch-based RCU snapshots of RSU state for lock-free cost queries
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include "avsdsf_model.h"
+
+const int MAX_READERS = 64;          // Reader slots in the epoch domain
+const int BATCH_SIZE = 64;           // Requests scheduled between two published versions
+const int NUM_BATCHES = 3000;        // Writer batches per run
+const double TIME_BUDGET = 3.0;      // Seconds a run may take before the writer stops early
+const int HOLD_BATCHES = 8;          // Batches a placed request keeps its capacity before release
+const int CONSISTENCY_EVERY = 256;   // Reader queries between full-snapshot consistency checks
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Epoch-based reclamation. Readers announce the global epoch while they hold
+// a pointer; a retired object is freed once every announced epoch is newer
+// than the epoch it was retired in, i.e. no reader can still see it.
+class EpochDomain {
+private:
+    static constexpr uint64_t IDLE = std::numeric_limits<uint64_t>::max();
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{IDLE};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        const void* object;
+        void (*destroy)(const void*);
+    };
+
+    std::atomic<uint64_t> globalEpoch{1};
+    std::unique_ptr<ReaderSlot[]> slots;
+    std::atomic<int> registered{0};
+    std::deque<Retired> retired; // Writer only, in retire (= epoch) order
+
+public:
+    long long reclaimed = 0;
+    size_t peakPending = 0;
+
+    EpochDomain() : slots(new ReaderSlot[MAX_READERS]) {}
+
+    ~EpochDomain() {
+        for (const auto& item : retired) item.destroy(item.object);
+    }
+
+    // Slot for a new reader thread, or -1 once all MAX_READERS slots are taken
+    int registerReader() {
+        int slot = registered.fetch_add(1);
+        return slot < MAX_READERS ? slot : -1;
+    }
+
+    void enter(int slot) {
+        assert(slot >= 0 && slot < MAX_READERS);
+        slots[slot].epoch.store(globalEpoch.load());
+    }
+    void exit(int slot) { slots[slot].epoch.store(IDLE); }
+
+    template <typename T>
+    void retire(const T* object) {
+        retired.push_back({globalEpoch.fetch_add(1), object, [](const void* p) { delete static_cast<const T*>(p); }});
+        peakPending = std::max(peakPending, retired.size());
+    }
+
+    // Free everything retired before the oldest epoch a reader still announces
+    void reclaim() {
+        uint64_t oldest = IDLE;
+        int readers = std::min(registered.load(), MAX_READERS);
+        for (int i = 0; i < readers; ++i) oldest = std::min(oldest, slots[i].epoch.load());
+        while (!retired.empty() && retired.front().epoch < oldest) {
+            retired.front().destroy(retired.front().object);
+            retired.pop_front();
+            reclaimed++;
+        }
+    }
+
+    size_t pending() const { return retired.size(); }
+};
+
+// RAII read-side critical section
+class ReadGuard {
+private:
+    EpochDomain& domain;
+    int slot;
+
+public:
+    ReadGuard(EpochDomain& d, int s) : domain(d), slot(s) { domain.enter(slot); }
+    ~ReadGuard() { domain.exit(slot); }
+};
+
+// Pointer to the current immutable version; readers load it inside a
+// ReadGuard, the single writer swaps in new versions and retires old ones.
+template <typename T>
+class RcuPointer {
+private:
+    std::atomic<const T*> current{nullptr};
+    EpochDomain& domain;
+
+public:
+    explicit RcuPointer(EpochDomain& d) : domain(d) {}
+    ~RcuPointer() { delete current.load(); }
+
+    const T* read() const { return current.load(); }
+
+    void publish(const T* next) {
+        const T* old = current.exchange(next);
+        if (old) domain.retire(old);
+        domain.reclaim();
+    }
+};
+
+// Immutable RSU state as of one batch boundary
+struct RSUSnapshot {
+    uint64_t version;
+    std::vector<RSU> rsus;
+    std::vector<double> weights;
+    double usedCapacitySum; // Must match the RSU entries of the same version
+};
+
+struct ReaderStats {
+    long long queries = 0;
+    long long feasible = 0;
+    long long inconsistent = 0;
+    uint64_t newestVersion = 0;
+};
+
+// Scheduler side: places a batch on its private working copy, then releases
+// the requests placed HOLD_BATCHES ago
+class BatchScheduler {
+private:
+    std::vector<RSU> rsus;
+    const std::vector<ServiceRequest>& requests;
+    std::deque<std::vector<std::pair<int, double>>> held; // Per batch: (RSU, load) still reserved
+    size_t next = 0;
+
+public:
+    std::vector<double> weights;
+    long long placed = 0;
+
+    BatchScheduler(const std::vector<RSU>& initial, const std::vector<ServiceRequest>& reqs) : rsus(initial), requests(reqs) {
+        weights = computeDynamicWeights(0.0);
+    }
+
+    const std::vector<RSU>& state() const { return rsus; }
+
+    double usedSum() const {
+        double sum = 0.0;
+        for (const auto& rsu : rsus) sum += rsu.usedCapacity;
+        return sum;
+    }
+
+    void runBatch() {
+        std::vector<std::pair<int, double>> reservations;
+        for (int i = 0; i < BATCH_SIZE; ++i) {
+            const ServiceRequest& request = requests[next++ % requests.size()];
+            double minCost = std::numeric_limits<double>::max();
+            int best = -1;
+            for (const auto& rsu : rsus) {
+                if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                    double cost = computePlacementCost(request, rsu, weights);
+                    if (cost < minCost) {
+                        minCost = cost;
+                        best = rsu.id;
+                    }
+                }
+            }
+            if (best >= 0) {
+                rsus[best].usedCapacity += request.computationLoad;
+                reservations.push_back({best, request.computationLoad});
+                placed++;
+            }
+        }
+        held.push_back(std::move(reservations));
+        if (held.size() > static_cast<size_t>(HOLD_BATCHES)) {
+            for (const auto& [rsu, load] : held.front()) rsus[rsu].usedCapacity -= load;
+            held.pop_front();
+        }
+        weights = computeDynamicWeights(computeSystemLoad(rsus));
+    }
+};
+
+// What-if cost of a request on one RSU against a consistent view
+inline bool whatIf(const ServiceRequest& request, const RSU& rsu, const std::vector<double>& weights, double& cost) {
+    cost = computePlacementCost(request, rsu, weights);
+    return rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity;
+}
+
+inline bool consistent(const std::vector<RSU>& rsus, double expectedSum) {
+    double sum = 0.0;
+    for (const auto& rsu : rsus) sum += rsu.usedCapacity;
+    return std::fabs(sum - expectedSum) <= 1e-6 * std::max(1.0, expectedSum);
+}
+
+struct ModeResult {
+    double writerSeconds = 0.0;
+    int batches = 0;
+    std::vector<ReaderStats> readers;
+    long long reclaimed = 0;
+    size_t peakPending = 0;
+    size_t pendingAtEnd = 0;
+};
+
+ModeResult runRcu(int numReaders, const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests) {
+    EpochDomain domain;
+    RcuPointer<RSUSnapshot> snapshot(domain);
+    BatchScheduler scheduler(rsus, requests);
+    snapshot.publish(new RSUSnapshot{0, scheduler.state(), scheduler.weights, scheduler.usedSum()});
+
+    ModeResult result;
+    result.readers.resize(numReaders);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numReaders; ++r) {
+        readers.emplace_back([&, r] {
+            int slot = domain.registerReader();
+            if (slot < 0) return; // No reader slot left: this thread must not read
+            ReaderStats& stats = result.readers[r];
+            std::mt19937 gen(100 + r);
+            std::uniform_int_distribution<int> anyRequest(0, static_cast<int>(requests.size()) - 1);
+            std::uniform_int_distribution<int> anyRSU(0, static_cast<int>(rsus.size()) - 1);
+            while (!done.load(std::memory_order_relaxed)) {
+                ReadGuard guard(domain, slot);
+                const RSUSnapshot* view = snapshot.read();
+                double cost;
+                if (whatIf(requests[anyRequest(gen)], view->rsus[anyRSU(gen)], view->weights, cost)) stats.feasible++;
+                if (++stats.queries % CONSISTENCY_EVERY == 0 && !consistent(view->rsus, view->usedCapacitySum)) stats.inconsistent++;
+                stats.newestVersion = std::max(stats.newestVersion, view->version);
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    for (int b = 1; b <= NUM_BATCHES && std::chrono::duration<double>(Clock::now() - start).count() < TIME_BUDGET; ++b) {
+        scheduler.runBatch();
+        snapshot.publish(new RSUSnapshot{static_cast<uint64_t>(b), scheduler.state(), scheduler.weights, scheduler.usedSum()});
+        result.batches = b;
+    }
+    result.writerSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    done.store(true);
+    for (auto& reader : readers) reader.join();
+    domain.reclaim();
+    result.reclaimed = domain.reclaimed;
+    result.peakPending = domain.peakPending;
+    result.pendingAtEnd = domain.pending();
+    return result;
+}
+
+// Baseline: live RSU state behind a reader-writer lock, held exclusively for a whole batch
+ModeResult runSharedMutex(int numReaders, const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests) {
+    std::shared_mutex lock;
+    BatchScheduler scheduler(rsus, requests);
+    std::vector<RSU> live = scheduler.state();
+    std::vector<double> liveWeights = scheduler.weights;
+    double liveSum = scheduler.usedSum();
+    uint64_t liveVersion = 0;
+
+    ModeResult result;
+    result.readers.resize(numReaders);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numReaders; ++r) {
+        readers.emplace_back([&, r] {
+            ReaderStats& stats = result.readers[r];
+            std::mt19937 gen(100 + r);
+            std::uniform_int_distribution<int> anyRequest(0, static_cast<int>(requests.size()) - 1);
+            std::uniform_int_distribution<int> anyRSU(0, static_cast<int>(rsus.size()) - 1);
+            while (!done.load(std::memory_order_relaxed)) {
+                std::shared_lock<std::shared_mutex> guard(lock);
+                double cost;
+                if (whatIf(requests[anyRequest(gen)], live[anyRSU(gen)], liveWeights, cost)) stats.feasible++;
+                if (++stats.queries % CONSISTENCY_EVERY == 0 && !consistent(live, liveSum)) stats.inconsistent++;
+                stats.newestVersion = std::max(stats.newestVersion, liveVersion);
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    for (int b = 1; b <= NUM_BATCHES && std::chrono::duration<double>(Clock::now() - start).count() < TIME_BUDGET; ++b) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        scheduler.runBatch();
+        live = scheduler.state();
+        liveWeights = scheduler.weights;
+        liveSum = scheduler.usedSum();
+        liveVersion = static_cast<uint64_t>(b);
+        result.batches = b;
+    }
+    result.writerSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    done.store(true);
+    for (auto& reader : readers) reader.join();
+    return result;
+}
+
+void report(const char* name, const ModeResult& result) {
+    long long queries = 0, inconsistent = 0;
+    uint64_t newest = 0;
+    for (const auto& reader : result.readers) {
+        queries += reader.queries;
+        inconsistent += reader.inconsistent;
+        newest = std::max(newest, reader.newestVersion);
+    }
+    std::cout << name << ": " << queries / result.writerSeconds / 1e6 << " M what-if queries/sec, writer "
+              << result.batches / result.writerSeconds << " batches/sec (" << result.batches << " of " << NUM_BATCHES << "), newest version seen = " << newest
+              << ", inconsistent views = " << inconsistent << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int numReaders = argc > 1 ? std::clamp(std::atoi(argv[1]), 1, MAX_READERS) : 4;
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(2000, 20000, 1, 59, rsus, requests, services, 0.2);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "RSUs = " << rsus.size() << ", readers = " << numReaders << ", batches = " << NUM_BATCHES
+              << " x " << BATCH_SIZE << " requests, hardware threads = " << std::thread::hardware_concurrency() << "\n" << std::endl;
+
+    ModeResult rcu = runRcu(numReaders, rsus, requests);
+    report("RCU snapshots     ", rcu);
+    std::cout << "    snapshots reclaimed = " << rcu.reclaimed << ", peak awaiting reclamation = " << rcu.peakPending
+              << ", still pending at end = " << rcu.pendingAtEnd << std::endl;
+    ModeResult locked = runSharedMutex(numReaders, rsus, requests);
+    report("Reader-writer lock", locked);
+    return 0;
+}
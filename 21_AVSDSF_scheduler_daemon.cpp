@@ -0,0 +1,632 @@
+/*
+AVSDSF - Long-running scheduler daemon with a localhost socket API and request batching
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "avsdsf_model.h"
+#include "avsdsf_metrics.h"
+
+const int NUM_RSUS = 1000;
+const int TEMPLATE_REQUESTS = 10000;  // Request parameters the load generator cycles through
+const size_t HOLD_DECISIONS = 3000;   // A placement keeps its capacity until this many later placements
+const size_t MAX_BATCH = 4096;        // A pass starts early once this many requests are waiting
+const int CONNECT_TIMEOUT_MS = 5000;
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// Wire protocol: fixed-size frames in host byte order (localhost only).
+// Clients send RequestFrames, the daemon answers each Place with one
+// DecisionFrame and a Shutdown with a Stats frame before it exits.
+// ---------------------------------------------------------------------------
+
+enum FrameType : uint32_t {
+    Place = 1,
+    Decision = 2,
+    Shutdown = 3,
+    Stats = 4
+};
+
+struct RequestFrame {
+    uint32_t type;
+    uint32_t sequence; // Echoed in the decision
+    float deadline;
+    float computationLoad;
+    float transferCost;
+    float preparationCost;
+    float demand;
+    float distanceToRSU;
+};
+
+struct DecisionFrame {
+    uint32_t type;
+    uint32_t sequence; // Stats: decisions made
+    int32_t rsu;       // -1 if no RSU had capacity; Stats: requests dropped
+    float cost;
+    uint32_t batchSize; // Requests in the pass that decided this one; Stats: largest pass
+    uint32_t pass;      // Stats: passes run
+};
+
+static_assert(sizeof(RequestFrame) == 32, "request frames are 32 bytes on the wire");
+static_assert(sizeof(DecisionFrame) == 24, "decision frames are 24 bytes on the wire");
+
+enum class Endpoint { Unix, Tcp };
+
+static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+// Listen on a UNIX socket path or on a localhost TCP port (0 picks a free one)
+int makeListener(Endpoint kind, const std::string& path, int port) {
+    int fd = -1;
+    if (kind == Endpoint::Unix) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        unlink(path.c_str());
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return -1;
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return -1;
+    }
+    if (listen(fd, 128) != 0) return -1;
+    return fd;
+}
+
+int boundPort(int listener) {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+    return ntohs(address.sin_port);
+}
+
+int connectTo(Endpoint kind, const std::string& path, int port) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(CONNECT_TIMEOUT_MS);
+    while (Clock::now() < deadline) {
+        int fd = -1;
+        int result = -1;
+        if (kind == Endpoint::Unix) {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+            result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        } else {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(static_cast<uint16_t>(port));
+            result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+            int yes = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        }
+        if (result == 0) return fd;
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Daemon not listening yet
+    }
+    return -1;
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Live counters of a serving daemon, scraped over HTTP while it runs
+struct DaemonMetrics {
+    Counter& scheduled;
+    Counter& dropped;
+    Histogram& passDuration;
+    Histogram& passRequests;
+    Gauge& clients;
+    std::vector<Gauge*> utilization; // Per RSU id
+
+    DaemonMetrics(MetricsRegistry& registry, int numRSUs)
+        : scheduled(registry.counter("avsdsf_requests_scheduled_total", "Requests placed on an RSU")),
+          dropped(registry.counter("avsdsf_requests_dropped_total", "Requests no RSU had capacity for")),
+          passDuration(registry.histogram("avsdsf_pass_duration_seconds", "Wall time of one batched scheduling pass",
+                                          {0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1})),
+          passRequests(registry.histogram("avsdsf_pass_requests", "Requests decided per scheduling pass",
+                                          {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096})),
+          clients(registry.gauge("avsdsf_clients_connected", "Open client connections")) {
+        for (int r = 0; r < numRSUs; ++r) {
+            utilization.push_back(&registry.gauge("avsdsf_rsu_utilization", "Used over maximum capacity",
+                                                  "rsu=\"" + std::to_string(r) + "\""));
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Daemon: one poll loop owns the RSU state. Requests arriving within `window`
+// of the first waiting request are decided together in one RS-MAS pass, with
+// the dynamic weights computed once per pass as main_algorithm does per slot.
+// ---------------------------------------------------------------------------
+
+class SchedulerDaemon {
+private:
+    struct Client {
+        int fd;
+        std::string incoming;
+        std::string outgoing;
+    };
+
+    struct Pending {
+        size_t client;
+        RequestFrame frame;
+    };
+
+    int listener;
+    std::chrono::microseconds window;
+    std::vector<RSU> rsus;
+    std::vector<Client> clients;
+    std::vector<Pending> batch;
+    Clock::time_point batchOpened;
+    std::deque<std::pair<int, double>> reservations; // (RSU, load) in placement order
+    int shutdownClient = -1;
+    size_t closedClients = 0; // Closed entries still in `clients`, see pruneClosed
+    std::unique_ptr<DaemonMetrics> metrics; // Only when serving a metrics endpoint
+
+    uint32_t passes = 0;
+    uint32_t decisions = 0;
+    int32_t dropped = 0;
+    uint32_t largestBatch = 0;
+
+    void accept() {
+        for (;;) {
+            int fd = ::accept(listener, nullptr, nullptr);
+            if (fd < 0) return;
+            setNonBlocking(fd);
+            int yes = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); // Fails harmlessly on UNIX sockets
+            clients.push_back({fd, {}, {}});
+            if (metrics) metrics->clients.add(1.0);
+        }
+    }
+
+    void readFrom(size_t index) {
+        Client& client = clients[index];
+        char buffer[1 << 16];
+        for (;;) {
+            ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                closeClient(client);
+                break;
+            }
+            if (n < 0) break;
+            client.incoming.append(buffer, static_cast<size_t>(n));
+        }
+        size_t whole = client.incoming.size() / sizeof(RequestFrame) * sizeof(RequestFrame);
+        for (size_t offset = 0; offset < whole; offset += sizeof(RequestFrame)) {
+            RequestFrame frame;
+            std::memcpy(&frame, client.incoming.data() + offset, sizeof(frame));
+            if (frame.type == Shutdown) {
+                shutdownClient = static_cast<int>(index);
+            } else if (frame.type == Place) {
+                if (batch.empty()) batchOpened = Clock::now();
+                batch.push_back({index, frame});
+            }
+        }
+        client.incoming.erase(0, whole);
+    }
+
+    void runPass() {
+        auto started = Clock::now();
+        std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+        passes++;
+        largestBatch = std::max(largestBatch, static_cast<uint32_t>(batch.size()));
+        for (const Pending& pending : batch) {
+            const RequestFrame& frame = pending.frame;
+            ServiceRequest request{static_cast<int>(frame.sequence), frame.deadline, frame.computationLoad, frame.transferCost,
+                                   frame.preparationCost, frame.demand, frame.distanceToRSU};
+            double minCost = std::numeric_limits<double>::max();
+            int best = -1;
+            for (const auto& rsu : rsus) {
+                if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                    double cost = computePlacementCost(request, rsu, weights);
+                    if (cost < minCost) {
+                        minCost = cost;
+                        best = rsu.id;
+                    }
+                }
+            }
+            DecisionFrame decision{Decision, frame.sequence, best, 0.0f, static_cast<uint32_t>(batch.size()), passes};
+            if (best >= 0) {
+                rsus[best].usedCapacity += request.computationLoad;
+                reservations.push_back({best, request.computationLoad});
+                if (metrics) updateUtilization(best);
+                if (reservations.size() > HOLD_DECISIONS) {
+                    int released = reservations.front().first;
+                    rsus[released].usedCapacity -= reservations.front().second;
+                    reservations.pop_front();
+                    if (metrics) updateUtilization(released);
+                }
+                decision.cost = static_cast<float>(minCost);
+                if (metrics) metrics->scheduled.inc();
+            } else {
+                dropped++;
+                if (metrics) metrics->dropped.inc();
+            }
+            decisions++;
+            Client& client = clients[pending.client];
+            if (client.fd >= 0) client.outgoing.append(reinterpret_cast<const char*>(&decision), sizeof(decision));
+        }
+        if (metrics) {
+            metrics->passRequests.observe(static_cast<double>(batch.size()));
+            metrics->passDuration.observe(std::chrono::duration<double>(Clock::now() - started).count());
+        }
+        batch.clear();
+    }
+
+    void closeClient(Client& client) {
+        close(client.fd);
+        client.fd = -1;
+        closedClients++;
+        if (metrics) metrics->clients.add(-1.0);
+    }
+
+    // Drop closed clients no pending batch entry still refers to, renumbering
+    // the batch and the shutdown requester, so `clients` and the poll set only
+    // track open connections over the life of the daemon
+    void pruneClosed() {
+        if (closedClients == 0) return;
+        std::vector<bool> referenced(clients.size(), false);
+        for (const Pending& pending : batch) referenced[pending.client] = true;
+        if (shutdownClient >= 0) referenced[shutdownClient] = true;
+        std::vector<size_t> renumbered(clients.size());
+        size_t kept = 0;
+        closedClients = 0;
+        for (size_t i = 0; i < clients.size(); ++i) {
+            if (clients[i].fd < 0 && !referenced[i]) continue;
+            if (clients[i].fd < 0) closedClients++;
+            renumbered[i] = kept;
+            if (kept != i) clients[kept] = std::move(clients[i]);
+            kept++;
+        }
+        clients.resize(kept);
+        for (Pending& pending : batch) pending.client = renumbered[pending.client];
+        if (shutdownClient >= 0) shutdownClient = static_cast<int>(renumbered[shutdownClient]);
+    }
+
+    void updateUtilization(int rsu) { metrics->utilization[rsu]->set(rsus[rsu].usedCapacity / rsus[rsu].maxCapacity); }
+
+    void flush(Client& client) {
+        while (!client.outgoing.empty() && client.fd >= 0) {
+            ssize_t n = send(client.fd, client.outgoing.data(), client.outgoing.size(), MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return; // Retried when POLLOUT fires
+            if (n <= 0) {
+                closeClient(client);
+                return;
+            }
+            client.outgoing.erase(0, static_cast<size_t>(n));
+        }
+    }
+
+public:
+    SchedulerDaemon(int listenFd, std::chrono::microseconds batchWindow, MetricsRegistry* registry = nullptr)
+        : listener(listenFd), window(batchWindow) {
+        std::vector<ServiceRequest> requests;
+        std::vector<PrefetchedService> services;
+        generateScenario(NUM_RSUS, TEMPLATE_REQUESTS, 1, 61, rsus, requests, services, 1.0);
+        setNonBlocking(listener);
+        if (registry) {
+            metrics = std::make_unique<DaemonMetrics>(*registry, NUM_RSUS);
+            for (const RSU& rsu : rsus) updateUtilization(rsu.id);
+        }
+    }
+
+    void run() {
+        for (;;) {
+            std::vector<pollfd> fds{{listener, POLLIN, 0}};
+            for (const Client& client : clients) {
+                short events = client.fd >= 0 ? static_cast<short>(POLLIN | (client.outgoing.empty() ? 0 : POLLOUT)) : 0;
+                fds.push_back({client.fd, events, 0});
+            }
+            // Sleep until traffic arrives or the open batch's window closes
+            timespec timeout{};
+            timespec* wait = nullptr;
+            if (!batch.empty()) {
+                auto remaining = std::max(Clock::duration::zero(), batchOpened + window - Clock::now());
+                long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                timeout.tv_sec = static_cast<time_t>(nanos / 1000000000);
+                timeout.tv_nsec = static_cast<long>(nanos % 1000000000);
+                wait = &timeout;
+            }
+            if (ppoll(fds.data(), fds.size(), wait, nullptr) < 0 && errno != EINTR) break;
+
+            if (fds[0].revents & POLLIN) accept();
+            for (size_t i = 0; i + 1 < fds.size(); ++i) {
+                if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) readFrom(i);
+            }
+            if (!batch.empty() && (batch.size() >= MAX_BATCH || Clock::now() >= batchOpened + window)) runPass();
+            for (Client& client : clients) flush(client);
+
+            if (shutdownClient >= 0) {
+                if (!batch.empty()) runPass();
+                for (Client& client : clients) flush(client);
+                Client& requester = clients[shutdownClient];
+                DecisionFrame stats{Stats, decisions, dropped, 0.0f, largestBatch, passes};
+                if (requester.fd >= 0) {
+                    fcntl(requester.fd, F_SETFL, fcntl(requester.fd, F_GETFL) & ~O_NONBLOCK);
+                    writeAll(requester.fd, requester.outgoing.data(), requester.outgoing.size());
+                    writeAll(requester.fd, reinterpret_cast<const char*>(&stats), sizeof(stats));
+                }
+                break;
+            }
+            pruneClosed();
+        }
+        for (Client& client : clients) {
+            if (client.fd >= 0) close(client.fd);
+        }
+        close(listener);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Load generator: closed-loop clients, each keeping `outstanding` requests in
+// flight on its own connection and timing every request to its decision.
+// ---------------------------------------------------------------------------
+
+struct LoadResult {
+    long long decisions = 0;
+    long long placed = 0;
+    double seconds = 0.0;
+    std::vector<double> latencies; // Microseconds
+    bool ok = true;
+};
+
+RequestFrame toFrame(const ServiceRequest& request, uint32_t sequence) {
+    return {Place, sequence, static_cast<float>(request.deadline), static_cast<float>(request.computationLoad),
+            static_cast<float>(request.transferCost), static_cast<float>(request.preparationCost),
+            static_cast<float>(request.demand), static_cast<float>(request.distanceToRSU)};
+}
+
+LoadResult generateLoad(Endpoint kind, const std::string& path, int port, int numClients, int requestsPerClient, int outstanding) {
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> templates;
+    std::vector<PrefetchedService> services;
+    generateScenario(NUM_RSUS, TEMPLATE_REQUESTS, 1, 61, rsus, templates, services, 1.0);
+
+    std::vector<LoadResult> perClient(numClients);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int c = 0; c < numClients; ++c) {
+        threads.emplace_back([&, c] {
+            LoadResult& result = perClient[c];
+            int fd = connectTo(kind, path, port);
+            if (fd < 0) {
+                result.ok = false;
+                return;
+            }
+            std::vector<Clock::time_point> sentAt(requestsPerClient);
+            result.latencies.reserve(requestsPerClient);
+            int sent = 0;
+            std::string out, in;
+            auto sendUpTo = [&](int limit) {
+                out.clear();
+                auto now = Clock::now();
+                for (; sent < limit && sent < requestsPerClient; ++sent) {
+                    RequestFrame frame = toFrame(templates[(c * 7919 + sent) % templates.size()], static_cast<uint32_t>(sent));
+                    sentAt[sent] = now;
+                    out.append(reinterpret_cast<const char*>(&frame), sizeof(frame));
+                }
+                return writeAll(fd, out.data(), out.size());
+            };
+            if (!sendUpTo(outstanding)) result.ok = false;
+            char buffer[1 << 14];
+            while (result.ok && result.decisions < requestsPerClient) {
+                ssize_t n = read(fd, buffer, sizeof(buffer));
+                if (n <= 0) {
+                    result.ok = false;
+                    break;
+                }
+                in.append(buffer, static_cast<size_t>(n));
+                size_t whole = in.size() / sizeof(DecisionFrame) * sizeof(DecisionFrame);
+                auto now = Clock::now();
+                for (size_t offset = 0; offset < whole; offset += sizeof(DecisionFrame)) {
+                    DecisionFrame decision;
+                    std::memcpy(&decision, in.data() + offset, sizeof(decision));
+                    result.latencies.push_back(std::chrono::duration<double, std::micro>(now - sentAt[decision.sequence]).count());
+                    result.decisions++;
+                    if (decision.rsu >= 0) result.placed++;
+                }
+                in.erase(0, whole);
+                if (!sendUpTo(static_cast<int>(result.decisions) + outstanding)) result.ok = false;
+            }
+            close(fd);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    LoadResult total;
+    total.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& result : perClient) {
+        total.ok = total.ok && result.ok;
+        total.decisions += result.decisions;
+        total.placed += result.placed;
+        total.latencies.insert(total.latencies.end(), result.latencies.begin(), result.latencies.end());
+    }
+    return total;
+}
+
+// Ask the daemon to exit and return its pass statistics
+bool requestShutdown(Endpoint kind, const std::string& path, int port, DecisionFrame& stats) {
+    int fd = connectTo(kind, path, port);
+    if (fd < 0) return false;
+    RequestFrame frame{};
+    frame.type = Shutdown;
+    bool ok = writeAll(fd, reinterpret_cast<const char*>(&frame), sizeof(frame));
+    size_t got = 0;
+    while (ok && got < sizeof(stats)) {
+        ssize_t n = read(fd, reinterpret_cast<char*>(&stats) + got, sizeof(stats) - got);
+        if (n <= 0) ok = false;
+        else got += static_cast<size_t>(n);
+    }
+    close(fd);
+    return ok && stats.type == Stats;
+}
+
+double percentile(std::vector<double>& values, double fraction) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void printLoad(LoadResult& result) {
+    std::cout << result.decisions / result.seconds / 1000.0 << " k decisions/sec, placed = " << result.placed
+              << ", latency p50 = " << percentile(result.latencies, 0.50) << " us, p99 = " << percentile(result.latencies, 0.99)
+              << " us, max = " << percentile(result.latencies, 1.0) << " us";
+}
+
+void printStats(const DecisionFrame& stats) {
+    std::cout << ", passes = " << stats.pass << " (mean " << (stats.pass ? static_cast<double>(stats.sequence) / stats.pass : 0.0)
+              << ", max " << stats.batchSize << " requests), dropped = " << stats.rsu;
+}
+
+// Parse "unix <path>" or "tcp <port>"
+bool parseEndpoint(const std::string& kind, const std::string& where, Endpoint& endpoint, std::string& path, int& port) {
+    if (kind == "unix") {
+        endpoint = Endpoint::Unix;
+        path = where;
+        return true;
+    }
+    if (kind == "tcp") {
+        endpoint = Endpoint::Tcp;
+        port = std::atoi(where.c_str());
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout << std::fixed << std::setprecision(1);
+    std::string mode = argc > 1 ? argv[1] : "";
+    Endpoint endpoint = Endpoint::Unix;
+    std::string path;
+    int port = 0;
+
+    // Daemon: <prog> serve unix <path> | tcp <port> [windowMicros] [metricsPort]
+    if (mode == "serve" && argc >= 4 && parseEndpoint(argv[2], argv[3], endpoint, path, port)) {
+        int listener = makeListener(endpoint, path, port);
+        if (listener < 0) {
+            std::cerr << "Could not listen on " << argv[2] << " " << argv[3] << std::endl;
+            return 1;
+        }
+        MetricsRegistry registry;
+        std::unique_ptr<MetricsServer> server;
+        if (argc > 5) {
+            server = std::make_unique<MetricsServer>(registry, std::atoi(argv[5]));
+            if (!server->ok()) {
+                std::cerr << "Could not serve metrics: " << server->error << std::endl;
+                return 1;
+            }
+            std::cerr << "Metrics at http://127.0.0.1:" << server->port() << "/metrics" << std::endl;
+        }
+        SchedulerDaemon daemon(listener, std::chrono::microseconds(argc > 4 ? std::atoi(argv[4]) : 250), server ? &registry : nullptr);
+        daemon.run();
+        if (endpoint == Endpoint::Unix) unlink(path.c_str());
+        return 0;
+    }
+
+    // Load generator: <prog> load unix <path> | tcp <port> [clients] [requestsPerClient] [outstanding] [--shutdown]
+    if (mode == "load" && argc >= 4 && parseEndpoint(argv[2], argv[3], endpoint, path, port)) {
+        int clients = argc > 4 ? std::max(1, std::atoi(argv[4])) : 16;
+        int perClient = argc > 5 ? std::max(1, std::atoi(argv[5])) : 20000;
+        int outstanding = argc > 6 ? std::max(1, std::atoi(argv[6])) : 8;
+        LoadResult result = generateLoad(endpoint, path, port, clients, perClient, outstanding);
+        if (!result.ok) {
+            std::cerr << "Load generation failed" << std::endl;
+            return 1;
+        }
+        printLoad(result);
+        DecisionFrame stats{};
+        if (argc > 7 && std::string(argv[7]) == "--shutdown" && requestShutdown(endpoint, path, port, stats)) printStats(stats);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    if (!mode.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [serve unix <path>|tcp <port> [windowMicros] [metricsPort]]"
+                  << " [load unix <path>|tcp <port> [clients] [requestsPerClient] [outstanding] [--shutdown]]" << std::endl;
+        return 1;
+    }
+
+    // Self-contained benchmark: fork a daemon per configuration and drive it locally
+    const int clients = 16, perClient = 10000, outstanding = 8;
+    std::cout << "RSUs = " << NUM_RSUS << ", clients = " << clients << " x " << perClient << " requests, "
+              << outstanding << " outstanding per client\n" << std::endl;
+    bool allOk = true;
+    for (Endpoint kind : {Endpoint::Unix, Endpoint::Tcp}) {
+        for (int windowMicros : {0, 100, 500, 2000}) {
+            path = "/tmp/avsdsf_daemon_" + std::to_string(getpid()) + ".sock";
+            int listener = makeListener(kind, path, 0);
+            if (listener < 0) {
+                std::cout << "Could not create listener" << std::endl;
+                return 1;
+            }
+            port = kind == Endpoint::Tcp ? boundPort(listener) : 0;
+            pid_t child = fork();
+            if (child == 0) {
+                SchedulerDaemon daemon(listener, std::chrono::microseconds(windowMicros));
+                daemon.run();
+                _exit(0);
+            }
+            close(listener);
+
+            LoadResult result = generateLoad(kind, path, port, clients, perClient, outstanding);
+            DecisionFrame stats{};
+            bool ok = result.ok && requestShutdown(kind, path, port, stats);
+            int status = 0;
+            waitpid(child, &status, 0);
+            if (kind == Endpoint::Unix) unlink(path.c_str());
+
+            std::cout << (kind == Endpoint::Unix ? "UNIX" : "TCP ") << " window " << std::setw(4) << windowMicros << " us: ";
+            if (!ok) {
+                std::cout << "run failed" << std::endl;
+                allOk = false;
+                continue;
+            }
+            printLoad(result);
+            printStats(stats);
+            std::cout << std::endl;
+        }
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,488 @@
+/*
+AVSDSF - Compact binary decision audit log (varint/delta encoded, background writer, offline reader)
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "avsdsf_model.h"
+
+const int NUM_RSUS = 1000;               // Sized so the unaudited scheduler runs at about 1M decisions/sec
+const int NUM_REQUESTS = 20000;
+const int NUM_SLOTS = 50;                // 1M decisions per run
+const int RUNS = 3;                      // Best of RUNS per variant
+const size_t BLOCK_BYTES = 1 << 20;      // Encoded bytes per block handed to the writer thread
+const size_t MAX_RECORD_BYTES = 96;      // Upper bound of one encoded record
+const uint32_t BLOCK_MAGIC = 0x4C415641; // "AVAL"
+const double COST_QUANTUM = 1e-9;        // Cost components are stored as multiples of this
+
+using Clock = std::chrono::high_resolution_clock;
+
+// One placement decision with everything needed to explain it
+struct Decision {
+    int slot;
+    int request;
+    int rsu;      // -1 if no RSU had capacity
+    int runnerUp; // Second-cheapest feasible RSU, -1 if none
+    double computation, retention, transfer, preparation; // Weighted cost components of the chosen RSU
+    double runnerUpCost;
+};
+
+// ---------------------------------------------------------------------------
+// Encoding. The log is a sequence of self-contained blocks:
+//   header: magic, payload bytes, record count, FNV-1a of the payload (4 x u32)
+//   payload: records, each starting with a tag byte
+//     SlotRecord:     varint slot, 4 raw doubles (dynamic weights of the slot)
+//     DecisionRecord: zigzag(request - previous request), varint(rsu + 1),
+//                     varint(runnerUp + 1), 4 varint cost components and
+//                     varint(runner-up cost - chosen cost), costs in COST_QUANTUM units
+// Delta state restarts with every block so a truncated tail only loses the
+// last block.
+// ---------------------------------------------------------------------------
+
+enum RecordTag : uint8_t { SlotRecord = 1, DecisionRecord = 2 };
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t bytes;
+    uint32_t records;
+    uint32_t checksum;
+};
+
+inline uint8_t* putVarint(uint8_t* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+inline uint64_t zigzag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+inline int64_t unzigzag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+inline uint64_t quantize(double cost) { return cost > 0.0 ? static_cast<uint64_t>(cost * (1.0 / COST_QUANTUM) + 0.5) : 0; }
+
+inline uint32_t fnv1a(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+// Append-only writer. The scheduling thread encodes into the active buffer;
+// full buffers are handed to a background thread that writes them out while
+// the other buffer fills, so the scheduler never waits on the file unless
+// the disk falls a whole block behind.
+class AuditWriter {
+private:
+    std::FILE* file;
+    std::vector<uint8_t> buffers[2];     // Fixed size; only the first `used` bytes are encoded
+    size_t used[2] = {0, 0};
+    uint32_t recordCounts[2] = {0, 0};
+    uint8_t* cursor;                     // Next free byte of the active buffer
+    int active = 0;
+    bool pending[2] = {false, false}; // Buffer handed to the writer and not yet written
+    bool closing = false;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread writer;
+    int64_t previousRequest = 0;
+
+    void writeLoop() {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;) {
+            changed.wait(guard, [&] { return pending[0] || pending[1] || closing; });
+            int ready = pending[0] ? 0 : pending[1] ? 1 : -1;
+            if (ready < 0) return; // Closing with nothing left to write
+            guard.unlock();
+            const uint8_t* block = buffers[ready].data();
+            BlockHeader header{BLOCK_MAGIC, static_cast<uint32_t>(used[ready]), recordCounts[ready], fnv1a(block, used[ready])};
+            if (file) {
+                std::fwrite(&header, sizeof(header), 1, file);
+                std::fwrite(block, 1, used[ready], file);
+                bytesWritten += sizeof(header) + used[ready];
+            }
+            guard.lock();
+            pending[ready] = false;
+            changed.notify_all();
+        }
+    }
+
+    void submit() {
+        std::unique_lock<std::mutex> guard(lock);
+        used[active] = static_cast<size_t>(cursor - buffers[active].data());
+        pending[active] = true;
+        changed.notify_all();
+        int next = 1 - active;
+        if (pending[next]) {
+            stalls++;
+            changed.wait(guard, [&] { return !pending[next]; });
+        }
+        active = next;
+        cursor = buffers[active].data();
+        recordCounts[active] = 0;
+        previousRequest = 0;
+    }
+
+    void endRecord() {
+        recordCounts[active]++;
+        if (static_cast<size_t>(cursor - buffers[active].data()) >= BLOCK_BYTES) submit();
+    }
+
+public:
+    long long stalls = 0;       // Times the scheduler waited for the writer
+    uint64_t bytesWritten = 0;  // Written by the writer thread; read after close()
+
+    explicit AuditWriter(const std::string& path) : file(std::fopen(path.c_str(), "wb")) {
+        for (auto& buffer : buffers) buffer.resize(BLOCK_BYTES + MAX_RECORD_BYTES);
+        cursor = buffers[0].data();
+        writer = std::thread([this] { writeLoop(); });
+    }
+
+    ~AuditWriter() { close(); }
+
+    bool ok() const { return file != nullptr; }
+
+    void beginSlot(int slot, const std::vector<double>& weights) {
+        *cursor++ = SlotRecord;
+        cursor = putVarint(cursor, static_cast<uint64_t>(slot));
+        std::memcpy(cursor, weights.data(), 4 * sizeof(double));
+        cursor += 4 * sizeof(double);
+        endRecord();
+    }
+
+    void record(const Decision& decision) {
+        uint8_t* out = cursor;
+        *out++ = DecisionRecord;
+        out = putVarint(out, zigzag(decision.request - previousRequest));
+        previousRequest = decision.request;
+        out = putVarint(out, static_cast<uint64_t>(decision.rsu + 1));
+        out = putVarint(out, static_cast<uint64_t>(decision.runnerUp + 1));
+        if (decision.rsu >= 0) {
+            out = putVarint(out, quantize(decision.computation));
+            out = putVarint(out, quantize(decision.retention));
+            out = putVarint(out, quantize(decision.transfer));
+            out = putVarint(out, quantize(decision.preparation));
+            if (decision.runnerUp >= 0) {
+                double chosen = decision.computation + decision.retention + decision.transfer + decision.preparation;
+                out = putVarint(out, quantize(decision.runnerUpCost - chosen));
+            }
+        }
+        cursor = out;
+        endRecord();
+    }
+
+    void close() {
+        if (!writer.joinable()) return;
+        if (cursor != buffers[active].data()) submit();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closing = true;
+            changed.notify_all();
+        }
+        writer.join();
+        if (file) std::fclose(file);
+        file = nullptr;
+    }
+};
+
+// Offline reader: decodes blocks back into slot weights and decisions
+class AuditReader {
+private:
+    std::ifstream in;
+    std::vector<uint8_t> block;
+    size_t position = 0;
+    uint32_t remaining = 0;
+    int64_t previousRequest = 0;
+    int slot = -1;
+
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; position < block.size(); shift += 7) {
+            uint8_t byte = block[position++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        return value;
+    }
+
+    bool loadBlock() {
+        BlockHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (header.magic != BLOCK_MAGIC) {
+            corruptBlocks++;
+            return false;
+        }
+        block.resize(header.bytes);
+        if (!in.read(reinterpret_cast<char*>(block.data()), header.bytes) || fnv1a(block.data(), block.size()) != header.checksum) {
+            corruptBlocks++; // Truncated or damaged tail: stop at the last good block
+            return false;
+        }
+        position = 0;
+        remaining = header.records;
+        previousRequest = 0;
+        blocks++;
+        return true;
+    }
+
+public:
+    std::vector<double> weights = std::vector<double>(4, 0.0); // Weights of the current slot
+    long long blocks = 0;
+    long long corruptBlocks = 0;
+
+    explicit AuditReader(const std::string& path) : in(path, std::ios::binary) {}
+
+    bool ok() const { return static_cast<bool>(in); }
+
+    // Next decision; slot records are applied on the way
+    bool next(Decision& decision) {
+        for (;;) {
+            if (remaining == 0 && !loadBlock()) return false;
+            remaining--;
+            uint8_t tag = block[position++];
+            if (tag == SlotRecord) {
+                slot = static_cast<int>(getVarint());
+                for (int i = 0; i < 4; ++i) {
+                    std::memcpy(&weights[i], &block[position], sizeof(double));
+                    position += sizeof(double);
+                }
+                continue;
+            }
+            decision.slot = slot;
+            decision.request = static_cast<int>(previousRequest += unzigzag(getVarint()));
+            decision.rsu = static_cast<int>(getVarint()) - 1;
+            decision.runnerUp = static_cast<int>(getVarint()) - 1;
+            decision.computation = decision.retention = decision.transfer = decision.preparation = 0.0;
+            decision.runnerUpCost = std::numeric_limits<double>::infinity();
+            if (decision.rsu >= 0) {
+                decision.computation = getVarint() * COST_QUANTUM;
+                decision.retention = getVarint() * COST_QUANTUM;
+                decision.transfer = getVarint() * COST_QUANTUM;
+                decision.preparation = getVarint() * COST_QUANTUM;
+                if (decision.runnerUp >= 0) {
+                    decision.runnerUpCost = decision.computation + decision.retention + decision.transfer + decision.preparation +
+                                            getVarint() * COST_QUANTUM;
+                }
+            }
+            return true;
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Scheduling workload: the RS-MAS slot loop of 6_AVSDSF_final.cpp at scale
+// ---------------------------------------------------------------------------
+
+enum class AuditMode { None, Binary, Text };
+
+struct RunResult {
+    double seconds = 0.0;
+    long long decisions = 0;
+    uint64_t fingerprint = 1469598103934665603ull; // FNV over (slot, request, rsu, runnerUp)
+    double totalCost = 0.0;
+    long long stalls = 0;
+    uint64_t bytes = 0;
+};
+
+inline void fold(uint64_t& hash, int64_t value) { hash = (hash ^ static_cast<uint64_t>(value)) * 1099511628211ull; }
+
+RunResult runSlots(std::vector<RSU> rsus, std::vector<ServiceRequest> requests, AuditMode mode, const std::string& path) {
+    RunResult result;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<> dis(0.9, 1.1);
+    AuditWriter* binary = mode == AuditMode::Binary ? new AuditWriter(path) : nullptr;
+    if (binary && !binary->ok()) std::cerr << "Cannot open " << path << " for writing" << std::endl;
+    std::ofstream text;
+    if (mode == AuditMode::Text) text.open(path);
+
+    auto start = Clock::now();
+    for (int t = 0; t < NUM_SLOTS; ++t) {
+        for (auto& request : requests) request.computationLoad = std::clamp(request.computationLoad * dis(gen), 5.0, 40.0);
+        // Weights follow the load the previous slot left behind, then its capacity is released
+        std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+        for (auto& rsu : rsus) {
+            rsu.computationCost = std::clamp(rsu.computationCost * dis(gen), 0.005, 0.08);
+            rsu.usedCapacity = 0.0;
+        }
+        if (binary) binary->beginSlot(t, weights);
+        if (mode == AuditMode::Text) text << "slot " << t << " weights " << weights[0] << " " << weights[1] << " " << weights[2] << " " << weights[3] << "\n";
+
+        for (const auto& request : requests) {
+            double minCost = std::numeric_limits<double>::max(), secondCost = minCost;
+            int best = -1, second = -1;
+            for (const auto& rsu : rsus) {
+                if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                    double cost = computePlacementCost(request, rsu, weights);
+                    if (cost < minCost) {
+                        secondCost = minCost;
+                        second = best;
+                        minCost = cost;
+                        best = rsu.id;
+                    } else if (cost < secondCost) {
+                        secondCost = cost;
+                        second = rsu.id;
+                    }
+                }
+            }
+            if (best >= 0) {
+                rsus[best].usedCapacity += request.computationLoad;
+                result.totalCost += minCost;
+            }
+            result.decisions++;
+            fold(result.fingerprint, t);
+            fold(result.fingerprint, request.id);
+            fold(result.fingerprint, best);
+            fold(result.fingerprint, second);
+            if (mode == AuditMode::None) continue;
+
+            Decision decision{t, request.id, best, second, 0.0, 0.0, 0.0, 0.0, secondCost};
+            if (best >= 0) {
+                const RSU& chosen = rsus[best];
+                decision.computation = weights[0] * chosen.computationCost * request.computationLoad;
+                decision.retention = weights[1] * chosen.retentionCost;
+                decision.transfer = weights[2] * request.transferCost;
+                decision.preparation = weights[3] * request.preparationCost;
+            }
+            if (binary) {
+                binary->record(decision);
+            } else {
+                text << decision.slot << " " << decision.request << " " << decision.rsu << " " << decision.runnerUp << " "
+                     << decision.computation << " " << decision.retention << " " << decision.transfer << " "
+                     << decision.preparation << " " << decision.runnerUpCost << "\n";
+            }
+        }
+    }
+    if (binary) {
+        binary->close();
+        result.stalls = binary->stalls;
+        result.bytes = binary->bytesWritten;
+        delete binary;
+    }
+    if (mode == AuditMode::Text) {
+        text.close();
+        std::ifstream size(path, std::ios::binary | std::ios::ate);
+        result.bytes = static_cast<uint64_t>(size.tellg());
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+// Offline tool: summary, optional per-request explanation
+int readLog(const std::string& path, int explainRequest) {
+    AuditReader reader(path);
+    if (!reader.ok()) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+    long long decisions = 0, dropped = 0, withRunnerUp = 0;
+    double marginSum = 0.0, costSum = 0.0;
+    int lastSlot = -1;
+    Decision decision;
+    std::cout << std::fixed << std::setprecision(6);
+    while (reader.next(decision)) {
+        decisions++;
+        lastSlot = decision.slot;
+        if (decision.rsu < 0) {
+            dropped++;
+        } else {
+            double chosen = decision.computation + decision.retention + decision.transfer + decision.preparation;
+            costSum += chosen;
+            if (decision.runnerUp >= 0) {
+                withRunnerUp++;
+                marginSum += decision.runnerUpCost - chosen;
+            }
+        }
+        if (decision.request == explainRequest) {
+            std::cout << "Slot " << decision.slot << ": request " << decision.request;
+            if (decision.rsu < 0) {
+                std::cout << " dropped (no RSU with capacity)" << std::endl;
+                continue;
+            }
+            std::cout << " -> RSU " << decision.rsu << ", cost = computation " << decision.computation << " + retention "
+                      << decision.retention << " + transfer " << decision.transfer << " + preparation " << decision.preparation
+                      << ", weights = [" << reader.weights[0] << ", " << reader.weights[1] << ", " << reader.weights[2] << ", "
+                      << reader.weights[3] << "]";
+            if (decision.runnerUp >= 0) {
+                double chosen = decision.computation + decision.retention + decision.transfer + decision.preparation;
+                std::cout << ", runner-up RSU " << decision.runnerUp << " (+" << decision.runnerUpCost - chosen << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "Blocks = " << reader.blocks << (reader.corruptBlocks ? " (stopped at a damaged block)" : "")
+              << ", Slots = " << lastSlot + 1 << ", Decisions = " << decisions << ", Dropped = " << dropped
+              << ", Total Cost = " << costSum << ", Mean runner-up margin = " << (withRunnerUp ? marginSum / withRunnerUp : 0.0) << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // Offline reader: <prog> read <log> [request id to explain]
+    if (argc >= 3 && std::string(argv[1]) == "read") return readLog(argv[2], argc > 3 ? std::atoi(argv[3]) : -1);
+
+    std::string path = argc > 1 ? argv[1] : "avsdsf_audit.bin";
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(NUM_RSUS, NUM_REQUESTS, 1, 67, rsus, requests, services, 1.3);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "RSUs = " << NUM_RSUS << ", decisions per run = " << static_cast<long long>(NUM_REQUESTS) * NUM_SLOTS
+              << ", best of " << RUNS << " runs\n" << std::endl;
+
+    auto best = [&](AuditMode mode, const std::string& file) {
+        RunResult fastest;
+        fastest.seconds = std::numeric_limits<double>::max();
+        for (int run = 0; run < RUNS; ++run) {
+            RunResult result = runSlots(rsus, requests, mode, file);
+            if (result.seconds < fastest.seconds) fastest = result;
+        }
+        return fastest;
+    };
+    RunResult plain = best(AuditMode::None, "");
+    RunResult audited = best(AuditMode::Binary, path);
+    RunResult printed = best(AuditMode::Text, path + ".txt");
+    std::remove((path + ".txt").c_str());
+
+    auto report = [&](const char* name, const RunResult& result) {
+        std::cout << name << ": " << result.decisions / result.seconds / 1e6 << " M decisions/sec, overhead = "
+                  << (result.seconds / plain.seconds - 1.0) * 100.0 << "%";
+        if (result.bytes) std::cout << ", " << static_cast<double>(result.bytes) / result.decisions << " bytes/decision";
+        std::cout << std::endl;
+    };
+    report("No audit      ", plain);
+    report("Binary log    ", audited);
+    std::cout << "    writer stalls = " << audited.stalls << std::endl;
+    report("Text log      ", printed);
+
+    // Read the binary log back and check it against the run that wrote it
+    AuditReader reader(path);
+    Decision decision;
+    RunResult decoded;
+    while (reader.next(decision)) {
+        decoded.decisions++;
+        fold(decoded.fingerprint, decision.slot);
+        fold(decoded.fingerprint, decision.request);
+        fold(decoded.fingerprint, decision.rsu);
+        fold(decoded.fingerprint, decision.runnerUp);
+        if (decision.rsu >= 0) decoded.totalCost += decision.computation + decision.retention + decision.transfer + decision.preparation;
+    }
+    bool matches = decoded.decisions == audited.decisions && decoded.fingerprint == audited.fingerprint &&
+                   std::fabs(decoded.totalCost - audited.totalCost) <= audited.decisions * 4 * COST_QUANTUM;
+    std::cout << "\nRead back " << decoded.decisions << " decisions from " << path << " (" << reader.blocks << " blocks): "
+              << (matches ? "matches" : "DIFFERS from") << " the scheduler's decisions" << std::endl;
+    std::cout << "Explain a request with: " << argv[0] << " read " << path << " <request id>" << std::endl;
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+/*
+AVSDSF - Long-running slot simulation with a live Prometheus metrics endpoint
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
+#include <csignal>
+#include "avsdsf_model.h"
+#include "avsdsf_metrics.h"
+
+const int NUM_RSUS = 400;
+const int REQUESTS_PER_SLOT = 4000;     // Per region worker
+const int NUM_SERVICES = 20;
+const double PREFETCH_HIT_FACTOR = 0.2;  // Preparation cost left when the image is prefetched on the RSU
+const double IMAGE_CAPACITY_SHARE = 0.3; // Fraction of RSU capacity usable for prefetched images
+const double FORECAST_SMOOTHING = 0.5;   // EWMA weight of the newest slot in the demand forecast
+const double CLOUD_LATENCY = 3.0;        // A request no RSU can hold is offloaded if its deadline allows this
+const int DEFAULT_PORT = 9464;
+const int SCRAPE_INTERVAL_MS = 10;       // Self-check scraper; Prometheus itself scrapes every 15 s by default
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<bool> stopRequested{false};
+
+extern "C" void onStopSignal(int) { stopRequested.store(true); }
+
+// Everything the scheduler reports; registered once, then updated lock-free
+struct SchedulerMetrics {
+    Counter& scheduled;
+    Counter& dropped;
+    Counter& offloaded;
+    Counter& prefetchHits;
+    Counter& prefetchMisses;
+    Counter& slots;
+    Histogram& slotLatency;
+    std::vector<Gauge*> utilization; // Per RSU id
+
+    SchedulerMetrics(MetricsRegistry& registry, int numRSUs)
+        : scheduled(registry.counter("avsdsf_requests_scheduled_total", "Requests placed on an RSU")),
+          dropped(registry.counter("avsdsf_requests_dropped_total", "Requests neither placed nor offloadable before their deadline")),
+          offloaded(registry.counter("avsdsf_requests_offloaded_total", "Requests sent to the cloud because no RSU had capacity")),
+          prefetchHits(registry.counter("avsdsf_prefetch_hits_total", "Placements on an RSU that had the service image prefetched")),
+          prefetchMisses(registry.counter("avsdsf_prefetch_misses_total", "Placements on an RSU without the service image")),
+          slots(registry.counter("avsdsf_slots_total", "Time slots completed by all region workers")),
+          slotLatency(registry.histogram("avsdsf_slot_duration_seconds", "Wall time to plan, schedule and account one slot of a region",
+                                         {0.0005, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0})) {
+        for (int r = 0; r < numRSUs; ++r) {
+            utilization.push_back(&registry.gauge("avsdsf_rsu_utilization", "Used over maximum capacity at the end of the last slot",
+                                                  "rsu=\"" + std::to_string(r) + "\""));
+        }
+    }
+};
+
+// One region: its own RSUs and requests, scheduled slot after slot by one thread
+class RegionWorker {
+private:
+    int firstRSU;
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    std::vector<int> requestService;
+    std::vector<double> demand;   // Forecast per (local RSU, service)
+    std::vector<double> observed;
+    std::vector<char> prefetched;
+    SchedulerMetrics& metrics;
+    std::mt19937 gen;
+    std::discrete_distribution<int> popularity;
+
+    void planPrefetch() {
+        prefetched.assign(rsus.size() * NUM_SERVICES, 0);
+        std::vector<std::pair<double, int>> ranking(NUM_SERVICES);
+        for (size_t r = 0; r < rsus.size(); ++r) {
+            for (int s = 0; s < NUM_SERVICES; ++s) ranking[s] = {demand[r * NUM_SERVICES + s] / services[s].size, s};
+            std::sort(ranking.rbegin(), ranking.rend());
+            double remainingCapacity = rsus[r].maxCapacity * IMAGE_CAPACITY_SHARE;
+            for (const auto& [score, s] : ranking) {
+                if (score <= 0.0) break;
+                if (services[s].size <= remainingCapacity) {
+                    prefetched[r * NUM_SERVICES + s] = 1;
+                    remainingCapacity -= services[s].size;
+                    rsus[r].usedCapacity += services[s].size; // Prefetched images occupy capacity
+                }
+            }
+        }
+    }
+
+public:
+    RegionWorker(int index, int numRSUs, int first, SchedulerMetrics& registryMetrics)
+        : firstRSU(first), metrics(registryMetrics), gen(101 + index) {
+        generateScenario(numRSUs, REQUESTS_PER_SLOT, NUM_SERVICES, 71 + index, rsus, requests, services, 1.2);
+        demand.assign(rsus.size() * NUM_SERVICES, 0.0);
+        observed.assign(rsus.size() * NUM_SERVICES, 0.0);
+        std::vector<double> weights;
+        for (int s = 0; s < NUM_SERVICES; ++s) weights.push_back(1.0 / (s + 1)); // Zipf-like service popularity
+        popularity = std::discrete_distribution<int>(weights.begin(), weights.end());
+        requestService.resize(requests.size());
+    }
+
+    void runSlot() {
+        auto start = Clock::now();
+        std::uniform_real_distribution<> dis(0.9, 1.1);
+        std::uniform_real_distribution<> load(12.0, 35.0); // Fresh arrivals each slot, same ranges as generateScenario
+        std::uniform_real_distribution<> deadline(2.0, 5.0);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            requests[i].computationLoad = load(gen);
+            requests[i].deadline = deadline(gen);
+            requestService[i] = popularity(gen);
+        }
+        for (auto& rsu : rsus) {
+            rsu.computationCost = std::clamp(rsu.computationCost * dis(gen), 0.005, 0.08);
+            rsu.retentionCost = std::clamp(rsu.retentionCost * dis(gen), 0.005, 0.08);
+            rsu.usedCapacity = 0.0;
+        }
+        planPrefetch();
+        std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+
+        std::fill(observed.begin(), observed.end(), 0.0);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const auto& request = requests[i];
+            double minCost = std::numeric_limits<double>::max();
+            int bestRSU = -1;
+            for (const auto& rsu : rsus) {
+                if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                    double cost = computePlacementCost(request, rsu, weights);
+                    if (prefetched[rsu.id * NUM_SERVICES + requestService[i]]) cost -= weights[3] * request.preparationCost * (1.0 - PREFETCH_HIT_FACTOR);
+                    if (cost < minCost) {
+                        minCost = cost;
+                        bestRSU = rsu.id;
+                    }
+                }
+            }
+            if (bestRSU == -1) {
+                if (request.deadline >= CLOUD_LATENCY) metrics.offloaded.inc();
+                else metrics.dropped.inc();
+                continue;
+            }
+            rsus[bestRSU].usedCapacity += request.computationLoad;
+            observed[bestRSU * NUM_SERVICES + requestService[i]] += 1.0;
+            metrics.scheduled.inc();
+            if (prefetched[bestRSU * NUM_SERVICES + requestService[i]]) metrics.prefetchHits.inc();
+            else metrics.prefetchMisses.inc();
+        }
+
+        for (size_t i = 0; i < demand.size(); ++i) {
+            demand[i] = FORECAST_SMOOTHING * observed[i] + (1.0 - FORECAST_SMOOTHING) * demand[i];
+        }
+        for (const auto& rsu : rsus) metrics.utilization[firstRSU + rsu.id]->set(rsu.usedCapacity / rsu.maxCapacity);
+        metrics.slots.inc();
+        metrics.slotLatency.observe(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+};
+
+// Body of GET /metrics, or empty on failure
+std::string scrape(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string response;
+    const std::string request = "GET /metrics HTTP/1.0\r\nHost: 127.0.0.1\r\n\r\n";
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+        send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size())) {
+        char buffer[1 << 16];
+        for (ssize_t n; (n = recv(fd, buffer, sizeof(buffer), 0)) > 0;) response.append(buffer, static_cast<size_t>(n));
+    }
+    if (fd >= 0) close(fd);
+    size_t body = response.find("\r\n\r\n");
+    if (response.compare(0, 12, "HTTP/1.0 200") != 0 || body == std::string::npos) return "";
+    return response.substr(body + 4);
+}
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::max(0, std::atoi(argv[1])) : 10; // 0 runs until SIGINT/SIGTERM
+    int port = argc > 2 ? std::atoi(argv[2]) : DEFAULT_PORT;
+    int numWorkers = argc > 3 ? std::clamp(std::atoi(argv[3]), 1, NUM_RSUS) : 2;
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    MetricsRegistry registry;
+    SchedulerMetrics metrics(registry, NUM_RSUS);
+    MetricsServer server(registry, port);
+    if (server.ok()) std::cout << "Serving metrics at http://127.0.0.1:" << server.port() << "/metrics" << std::endl;
+    else std::cout << "No metrics endpoint (" << server.error << "); running without it" << std::endl;
+    std::cout << "RSUs = " << NUM_RSUS << " in " << numWorkers << " regions, " << REQUESTS_PER_SLOT << " requests per region and slot, "
+              << (seconds ? std::to_string(seconds) + " s" : std::string("until interrupted")) << "\n" << std::endl;
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < numWorkers; ++w) {
+        int first = NUM_RSUS * w / numWorkers;
+        int count = NUM_RSUS * (w + 1) / numWorkers - first;
+        workers.emplace_back([&, w, first, count] {
+            RegionWorker region(w, count, first, metrics);
+            while (!stopRequested.load(std::memory_order_relaxed)) region.runSlot();
+        });
+    }
+
+    // Scraping self-check over the second half of a timed run: an aggressive
+    // scraper thread must not slow the scheduling threads down
+    std::atomic<bool> scraping{false};
+    std::vector<double> scrapeMillis;
+    size_t lastBodySize = 0;
+    bool bodiesOk = true;
+    std::thread scraper;
+    uint64_t slotsAtHalf = 0;
+    double halfSeconds = seconds / 2.0;
+
+    auto start = Clock::now();
+    std::cout << std::fixed << std::setprecision(1);
+    for (int tick = 1; !stopRequested.load() && (seconds == 0 || tick <= seconds); ++tick) {
+        std::this_thread::sleep_until(start + std::chrono::seconds(tick));
+        if (seconds > 0 && server.ok() && tick == static_cast<int>(halfSeconds) && halfSeconds >= 1.0) {
+            slotsAtHalf = metrics.slots.value();
+            scraping.store(true);
+            scraper = std::thread([&] {
+                while (scraping.load()) {
+                    auto sent = Clock::now();
+                    std::string body = scrape(server.port());
+                    scrapeMillis.push_back(std::chrono::duration<double, std::milli>(Clock::now() - sent).count());
+                    bodiesOk = bodiesOk && body.find("avsdsf_requests_scheduled_total") != std::string::npos;
+                    lastBodySize = body.size();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(SCRAPE_INTERVAL_MS));
+                }
+            });
+        }
+        uint64_t placed = metrics.scheduled.value();
+        uint64_t hits = metrics.prefetchHits.value();
+        std::cout << std::setw(4) << tick << " s: slots = " << metrics.slots.value() << ", scheduled = " << placed
+                  << ", offloaded = " << metrics.offloaded.value() << ", dropped = " << metrics.dropped.value()
+                  << ", prefetch hit rate = " << (placed ? 100.0 * hits / placed : 0.0) << "%, scrapes = " << server.scrapes.load() << std::endl;
+    }
+    uint64_t slotsAtEnd = metrics.slots.value();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    stopRequested.store(true);
+    for (auto& worker : workers) worker.join();
+    scraping.store(false);
+    if (scraper.joinable()) scraper.join();
+
+    if (!scrapeMillis.empty()) {
+        double quiet = slotsAtHalf / std::max(1.0, std::floor(halfSeconds));
+        double scraped = (slotsAtEnd - slotsAtHalf) / std::max(1e-9, elapsed - std::floor(halfSeconds));
+        std::sort(scrapeMillis.begin(), scrapeMillis.end());
+        std::cout << "\nSlots/sec without scraping = " << quiet << ", while scraped every " << SCRAPE_INTERVAL_MS << " ms = " << scraped
+                  << " (" << std::showpos << 100.0 * (scraped - quiet) / quiet << std::noshowpos << "%)" << std::endl;
+        std::cout << std::setprecision(3) << "Scrapes = " << scrapeMillis.size() << ", latency p50 = " << scrapeMillis[scrapeMillis.size() / 2]
+                  << " ms, max = " << scrapeMillis.back() << " ms, body = " << lastBodySize << " bytes, "
+                  << (bodiesOk ? "all scrapes well-formed" : "MALFORMED SCRAPE") << std::endl;
+    }
+    return bodiesOk ? 0 : 1;
+}
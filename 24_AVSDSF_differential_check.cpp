@@ -0,0 +1,792 @@
+/*
+AVSDSF - Differential fuzzing of optimized scheduler kernels against the reference implementations
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include "avsdsf_model.h"
+
+const int DEFAULT_CASES = 2000;
+const double RELATIVE_TOLERANCE = 1e-9; // Optimized kernels may reassociate floating-point arithmetic
+const size_t MAX_REPORTED = 5;          // Failures printed per kernel
+const double PBO_THRESHOLD_MAX = 0.5;   // Thresholds 2_PBO_final.cpp runs with
+const double PBO_THRESHOLD_MIN = 0.1;
+
+bool withinTolerance(double a, double b) {
+    return std::fabs(a - b) <= RELATIVE_TOLERANCE * std::max({1.0, std::fabs(a), std::fabs(b)});
+}
+
+// Decisions compared for one kernel over all cases. A "tie" is a different
+// choice whose reference cost is within tolerance of the reference choice.
+struct KernelReport {
+    std::string name;
+    long long cases = 0;
+    long long decisions = 0;
+    long long ties = 0;
+    long long mismatches = 0;
+    std::vector<std::string> failures;
+
+    explicit KernelReport(std::string kernel) : name(std::move(kernel)) {}
+
+    void fail(unsigned caseSeed, const std::string& detail) {
+        mismatches++;
+        if (failures.size() < MAX_REPORTED) failures.push_back("seed " + std::to_string(caseSeed) + ": " + detail);
+    }
+};
+
+// Random topology with deliberate edge cases: RSUs that are exact twins,
+// preloaded RSUs, zero loads and cost magnitudes that swamp small differences
+struct Topology {
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+};
+
+Topology randomTopology(std::mt19937& gen) {
+    std::uniform_int_distribution<> numRSUs(1, 64), numRequests(0, 256), numServices(0, 6);
+    std::uniform_real_distribution<> capacityFactor(0.2, 2.0), unit(0.0, 1.0);
+    Topology t;
+    int rsuCount = numRSUs(gen), requestCount = numRequests(gen), serviceCount = numServices(gen);
+    generateScenario(rsuCount, requestCount, serviceCount, gen(), t.rsus, t.requests, t.services, capacityFactor(gen));
+    std::uniform_int_distribution<size_t> pickRSU(0, t.rsus.size() - 1);
+    for (auto& rsu : t.rsus) {
+        if (unit(gen) < 0.15) {
+            const RSU& twin = t.rsus[pickRSU(gen)];
+            rsu.maxCapacity = twin.maxCapacity;
+            rsu.computationCost = twin.computationCost;
+            rsu.retentionCost = twin.retentionCost;
+        }
+        if (unit(gen) < 0.1) rsu.usedCapacity = rsu.maxCapacity * unit(gen);
+        if (unit(gen) < 0.05) rsu.computationCost *= 1e6;
+    }
+    for (auto& request : t.requests) {
+        if (unit(gen) < 0.05) request.computationLoad = 0.0;
+        if (unit(gen) < 0.03) request.transferCost *= 1e12;
+    }
+    return t;
+}
+
+// ---------------------------------------------------------------------------
+// Reference kernels, transcribed from the original programs. Randomness is
+// kept out of the kernels (6_ varies parameters before each slot) or drawn
+// from a generator the harness seeds, so both sides see identical inputs.
+// Decision vectors are indexed by request id; -1 means not placed.
+// ---------------------------------------------------------------------------
+
+// 6_AVSDSF_final.cpp main_algorithm, prefetch phase
+void referencePrefetch(std::vector<RSU>& rsus, const std::vector<PrefetchedService>& services, std::vector<int>& P) {
+    for (auto& rsu : rsus) {
+        double remainingCapacity = rsu.maxCapacity - rsu.usedCapacity;
+        for (auto& service : services) {
+            if (service.size <= remainingCapacity) {
+                P[service.id] = 1;
+                remainingCapacity -= service.size;
+                rsu.usedCapacity += service.size;
+            }
+        }
+    }
+}
+
+// 6_AVSDSF_final.cpp main_algorithm, schedule phase
+void referenceSchedule(const std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, const std::vector<double>& weights, std::vector<int>& X) {
+    for (auto& request : requests) {
+        double minCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                double cost = weights[0] * rsu.computationCost * request.computationLoad +
+                             weights[1] * rsu.retentionCost +
+                             weights[2] * request.transferCost +
+                             weights[3] * request.preparationCost;
+                if (cost < minCost) {
+                    minCost = cost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            X[request.id] = bestRSU;
+            rsus[bestRSU].usedCapacity += request.computationLoad;
+        }
+    }
+}
+
+double referenceTransferCost(const ServiceRequest& request, const RSU& rsu) {
+    double workloadPenalty = rsu.usedCapacity / rsu.maxCapacity;
+    return request.distanceToRSU + TRANSFER_COST_MULTIPLIER * workloadPenalty;
+}
+
+// 6_AVSDSF_final.cpp main_algorithm, transfer phase
+void referenceTransfer(const std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, std::vector<int>& T) {
+    for (auto& request : requests) {
+        double minTransferCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.demand <= rsu.maxCapacity) {
+                double transferCost = referenceTransferCost(request, rsu);
+                if (transferCost < minTransferCost) {
+                    minTransferCost = transferCost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            T[request.id] = bestRSU;
+            rsus[bestRSU].usedCapacity += request.demand;
+        }
+    }
+}
+
+// 6_AVSDSF_final.cpp main_algorithm, cost phase. Requests that were never
+// placed are skipped (6_ throws from decisions.X.at on them).
+std::pair<double, double> referenceCost(const std::vector<ServiceRequest>& requests, const std::vector<RSU>& rsus,
+                                        const std::vector<PrefetchedService>& services, const std::vector<int>& X, const std::vector<int>& P) {
+    double totalCost = 0.0;
+    double totalLatency = 0.0;
+    for (const auto& request : requests) {
+        if (X[request.id] < 0) continue;
+        const auto& rsu = rsus[X[request.id]];
+        totalCost += rsu.computationCost * request.computationLoad +
+                     rsu.retentionCost +
+                     request.transferCost +
+                     request.preparationCost;
+        totalLatency += request.computationLoad * rsu.computationCost;
+        totalLatency += request.transferCost;
+    }
+    for (const auto& service : services) {
+        if (P[service.id] == 1) totalCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
+    }
+    return {totalCost, totalLatency};
+}
+
+// 1_ONCO_final.cpp calculateDynamicWeights; the previous load is kept per run instead of in globals
+class OncoWeights {
+private:
+    double previousLoad = 0.0;
+
+public:
+    std::vector<double> next(double load) {
+        std::vector<double> weights(4);
+        double slope = previousLoad != 0.0 ? (load - previousLoad) / previousLoad : 0.0;
+        if (load <= 0.4) {
+            weights = {0.5, 0.2, 0.2, 0.1};
+        } else if (load <= 0.7) {
+            weights = {0.4 + slope * 0.1, 0.3 + slope * 0.05, 0.2 - slope * 0.05, 0.1 - slope * 0.05};
+        } else {
+            weights = {0.3 + slope * 0.1, 0.4 + slope * 0.1, 0.2 - slope * 0.05, 0.1 - slope * 0.05};
+        }
+        double sum = weights[0] + weights[1] + weights[2] + weights[3];
+        for (auto& w : weights) w /= sum;
+        previousLoad = load;
+        return weights;
+    }
+};
+
+// 1_ONCO_final.cpp scheduleRequests (its computeCost is computePlacementCost)
+void referenceScheduleRequests(const std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, const std::vector<double>& weights, std::vector<int>& X) {
+    for (auto& request : requests) {
+        double minCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                double cost = computePlacementCost(request, rsu, weights);
+                if (cost < minCost) {
+                    minCost = cost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            X[request.id] = bestRSU;
+            rsus[bestRSU].usedCapacity += request.computationLoad;
+        }
+    }
+}
+
+// 2_PBO_final.cpp compute unit and pressure model
+struct ComputeUnit {
+    std::string id;
+    double cpu_usage;
+    double network_latency;
+    int function_replicas;
+    int max_capacity;
+};
+
+double referencePressure(const ComputeUnit& unit) {
+    double pREQ = static_cast<double>(unit.function_replicas) / unit.max_capacity;
+    double pRTT = 1 / (1 + std::exp(-0.2 * (unit.network_latency - 70.0)));
+    double pRES = unit.cpu_usage / 100.0;
+    return pREQ * pRTT * pRES;
+}
+
+// 2_PBO_final.cpp scaleFunctions
+void referenceScaleFunctions(std::vector<ComputeUnit>& units, double threshold_max, double threshold_min) {
+    for (auto& unit : units) {
+        double pressure = referencePressure(unit);
+        if (pressure > threshold_max && unit.function_replicas < unit.max_capacity) {
+            unit.function_replicas++;
+        } else if (pressure < threshold_min && unit.function_replicas > 1) {
+            unit.function_replicas--;
+        }
+    }
+}
+
+// 2_PBO_final.cpp findBestPlacement, returning an index instead of a pointer
+int referenceFindBestPlacement(const std::vector<ComputeUnit>& units, double threshold_max) {
+    int bestUnit = -1;
+    double lowestPressure = threshold_max;
+    for (size_t u = 0; u < units.size(); ++u) {
+        if (units[u].function_replicas < units[u].max_capacity) {
+            double pressure = referencePressure(units[u]);
+            if (pressure < lowestPressure) {
+                lowestPressure = pressure;
+                bestUnit = static_cast<int>(u);
+            }
+        }
+    }
+    return bestUnit;
+}
+
+// 5_LDLS_final.cpp model
+struct Layer {
+    int id;
+    double size;
+    bool existsLocally;
+    double downloadTime;
+};
+
+struct Image {
+    int id;
+    std::vector<int> layers;
+};
+
+struct EdgeNode {
+    int id;
+    double cpuFrequency;
+    double bandwidth;
+    double storageCapacity;
+    int maxContainers;
+    std::vector<int> localLayers;
+};
+
+struct Task {
+    int id;
+    int requestedImage;
+    double cpuRequirement;
+    double dataSize;
+    double computationRequirement;
+};
+
+// 5_LDLS_final.cpp extractFeatures and scheduleTask. Each node's action value
+// can be recorded so the harness can cost a diverging choice.
+class ReferenceLdls {
+private:
+    std::vector<EdgeNode> nodes;
+    std::vector<Image> images;
+    std::unordered_map<int, Layer> layers;
+
+    double extractFeatures(const Task& task, const EdgeNode& node) {
+        double score = 0.0;
+        for (int layerID : images[task.requestedImage].layers) {
+            if (std::find(node.localLayers.begin(), node.localLayers.end(), layerID) != node.localLayers.end()) {
+                double layerSize = layers[layerID].size * std::uniform_real_distribution<>(0.95, 1.05)(gen);
+                score += layerSize;
+            }
+        }
+        return score;
+    }
+
+public:
+    std::mt19937 gen;
+
+    ReferenceLdls(std::vector<EdgeNode> n, std::vector<Image> i, const std::vector<Layer>& l, unsigned seed)
+        : nodes(std::move(n)), images(std::move(i)), gen(seed) {
+        for (const auto& layer : l) layers[layer.id] = layer;
+    }
+
+    int scheduleTask(const Task& task, std::vector<double>* actionValues = nullptr) {
+        int bestNode = -1;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (auto& node : nodes) {
+            if (node.maxContainers <= 0 || node.storageCapacity <= 0) continue;
+            double featureScore = extractFeatures(task, node);
+            double randomFactor = std::uniform_real_distribution<>(0.95, 1.05)(gen);
+            double actionValue = (featureScore / (node.cpuFrequency * node.bandwidth)) * randomFactor;
+            if (actionValues) (*actionValues)[node.id] = actionValue;
+            if (actionValue > bestScore) {
+                bestScore = actionValue;
+                bestNode = node.id;
+            }
+        }
+        return bestNode;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Optimized kernels. Each keeps the reference's decision rule but not its
+// arithmetic: request-constant terms are dropped from argmins, invariant
+// factors are precomputed and RSU state is column-major.
+// ---------------------------------------------------------------------------
+
+// Column-major RSU state for the argmin loops
+struct RSUColumns {
+    std::vector<double> used;
+    std::vector<double> max;
+    std::vector<double> computation;
+    std::vector<double> retention;
+
+    explicit RSUColumns(const std::vector<RSU>& rsus) {
+        for (const auto& rsu : rsus) {
+            used.push_back(rsu.usedCapacity);
+            max.push_back(rsu.maxCapacity);
+            computation.push_back(rsu.computationCost);
+            retention.push_back(rsu.retentionCost);
+        }
+    }
+};
+
+// Transfer and preparation terms are the same on every RSU, so the argmin
+// compares only weights[0] * computation * load + weights[1] * retention
+void optimizedSchedule(const std::vector<ServiceRequest>& requests, RSUColumns& rsus, const std::vector<double>& weights, std::vector<int>& X) {
+    size_t n = rsus.used.size();
+    std::vector<double> perLoad(n), fixed(n);
+    for (size_t r = 0; r < n; ++r) {
+        perLoad[r] = weights[0] * rsus.computation[r];
+        fixed[r] = weights[1] * rsus.retention[r];
+    }
+    for (const auto& request : requests) {
+        double load = request.computationLoad;
+        double best = std::numeric_limits<double>::infinity();
+        int bestRSU = -1;
+        for (size_t r = 0; r < n; ++r) {
+            if (rsus.used[r] + load <= rsus.max[r]) {
+                double key = perLoad[r] * load + fixed[r];
+                if (key < best) {
+                    best = key;
+                    bestRSU = static_cast<int>(r);
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            X[request.id] = bestRSU;
+            rsus.used[bestRSU] += load;
+        }
+    }
+}
+
+// Deliberately wrong variant (ignores retention cost) used to check that the harness catches real divergence
+void faultyScheduleWithoutRetention(const std::vector<ServiceRequest>& requests, RSUColumns& rsus, const std::vector<double>& weights, std::vector<int>& X) {
+    RSUColumns withoutRetention = rsus;
+    std::fill(withoutRetention.retention.begin(), withoutRetention.retention.end(), 0.0);
+    optimizedSchedule(requests, withoutRetention, weights, X);
+    rsus.used = withoutRetention.used;
+}
+
+// The distance term is per request, so only the workload ratio is compared
+void optimizedTransfer(const std::vector<ServiceRequest>& requests, RSUColumns& rsus, std::vector<int>& T) {
+    size_t n = rsus.used.size();
+    for (const auto& request : requests) {
+        double best = std::numeric_limits<double>::infinity();
+        int bestRSU = -1;
+        for (size_t r = 0; r < n; ++r) {
+            if (rsus.used[r] + request.demand <= rsus.max[r]) {
+                double ratio = rsus.used[r] / rsus.max[r];
+                if (ratio < best) {
+                    best = ratio;
+                    bestRSU = static_cast<int>(r);
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            T[request.id] = bestRSU;
+            rsus.used[bestRSU] += request.demand;
+        }
+    }
+}
+
+std::pair<double, double> optimizedCost(const std::vector<ServiceRequest>& requests, const RSUColumns& rsus,
+                                        const std::vector<PrefetchedService>& services, const std::vector<int>& X, const std::vector<int>& P) {
+    double rsuTerms = 0.0, requestTerms = 0.0, computeLatency = 0.0;
+    for (const auto& request : requests) {
+        int r = X[request.id];
+        if (r < 0) continue;
+        double compute = rsus.computation[r] * request.computationLoad;
+        rsuTerms += compute + rsus.retention[r];
+        requestTerms += request.transferCost + request.preparationCost;
+        computeLatency += compute + request.transferCost;
+    }
+    double prefetch = 0.0;
+    for (const auto& service : services) {
+        if (P[service.id] == 1) prefetch += service.prefetchCost;
+    }
+    return {rsuTerms + requestTerms + PREFETCH_COST_MULTIPLIER * prefetch, computeLatency};
+}
+
+// The RTT pressure depends only on network latency, so it is cached per unit
+// together with the unit's capacity and the percent scale
+class PressureIndex {
+private:
+    std::vector<double> scale; // pRTT / (max_capacity * 100)
+
+public:
+    explicit PressureIndex(const std::vector<ComputeUnit>& units) : scale(units.size()) {
+        for (size_t u = 0; u < units.size(); ++u) refresh(u, units[u]);
+    }
+
+    void refresh(size_t u, const ComputeUnit& unit) {
+        scale[u] = 1 / (1 + std::exp(-0.2 * (unit.network_latency - 70.0))) / (unit.max_capacity * 100.0);
+    }
+
+    int findBestPlacement(const std::vector<ComputeUnit>& units, double threshold_max) const {
+        int bestUnit = -1;
+        double lowestPressure = threshold_max;
+        for (size_t u = 0; u < units.size(); ++u) {
+            if (units[u].function_replicas < units[u].max_capacity) {
+                double pressure = units[u].function_replicas * units[u].cpu_usage * scale[u];
+                if (pressure < lowestPressure) {
+                    lowestPressure = pressure;
+                    bestUnit = static_cast<int>(u);
+                }
+            }
+        }
+        return bestUnit;
+    }
+};
+
+// LDLS with local layers as membership tables, layer sizes by id and the
+// node's cpuFrequency * bandwidth inverted once. Random draws happen in the
+// same order as the reference so both generators stay in lockstep.
+class OptimizedLdls {
+private:
+    struct NodeView {
+        int id;
+        bool eligible;
+        double inverseCapacity;
+        std::vector<char> hasLayer; // Indexed by layer id
+    };
+
+    std::vector<NodeView> nodes;
+    std::vector<std::vector<int>> imageLayers;
+    std::vector<double> layerSize; // 0 for ids missing from the layer table, as the reference's map default
+
+public:
+    std::mt19937 gen;
+
+    OptimizedLdls(const std::vector<EdgeNode>& edgeNodes, const std::vector<Image>& images, const std::vector<Layer>& layers, unsigned seed)
+        : gen(seed) {
+        int maxLayer = 0;
+        for (const auto& layer : layers) maxLayer = std::max(maxLayer, layer.id);
+        for (const auto& image : images) {
+            for (int id : image.layers) maxLayer = std::max(maxLayer, id);
+        }
+        layerSize.assign(maxLayer + 1, 0.0);
+        for (const auto& layer : layers) layerSize[layer.id] = layer.size;
+        for (const auto& image : images) imageLayers.push_back(image.layers);
+        for (const auto& node : edgeNodes) {
+            NodeView view{node.id, node.maxContainers > 0 && node.storageCapacity > 0, 1.0 / (node.cpuFrequency * node.bandwidth),
+                          std::vector<char>(maxLayer + 1, 0)};
+            for (int id : node.localLayers) {
+                if (id <= maxLayer) view.hasLayer[id] = 1;
+            }
+            nodes.push_back(std::move(view));
+        }
+    }
+
+    int scheduleTask(const Task& task) {
+        int bestNode = -1;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        const std::vector<int>& wanted = imageLayers[task.requestedImage];
+        for (const auto& node : nodes) {
+            if (!node.eligible) continue;
+            double featureScore = 0.0;
+            for (int id : wanted) {
+                if (node.hasLayer[id]) featureScore += layerSize[id] * std::uniform_real_distribution<>(0.95, 1.05)(gen);
+            }
+            double actionValue = featureScore * node.inverseCapacity * std::uniform_real_distribution<>(0.95, 1.05)(gen);
+            if (actionValue > bestScore) {
+                bestScore = actionValue;
+                bestNode = node.id;
+            }
+        }
+        return bestNode;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Comparison
+// ---------------------------------------------------------------------------
+
+// Compare the decisions of one sequential placement phase. At the first
+// difference the reference state is rebuilt from the decisions both sides
+// agreed on, and both choices are costed with the reference cost function
+// (infinite if infeasible). Later decisions depend on the diverged state and
+// are not compared.
+template <typename CostFn>
+bool compareSequence(KernelReport& report, unsigned caseSeed, const std::string& phase, const std::vector<ServiceRequest>& requests,
+                     const std::vector<int>& expected, const std::vector<int>& actual, std::vector<RSU> state,
+                     double ServiceRequest::*amount, CostFn cost) {
+    for (const auto& request : requests) {
+        int want = expected[request.id], got = actual[request.id];
+        report.decisions++;
+        if (want == got) {
+            if (want >= 0) state[want].usedCapacity += request.*amount;
+            continue;
+        }
+        double wantCost = want >= 0 ? cost(request, state[want]) : std::numeric_limits<double>::infinity();
+        double gotCost = got >= 0 ? cost(request, state[got]) : std::numeric_limits<double>::infinity();
+        if (want >= 0 && got >= 0 && std::isfinite(gotCost) && withinTolerance(wantCost, gotCost)) {
+            report.ties++;
+            return false;
+        }
+        report.fail(caseSeed, phase + " request " + std::to_string(request.id) + ": reference RSU " + std::to_string(want) +
+                              " (cost " + std::to_string(wantCost) + "), optimized RSU " + std::to_string(got) + " (cost " + std::to_string(gotCost) + ")");
+        return false;
+    }
+    return true;
+}
+
+// Reference cost of placing a request, infinite if it does not fit
+double scheduleCost(const ServiceRequest& request, const RSU& rsu, const std::vector<double>& weights) {
+    if (rsu.usedCapacity + request.computationLoad > rsu.maxCapacity) return std::numeric_limits<double>::infinity();
+    return computePlacementCost(request, rsu, weights);
+}
+
+bool sameUsage(const std::vector<RSU>& rsus, const RSUColumns& columns) {
+    for (size_t r = 0; r < rsus.size(); ++r) {
+        if (!withinTolerance(rsus[r].usedCapacity, columns.used[r])) return false;
+    }
+    return true;
+}
+
+using ScheduleKernel = void (*)(const std::vector<ServiceRequest>&, RSUColumns&, const std::vector<double>&, std::vector<int>&);
+
+// main_algorithm over 1-4 slots. Every phase starts from the reference state,
+// so a tie in one phase does not cascade into the next.
+void checkMainAlgorithm(KernelReport& report, unsigned caseSeed, ScheduleKernel schedule) {
+    std::mt19937 gen(caseSeed);
+    Topology t = randomTopology(gen);
+    int slots = std::uniform_int_distribution<>(1, 4)(gen);
+    std::uniform_real_distribution<> dis(0.1, 0.3); // 6_'s per-slot parameter variation
+    std::vector<int> X(t.requests.size(), -1), P(t.services.size(), 0);
+    report.cases++;
+    for (int slot = 0; slot < slots; ++slot) {
+        for (auto& request : t.requests) {
+            double y = dis(gen);
+            request.computationLoad *= y;
+            request.transferCost *= y;
+        }
+        for (auto& rsu : t.rsus) {
+            dis(gen); // 6_ draws a factor it never uses
+            rsu.computationCost *= dis(gen);
+            rsu.retentionCost *= dis(gen);
+        }
+        std::vector<double> weights = computeDynamicWeights(computeSystemLoad(t.rsus));
+        referencePrefetch(t.rsus, t.services, P);
+
+        std::vector<RSU> before = t.rsus;
+        std::vector<int> expected(t.requests.size(), -1), actual(t.requests.size(), -1);
+        referenceSchedule(t.requests, t.rsus, weights, expected);
+        RSUColumns columns(before);
+        schedule(t.requests, columns, weights, actual);
+        std::string where = "slot " + std::to_string(slot) + " schedule";
+        if (compareSequence(report, caseSeed, where, t.requests, expected, actual, before, &ServiceRequest::computationLoad,
+                            [&](const ServiceRequest& request, const RSU& rsu) { return scheduleCost(request, rsu, weights); }) &&
+            !sameUsage(t.rsus, columns)) {
+            report.fail(caseSeed, where + ": same decisions but different RSU usage");
+        }
+        for (size_t i = 0; i < X.size(); ++i) {
+            if (expected[i] >= 0) X[i] = expected[i];
+        }
+
+        before = t.rsus;
+        std::vector<int> expectedT(t.requests.size(), -1), actualT(t.requests.size(), -1);
+        referenceTransfer(t.requests, t.rsus, expectedT);
+        RSUColumns transferColumns(before);
+        optimizedTransfer(t.requests, transferColumns, actualT);
+        where = "slot " + std::to_string(slot) + " transfer";
+        if (compareSequence(report, caseSeed, where, t.requests, expectedT, actualT, before, &ServiceRequest::demand,
+                            [](const ServiceRequest& request, const RSU& rsu) {
+                                return rsu.usedCapacity + request.demand <= rsu.maxCapacity ? referenceTransferCost(request, rsu)
+                                                                                            : std::numeric_limits<double>::infinity();
+                            }) &&
+            !sameUsage(t.rsus, transferColumns)) {
+            report.fail(caseSeed, where + ": same decisions but different RSU usage");
+        }
+
+        auto [cost, latency] = referenceCost(t.requests, t.rsus, t.services, X, P);
+        auto [fastCost, fastLatency] = optimizedCost(t.requests, RSUColumns(t.rsus), t.services, X, P);
+        if (!withinTolerance(cost, fastCost) || !withinTolerance(latency, fastLatency)) {
+            report.fail(caseSeed, "slot " + std::to_string(slot) + " totals: reference cost " + std::to_string(cost) + ", latency " +
+                                  std::to_string(latency) + "; optimized " + std::to_string(fastCost) + ", " + std::to_string(fastLatency));
+        }
+    }
+}
+
+// ONCO scheduleRequests with its slope-adjusted weights (which can go negative)
+void checkScheduleRequests(KernelReport& report, unsigned caseSeed) {
+    std::mt19937 gen(caseSeed);
+    Topology t = randomTopology(gen);
+    int slots = std::uniform_int_distribution<>(1, 4)(gen);
+    OncoWeights onco;
+    report.cases++;
+    for (int slot = 0; slot < slots; ++slot) {
+        std::vector<double> weights = onco.next(computeSystemLoad(t.rsus));
+        std::vector<RSU> before = t.rsus;
+        std::vector<int> expected(t.requests.size(), -1), actual(t.requests.size(), -1);
+        referenceScheduleRequests(t.requests, t.rsus, weights, expected);
+        RSUColumns columns(before);
+        optimizedSchedule(t.requests, columns, weights, actual);
+        std::string where = "slot " + std::to_string(slot);
+        if (compareSequence(report, caseSeed, where, t.requests, expected, actual, before, &ServiceRequest::computationLoad,
+                            [&](const ServiceRequest& request, const RSU& rsu) { return scheduleCost(request, rsu, weights); }) &&
+            !sameUsage(t.rsus, columns)) {
+            report.fail(caseSeed, where + ": same decisions but different RSU usage");
+        }
+    }
+}
+
+// PBO findBestPlacement over rounds of placement, scaling and drifting load
+void checkFindBestPlacement(KernelReport& report, unsigned caseSeed) {
+    std::mt19937 gen(caseSeed);
+    std::uniform_real_distribution<> unit(0.0, 1.0), cpu(0.0, 100.0), latency(0.0, 200.0);
+    std::uniform_int_distribution<> capacity(1, 10);
+    std::vector<ComputeUnit> units(std::uniform_int_distribution<>(1, 64)(gen));
+    for (size_t u = 0; u < units.size(); ++u) {
+        int maxCapacity = capacity(gen);
+        units[u] = {"unit-" + std::to_string(u), unit(gen) < 0.1 ? 0.0 : cpu(gen), latency(gen),
+                    std::uniform_int_distribution<>(0, maxCapacity)(gen), maxCapacity};
+        if (u > 0 && unit(gen) < 0.15) units[u] = units[u - 1]; // Exact twin
+    }
+    PressureIndex index(units);
+    int rounds = std::uniform_int_distribution<>(1, 20)(gen);
+    report.cases++;
+    for (int round = 0; round < rounds; ++round) {
+        int want = referenceFindBestPlacement(units, PBO_THRESHOLD_MAX);
+        int got = index.findBestPlacement(units, PBO_THRESHOLD_MAX);
+        report.decisions++;
+        if (want != got) {
+            // A unit whose pressure rounds to the threshold may be taken by one side only
+            double wantPressure = want >= 0 ? referencePressure(units[want]) : PBO_THRESHOLD_MAX;
+            double gotPressure = got >= 0 ? referencePressure(units[got]) : PBO_THRESHOLD_MAX;
+            bool eligible = got < 0 || units[got].function_replicas < units[got].max_capacity;
+            if (eligible && withinTolerance(wantPressure, gotPressure)) {
+                report.ties++;
+            } else {
+                report.fail(caseSeed, "round " + std::to_string(round) + ": reference unit " + std::to_string(want) + " (pressure " +
+                                      std::to_string(wantPressure) + "), optimized unit " + std::to_string(got) + " (pressure " +
+                                      std::to_string(gotPressure) + ")");
+                return;
+            }
+        }
+        if (want >= 0) units[want].function_replicas++;
+        referenceScaleFunctions(units, PBO_THRESHOLD_MAX, PBO_THRESHOLD_MIN);
+        for (size_t u = 0; u < units.size(); ++u) {
+            if (unit(gen) < 0.2) units[u].cpu_usage = cpu(gen);
+            if (unit(gen) < 0.05) {
+                units[u].network_latency = latency(gen);
+                index.refresh(u, units[u]);
+            }
+        }
+    }
+}
+
+// LDLS scheduleTask with identically seeded generators on both sides
+void checkScheduleTask(KernelReport& report, unsigned caseSeed) {
+    std::mt19937 gen(caseSeed);
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    int numLayers = std::uniform_int_distribution<>(1, 40)(gen);
+    int layerIds = numLayers + numLayers / 2; // Images and nodes may name layers missing from the table
+    std::uniform_int_distribution<> anyLayer(0, layerIds - 1);
+
+    std::vector<Layer> layers;
+    for (int l = 0; l < numLayers; ++l) layers.push_back({l, 0.5 + 4.5 * unit(gen), unit(gen) < 0.5, 5.0 * unit(gen)});
+    std::vector<Image> images(std::uniform_int_distribution<>(1, 10)(gen));
+    for (size_t i = 0; i < images.size(); ++i) {
+        images[i].id = static_cast<int>(i);
+        int count = std::uniform_int_distribution<>(1, 6)(gen);
+        for (int k = 0; k < count; ++k) images[i].layers.push_back(anyLayer(gen));
+    }
+    std::vector<EdgeNode> nodes(std::uniform_int_distribution<>(1, 32)(gen));
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        nodes[n] = {static_cast<int>(n), 0.5 + 2.5 * unit(gen), 10.0 + 190.0 * unit(gen), unit(gen) < 0.1 ? 0.0 : 5.0 + 15.0 * unit(gen),
+                    unit(gen) < 0.1 ? 0 : std::uniform_int_distribution<>(1, 10)(gen), {}};
+        int count = std::uniform_int_distribution<>(0, layerIds)(gen);
+        for (int k = 0; k < count; ++k) nodes[n].localLayers.push_back(anyLayer(gen));
+    }
+    std::vector<Task> tasks(std::uniform_int_distribution<>(1, 50)(gen));
+    for (size_t k = 0; k < tasks.size(); ++k) {
+        tasks[k] = {static_cast<int>(k), std::uniform_int_distribution<>(0, static_cast<int>(images.size()) - 1)(gen), 0.5 + unit(gen),
+                    500.0 + 1000.0 * unit(gen), 10.0 + 90.0 * unit(gen)};
+    }
+
+    unsigned schedulerSeed = gen();
+    ReferenceLdls reference(nodes, images, layers, schedulerSeed);
+    OptimizedLdls optimized(nodes, images, layers, schedulerSeed);
+    std::vector<double> actionValues(nodes.size());
+    report.cases++;
+    for (const auto& task : tasks) {
+        int want = reference.scheduleTask(task, &actionValues);
+        int got = optimized.scheduleTask(task);
+        report.decisions++;
+        if (!(reference.gen == optimized.gen)) {
+            report.fail(caseSeed, "task " + std::to_string(task.id) + ": random streams diverged");
+            return;
+        }
+        if (want == got) continue;
+        if (want >= 0 && got >= 0 && withinTolerance(actionValues[want], actionValues[got])) {
+            report.ties++;
+        } else {
+            report.fail(caseSeed, "task " + std::to_string(task.id) + ": reference node " + std::to_string(want) +
+                                  ", optimized node " + std::to_string(got));
+            return;
+        }
+    }
+}
+
+void printReport(const KernelReport& report) {
+    std::cout << std::left << std::setw(34) << report.name << std::right << std::setw(6) << report.cases << " cases, "
+              << std::setw(8) << report.decisions << " decisions compared, " << report.ties << " ties within tolerance, "
+              << report.mismatches << " mismatches" << std::endl;
+    for (const auto& failure : report.failures) std::cout << "    " << failure << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int cases = argc > 1 ? std::max(1, std::atoi(argv[1])) : DEFAULT_CASES;
+    unsigned firstSeed = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    std::cout << "Differential check: " << cases << " random topologies per kernel (seeds " << firstSeed << ".." << firstSeed + cases - 1
+              << "), relative tolerance " << RELATIVE_TOLERANCE << "\n" << std::endl;
+
+    KernelReport mainAlgorithm{"main_algorithm (6_AVSDSF)"};
+    KernelReport scheduleRequests{"scheduleRequests (1_ONCO)"};
+    KernelReport findBestPlacement{"findBestPlacement (2_PBO)"};
+    KernelReport scheduleTask{"scheduleTask (5_LDLS)"};
+    for (int c = 0; c < cases; ++c) {
+        unsigned seed = firstSeed + static_cast<unsigned>(c);
+        checkMainAlgorithm(mainAlgorithm, seed, optimizedSchedule);
+        checkScheduleRequests(scheduleRequests, seed);
+        checkFindBestPlacement(findBestPlacement, seed);
+        checkScheduleTask(scheduleTask, seed);
+    }
+    long long mismatches = 0;
+    for (const KernelReport* report : {&mainAlgorithm, &scheduleRequests, &findBestPlacement, &scheduleTask}) {
+        printReport(*report);
+        mismatches += report->mismatches;
+    }
+
+    // The harness must notice a kernel that really decides differently
+    KernelReport injected{"fault injection (no retention)"};
+    for (int c = 0; c < std::min(cases, 200); ++c) checkMainAlgorithm(injected, firstSeed + static_cast<unsigned>(c), faultyScheduleWithoutRetention);
+    bool caught = injected.mismatches > 0;
+    std::cout << "\nFault injection (schedule ignoring retention cost): " << injected.mismatches << " mismatches over " << injected.cases
+              << " cases, " << (caught ? "detected" : "NOT DETECTED") << std::endl;
+    if (mismatches > 0) std::cout << "Reproduce a failing case with: " << argv[0] << " 1 <seed>" << std::endl;
+    std::cout << (mismatches == 0 && caught ? "PASS" : "FAIL") << std::endl;
+    return mismatches == 0 && caught ? 0 : 1;
+}
@@ -0,0 +1,818 @@
+/*
+AVSDSF - Benchmark results store and Mann-Whitney regression comparison
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <set>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include <functional>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "avsdsf_model.h"
+#include "avsdsf_memory.h"
+#include "avsdsf_intern.h"
+
+const char* DEFAULT_DIR = "bench_results";
+const int DEFAULT_REPEATS = 15;
+const double ALPHA = 0.01;        // Significance level of the two-sided Mann-Whitney test
+const double MIN_EFFECT = 0.03;   // Median changes below 3% are never flagged
+const int NUM_RSUS = 1000;
+const int NUM_REQUESTS = 2000;
+const int SLOTS_PER_SAMPLE = 3;
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// Results store: one small text file per run,
+// <dir>/<unix time>-<commit>-<fingerprint>.bench
+// ---------------------------------------------------------------------------
+
+struct BenchmarkSeries {
+    std::string name;
+    std::string unit;
+    bool higherIsBetter;
+    std::vector<double> samples;
+};
+
+struct BenchmarkRun {
+    std::string commit = "unknown";
+    bool dirty = false;
+    std::string fingerprint;
+    std::string machine; // Human-readable description the fingerprint hashes
+    long long timestamp = 0;
+    std::vector<BenchmarkSeries> series;
+    std::string path;
+};
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string commandOutput(const char* command) {
+    std::string output;
+    if (std::FILE* pipe = popen(command, "r")) {
+        char buffer[256];
+        while (std::fgets(buffer, sizeof(buffer), pipe)) output += buffer;
+        pclose(pipe);
+    }
+    while (!output.empty() && (output.back() == '\n' || output.back() == '\r')) output.pop_back();
+    return output;
+}
+
+std::string procField(const char* file, const std::string& key) {
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            size_t start = line.find_first_not_of(" \t", colon + 1);
+            return start == std::string::npos ? "" : line.substr(start);
+        }
+    }
+    return "";
+}
+
+// Commit of the working tree (AVSDSF_COMMIT overrides), and machine identity:
+// CPU model, hardware threads, memory, compiler and optimisation
+BenchmarkRun describeCurrentRun() {
+    BenchmarkRun run;
+    const char* override = std::getenv("AVSDSF_COMMIT");
+    std::string commit = override && *override ? override : commandOutput("git rev-parse HEAD 2>/dev/null");
+    if (!commit.empty()) run.commit = commit;
+    run.dirty = !override && !commandOutput("git status --porcelain --untracked-files=no 2>/dev/null").empty();
+
+    std::string cpu = procField("/proc/cpuinfo", "model name");
+    std::string memory = procField("/proc/meminfo", "MemTotal");
+    long long gib = std::llround(std::atof(memory.c_str()) / (1024.0 * 1024.0));
+#ifdef __OPTIMIZE__
+    const char* optimised = "optimised";
+#else
+    const char* optimised = "unoptimised";
+#endif
+    run.machine = (cpu.empty() ? "unknown CPU" : cpu) + " | " + std::to_string(std::thread::hardware_concurrency()) + " threads | " +
+                  std::to_string(gib) + " GiB | gcc " + __VERSION__ + " " + optimised;
+    std::ostringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << fnv1a(run.machine);
+    run.fingerprint = hex.str();
+    run.timestamp = static_cast<long long>(std::time(nullptr));
+    return run;
+}
+
+bool saveRun(BenchmarkRun& run, const std::string& dir) {
+    mkdir(dir.c_str(), 0755);
+    run.path = dir + "/" + std::to_string(run.timestamp) + "-" + run.commit.substr(0, 12) + "-" + run.fingerprint.substr(0, 8) + ".bench";
+    std::ofstream out(run.path);
+    out << "avsdsf-bench 1\n"
+        << "commit " << run.commit << " " << (run.dirty ? 1 : 0) << "\n"
+        << "machine " << run.fingerprint << " " << run.machine << "\n"
+        << "time " << run.timestamp << "\n";
+    out << std::setprecision(9);
+    for (const auto& series : run.series) {
+        out << "bench " << series.name << " " << series.unit << " " << (series.higherIsBetter ? 1 : 0) << " " << series.samples.size();
+        for (double sample : series.samples) out << " " << sample;
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool loadRun(const std::string& path, BenchmarkRun& run) {
+    std::ifstream in(path);
+    std::string line, key;
+    if (!std::getline(in, line) || line != "avsdsf-bench 1") return false;
+    run = BenchmarkRun();
+    run.path = path;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        fields >> key;
+        if (key == "commit") {
+            int dirty = 0;
+            fields >> run.commit >> dirty;
+            run.dirty = dirty != 0;
+        } else if (key == "machine") {
+            fields >> run.fingerprint;
+            std::getline(fields >> std::ws, run.machine);
+        } else if (key == "time") {
+            fields >> run.timestamp;
+        } else if (key == "bench") {
+            BenchmarkSeries series;
+            int higher = 0;
+            size_t count = 0;
+            fields >> series.name >> series.unit >> higher >> count;
+            series.higherIsBetter = higher != 0;
+            series.samples.resize(count);
+            for (double& sample : series.samples) fields >> sample;
+            if (!fields) return false;
+            run.series.push_back(std::move(series));
+        }
+    }
+    return !run.fingerprint.empty();
+}
+
+// All readable runs in the directory, oldest first
+std::vector<BenchmarkRun> loadRuns(const std::string& dir) {
+    std::vector<BenchmarkRun> runs;
+    if (DIR* handle = opendir(dir.c_str())) {
+        while (dirent* entry = readdir(handle)) {
+            std::string name = entry->d_name;
+            BenchmarkRun run;
+            if (name.size() > 6 && name.compare(name.size() - 6, 6, ".bench") == 0 && loadRun(dir + "/" + name, run)) runs.push_back(run);
+        }
+        closedir(handle);
+    }
+    std::sort(runs.begin(), runs.end(), [](const BenchmarkRun& a, const BenchmarkRun& b) {
+        return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : a.path < b.path;
+    });
+    return runs;
+}
+
+// ---------------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------------
+
+double quantile(std::vector<double> values, double fraction) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double position = fraction * (values.size() - 1);
+    size_t below = static_cast<size_t>(position);
+    size_t above = std::min(below + 1, values.size() - 1);
+    return values[below] + (position - below) * (values[above] - values[below]);
+}
+
+// Two-sided Mann-Whitney U test. Exact null distribution for small samples
+// without ties, normal approximation with tie and continuity correction
+// otherwise.
+double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    if (n1 == 0 || n2 == 0) return 1.0;
+    std::vector<std::pair<double, int>> pooled;
+    for (double value : a) pooled.push_back({value, 0});
+    for (double value : b) pooled.push_back({value, 1});
+    std::sort(pooled.begin(), pooled.end());
+    double rankSumA = 0.0, tieTerm = 0.0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && pooled[j].first == pooled[i].first) ++j;
+        double rank = (i + j + 1) / 2.0; // Average of ranks i+1 .. j
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second == 0) rankSumA += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+    double u1 = rankSumA - n1 * (n1 + 1) / 2.0;
+    double pairs = static_cast<double>(n1) * n2;
+
+    if (tieTerm == 0.0 && pairs <= 900) {
+        // ways[i][j][u]: orderings of i values of a and j of b with U = u
+        size_t maxU = n1 * n2;
+        std::vector<std::vector<std::vector<double>>> ways(n1 + 1, std::vector<std::vector<double>>(n2 + 1, std::vector<double>(maxU + 1, 0.0)));
+        for (size_t i = 0; i <= n1; ++i) {
+            for (size_t j = 0; j <= n2; ++j) {
+                if (i == 0 || j == 0) {
+                    ways[i][j][0] = 1.0;
+                    continue;
+                }
+                for (size_t u = 0; u <= i * j; ++u) {
+                    // The largest value is from a (beats all j of b) or from b
+                    ways[i][j][u] = (u >= j ? ways[i - 1][j][u - j] : 0.0) + ways[i][j - 1][u];
+                }
+            }
+        }
+        double total = 0.0, tail = 0.0;
+        double u = std::min(u1, pairs - u1);
+        for (size_t k = 0; k <= maxU; ++k) {
+            total += ways[n1][n2][k];
+            if (k <= u) tail += ways[n1][n2][k];
+        }
+        return std::min(1.0, 2.0 * tail / total);
+    }
+
+    double variance = pairs / 12.0 * ((n + 1) - tieTerm / (static_cast<double>(n) * (n - 1)));
+    if (variance <= 0.0) return 1.0;
+    double z = std::max(0.0, std::fabs(u1 - pairs / 2.0) - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+struct Comparison {
+    std::string name;
+    std::string unit;
+    double baseline;  // Medians
+    double candidate;
+    double change;    // Relative, candidate vs baseline
+    double p;
+    int verdict;      // -1 regression, 0 no significant change, 1 improvement
+};
+
+std::vector<Comparison> compareRuns(const BenchmarkRun& baseline, const BenchmarkRun& candidate) {
+    std::vector<Comparison> result;
+    for (const auto& series : candidate.series) {
+        auto before = std::find_if(baseline.series.begin(), baseline.series.end(), [&](const BenchmarkSeries& s) { return s.name == series.name; });
+        if (before == baseline.series.end()) continue;
+        Comparison c{series.name, series.unit, quantile(before->samples, 0.5), quantile(series.samples, 0.5), 0.0, 1.0, 0};
+        c.change = c.baseline != 0.0 ? (c.candidate - c.baseline) / c.baseline : 0.0;
+        c.p = mannWhitneyP(before->samples, series.samples);
+        if (c.p < ALPHA && std::fabs(c.change) >= MIN_EFFECT) c.verdict = (c.change > 0) == series.higherIsBetter ? 1 : -1;
+        result.push_back(c);
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark suite: one kernel per algorithm plus full AVSDSF and ONCO slots,
+// transcribed from the original programs. Every sample starts from the same
+// seeded workload; only the kernel is timed.
+// ---------------------------------------------------------------------------
+
+struct Workload {
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+};
+
+Workload makeWorkload() {
+    Workload w;
+    generateScenario(NUM_RSUS, NUM_REQUESTS, 20, 29, w.rsus, w.requests, w.services, 1.5);
+    return w;
+}
+
+// Decision variables as kept by the original programs
+struct DecisionMaps {
+    std::unordered_map<int, int> X; // Request scheduling
+    std::unordered_map<int, int> A; // Container retention
+    std::unordered_map<int, int> P; // Prefetching decisions
+    std::unordered_map<int, int> T; // Transfer decisions
+};
+
+// RS-MAS argmin (6_AVSDSF_final.cpp, 1_ONCO_final.cpp scheduleRequests);
+// decisions go to a vector for the kernel benchmarks and to a map in slots
+template <typename Decisions>
+void scheduleRequests(const std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, const std::vector<double>& weights, Decisions& X) {
+    for (const auto& request : requests) {
+        double minCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                double cost = computePlacementCost(request, rsu, weights);
+                if (cost < minCost) {
+                    minCost = cost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            X[request.id] = bestRSU;
+            rsus[bestRSU].usedCapacity += request.computationLoad;
+        }
+    }
+}
+
+// Transfer phase of 6_AVSDSF_final.cpp
+template <typename Decisions>
+void transferRequests(const std::vector<ServiceRequest>& requests, std::vector<RSU>& rsus, Decisions& T) {
+    for (const auto& request : requests) {
+        double minTransferCost = std::numeric_limits<double>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.demand <= rsu.maxCapacity) {
+                double transferCost = request.distanceToRSU + TRANSFER_COST_MULTIPLIER * rsu.usedCapacity / rsu.maxCapacity;
+                if (transferCost < minTransferCost) {
+                    minTransferCost = transferCost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        if (bestRSU != -1) {
+            T[request.id] = bestRSU;
+            rsus[bestRSU].usedCapacity += request.demand;
+        }
+    }
+}
+
+// One AVSDSF slot: weights, prefetch, schedule, transfer and cost (6_ and 4_MMTO share it)
+double avsdsfSlot(Workload& w, DecisionMaps& decisions) {
+    std::vector<double> weights = computeDynamicWeights(computeSystemLoad(w.rsus));
+    for (auto& rsu : w.rsus) {
+        double remainingCapacity = rsu.maxCapacity - rsu.usedCapacity;
+        for (const auto& service : w.services) {
+            if (service.size <= remainingCapacity) {
+                decisions.P[service.id] = 1;
+                remainingCapacity -= service.size;
+                rsu.usedCapacity += service.size;
+            }
+        }
+    }
+    scheduleRequests(w.requests, w.rsus, weights, decisions.X);
+    transferRequests(w.requests, w.rsus, decisions.T);
+    double totalCost = 0.0;
+    for (const auto& request : w.requests) {
+        auto placed = decisions.X.find(request.id);
+        if (placed == decisions.X.end()) continue;
+        const RSU& rsu = w.rsus[placed->second];
+        totalCost += rsu.computationCost * request.computationLoad + rsu.retentionCost + request.transferCost + request.preparationCost;
+    }
+    for (const auto& service : w.services) {
+        if (decisions.P[service.id] == 1) totalCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
+    }
+    return totalCost;
+}
+
+// 1_ONCO_final.cpp slope-adjusted weights
+std::vector<double> oncoWeights(double load, double& previousLoad) {
+    double slope = previousLoad != 0.0 ? (load - previousLoad) / previousLoad : 0.0;
+    std::vector<double> weights;
+    if (load <= 0.4) weights = {0.5, 0.2, 0.2, 0.1};
+    else if (load <= 0.7) weights = {0.4 + slope * 0.1, 0.3 + slope * 0.05, 0.2 - slope * 0.05, 0.1 - slope * 0.05};
+    else weights = {0.3 + slope * 0.1, 0.4 + slope * 0.1, 0.2 - slope * 0.05, 0.1 - slope * 0.05};
+    double sum = weights[0] + weights[1] + weights[2] + weights[3];
+    for (auto& weight : weights) weight /= sum;
+    previousLoad = load;
+    return weights;
+}
+
+// One ONCO slot: weights, scheduleRequests, retainContainers and computeTotalCost
+double oncoSlot(Workload& w, double& previousLoad, DecisionMaps& decisions) {
+    double load = computeSystemLoad(w.rsus);
+    std::vector<double> weights = oncoWeights(load, previousLoad);
+    scheduleRequests(w.requests, w.rsus, weights, decisions.X);
+    for (const auto& rsu : w.rsus) decisions.A[rsu.id] = load <= 0.7 && rsu.retentionCost <= 0.5 ? 1 : 0;
+    double totalCost = 0.0;
+    for (const auto& request : w.requests) {
+        auto placed = decisions.X.find(request.id);
+        if (placed == decisions.X.end()) continue;
+        const RSU& rsu = w.rsus[placed->second];
+        totalCost += 0.3 * rsu.computationCost * request.computationLoad + 0.3 * rsu.retentionCost + 0.3 * request.transferCost +
+                     0.3 * request.preparationCost;
+    }
+    return totalCost;
+}
+
+// 2_PBO_final.cpp compute units and findBestPlacement
+struct ComputeUnit {
+    NameId id;
+    double cpu_usage;
+    double network_latency;
+    int function_replicas;
+    int max_capacity;
+};
+
+double pressure(const ComputeUnit& unit) {
+    double pREQ = static_cast<double>(unit.function_replicas) / unit.max_capacity;
+    double pRTT = 1 / (1 + std::exp(-0.2 * (unit.network_latency - 70.0)));
+    return pREQ * pRTT * (unit.cpu_usage / 100.0);
+}
+
+ComputeUnit* findBestPlacement(std::vector<ComputeUnit>& units, double threshold_max) {
+    ComputeUnit* bestUnit = nullptr;
+    double lowestPressure = threshold_max;
+    for (auto& unit : units) {
+        if (unit.function_replicas < unit.max_capacity) {
+            double p = pressure(unit);
+            if (p < lowestPressure) {
+                lowestPressure = p;
+                bestUnit = &unit;
+            }
+        }
+    }
+    return bestUnit;
+}
+
+// 3_PAGURUS_final.cpp containers: invocation reuses a busy container, forks a
+// helper from a zygote of a dependent function, or adds a private container
+const NameId PRIVATE_CONTAINER = internName("private");
+const NameId ZYGOTE_CONTAINER = internName("zygote");
+const NameId HELPER_CONTAINER = internName("helper");
+
+struct Container {
+    NameId functionName;
+    NameId type;
+    bool isIdle;
+};
+
+struct PagurusState {
+    std::unordered_map<NameId, std::vector<Container>> functionContainers;
+    std::unordered_map<NameId, std::set<NameId>> functionDependencies;
+    std::mt19937 gen{7};
+    double cost = 0.0;
+
+    void identifyIdleContainers() {
+        for (auto& func : functionContainers) {
+            for (auto& container : func.second) {
+                if (container.isIdle && container.type == PRIVATE_CONTAINER) {
+                    container.type = ZYGOTE_CONTAINER;
+                    cost += 0.1;
+                }
+            }
+        }
+    }
+
+    void invoke(NameId functionName) {
+        for (auto& container : functionContainers[functionName]) {
+            if (!container.isIdle) {
+                cost += 0.02;
+                return;
+            }
+        }
+        const auto& helpers = functionDependencies[functionName];
+        if (!helpers.empty()) {
+            auto helper = helpers.begin();
+            std::advance(helper, std::uniform_int_distribution<size_t>(0, helpers.size() - 1)(gen));
+            for (auto& container : functionContainers[*helper]) {
+                if (container.type == ZYGOTE_CONTAINER) {
+                    functionContainers[functionName].push_back({functionName, HELPER_CONTAINER, false});
+                    cost += 0.05;
+                    return;
+                }
+            }
+        }
+        functionContainers[functionName].push_back({functionName, PRIVATE_CONTAINER, true});
+        cost += 0.3;
+    }
+};
+
+// 5_LDLS_final.cpp scheduleTask with extractFeatures
+struct EdgeNode {
+    int id;
+    double cpuFrequency;
+    double bandwidth;
+    double storageCapacity;
+    int maxContainers;
+    std::vector<int> localLayers;
+};
+
+struct LdlsState {
+    std::vector<EdgeNode> nodes;
+    std::vector<std::vector<int>> images;
+    std::unordered_map<int, double> layerSize;
+    std::mt19937 gen{11};
+
+    int scheduleTask(int requestedImage) {
+        int bestNode = -1;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (const auto& node : nodes) {
+            if (node.maxContainers <= 0 || node.storageCapacity <= 0) continue;
+            double featureScore = 0.0;
+            for (int layerID : images[requestedImage]) {
+                if (std::find(node.localLayers.begin(), node.localLayers.end(), layerID) != node.localLayers.end()) {
+                    featureScore += layerSize[layerID] * std::uniform_real_distribution<>(0.95, 1.05)(gen);
+                }
+            }
+            double actionValue = (featureScore / (node.cpuFrequency * node.bandwidth)) * std::uniform_real_distribution<>(0.95, 1.05)(gen);
+            if (actionValue > bestScore) {
+                bestScore = actionValue;
+                bestNode = node.id;
+            }
+        }
+        return bestNode;
+    }
+};
+
+volatile double benchmarkSink; // Keeps results observable so kernels are not optimised away
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct BenchmarkCase {
+    const char* name;
+    const char* unit;
+    bool higherIsBetter;
+    const char* memoryTag;          // Subsystem allocated under MemoryTag in the sample, or nullptr
+    std::function<double()> sample; // One measurement in `unit`; checkpoints memory before teardown
+};
+
+std::vector<BenchmarkCase> benchmarkSuite(const Workload& base) {
+    std::vector<BenchmarkCase> suite;
+    const double requests = static_cast<double>(base.requests.size());
+
+    suite.push_back({"avsdsf.schedule", "decisions/s", true, nullptr, [&base, requests] {
+        Workload w = base;
+        std::vector<int> X(w.requests.size(), -1);
+        std::vector<double> weights = computeDynamicWeights(computeSystemLoad(w.rsus));
+        auto start = Clock::now();
+        scheduleRequests(w.requests, w.rsus, weights, X);
+        double seconds = secondsSince(start);
+        benchmarkSink = w.rsus[0].usedCapacity;
+        return requests / seconds;
+    }});
+    suite.push_back({"avsdsf.transfer", "decisions/s", true, nullptr, [&base, requests] {
+        Workload w = base;
+        std::vector<int> T(w.requests.size(), -1);
+        auto start = Clock::now();
+        transferRequests(w.requests, w.rsus, T);
+        double seconds = secondsSince(start);
+        benchmarkSink = w.rsus[0].usedCapacity;
+        return requests / seconds;
+    }});
+    suite.push_back({"avsdsf.slot", "ms/slot", false, "avsdsf.decisions", [&base] {
+        Workload w = base;
+        MemoryTag memory("avsdsf.decisions");
+        DecisionMaps decisions;
+        double total = 0.0;
+        auto start = Clock::now();
+        for (int t = 0; t < SLOTS_PER_SAMPLE; ++t) {
+            for (auto& rsu : w.rsus) rsu.usedCapacity = 0.0;
+            total += avsdsfSlot(w, decisions);
+        }
+        double seconds = secondsSince(start);
+        memoryCheckpoint();
+        benchmarkSink = total;
+        return seconds * 1000.0 / SLOTS_PER_SAMPLE;
+    }});
+    suite.push_back({"onco.scheduleRequests", "decisions/s", true, nullptr, [&base, requests] {
+        Workload w = base;
+        std::vector<int> X(w.requests.size(), -1);
+        double previousLoad = 0.0;
+        std::vector<double> weights = oncoWeights(computeSystemLoad(w.rsus), previousLoad);
+        auto start = Clock::now();
+        scheduleRequests(w.requests, w.rsus, weights, X);
+        double seconds = secondsSince(start);
+        benchmarkSink = w.rsus[0].usedCapacity;
+        return requests / seconds;
+    }});
+    suite.push_back({"onco.slot", "ms/slot", false, "onco.decisions", [&base] {
+        Workload w = base;
+        MemoryTag memory("onco.decisions");
+        DecisionMaps decisions;
+        double previousLoad = 0.0, total = 0.0;
+        auto start = Clock::now();
+        for (int t = 0; t < SLOTS_PER_SAMPLE; ++t) {
+            for (auto& rsu : w.rsus) rsu.usedCapacity = 0.0;
+            total += oncoSlot(w, previousLoad, decisions);
+        }
+        double seconds = secondsSince(start);
+        memoryCheckpoint();
+        benchmarkSink = total;
+        return seconds * 1000.0 / SLOTS_PER_SAMPLE;
+    }});
+    suite.push_back({"pbo.findBestPlacement", "placements/s", true, "pbo.units", [] {
+        std::mt19937 gen(13);
+        std::uniform_real_distribution<> cpu(5.0, 100.0), latency(10.0, 150.0);
+        MemoryTag memory("pbo.units");
+        std::vector<ComputeUnit> units;
+        for (int u = 0; u < 2000; ++u) units.push_back({internName("Edge-" + std::to_string(u)), cpu(gen), latency(gen), 1, 20});
+        const int placements = 2000;
+        auto start = Clock::now();
+        for (int i = 0; i < placements; ++i) {
+            if (ComputeUnit* best = findBestPlacement(units, 0.5)) best->function_replicas++;
+        }
+        double seconds = secondsSince(start);
+        memoryCheckpoint();
+        benchmarkSink = units[0].function_replicas;
+        return placements / seconds;
+    }});
+    suite.push_back({"pagurus.invocation", "invocations/s", true, "pagurus.containers", [] {
+        const int functions = 64, invocations = 200000;
+        std::vector<NameId> names;
+        for (int f = 0; f < functions; ++f) names.push_back(internName("Function" + std::to_string(f)));
+        MemoryTag memory("pagurus.containers");
+        PagurusState state;
+        for (int f = 0; f < functions; ++f) {
+            state.functionDependencies[names[f]].insert(names[(f + 1) % functions]);
+            state.functionContainers[names[f]].push_back({names[f], PRIVATE_CONTAINER, true});
+        }
+        std::uniform_int_distribution<> pick(0, functions - 1);
+        auto start = Clock::now();
+        for (int i = 0; i < invocations; ++i) {
+            if (i % 1000 == 0) state.identifyIdleContainers();
+            state.invoke(names[pick(state.gen)]);
+        }
+        double seconds = secondsSince(start);
+        memoryCheckpoint();
+        benchmarkSink = state.cost;
+        return invocations / seconds;
+    }});
+    suite.push_back({"ldls.scheduleTask", "decisions/s", true, "ldls.policy", [] {
+        LdlsState state;
+        std::mt19937 gen(17);
+        std::uniform_int_distribution<> layer(0, 79);
+        for (int l = 0; l < 80; ++l) state.layerSize[l] = 0.5 + 0.05 * l;
+        for (int i = 0; i < 20; ++i) {
+            state.images.emplace_back();
+            for (int k = 0; k < 6; ++k) state.images.back().push_back(layer(gen));
+        }
+        for (int n = 0; n < 200; ++n) {
+            EdgeNode node{n, 0.9 + 0.002 * n, 80.0 + n, 15.0, 10, {}};
+            for (int k = 0; k < 12; ++k) node.localLayers.push_back(layer(gen));
+            state.nodes.push_back(node);
+        }
+        const int tasks = 2000;
+        MemoryTag memory("ldls.policy");
+        std::unordered_map<int, double> policy; // optimizePolicy's table
+        auto start = Clock::now();
+        for (int t = 0; t < tasks; ++t) {
+            int selectedNode = state.scheduleTask(t % 20);
+            if (selectedNode != -1) policy[selectedNode] += 0.01 / (t / 20 + 1);
+        }
+        double seconds = secondsSince(start);
+        memoryCheckpoint();
+        benchmarkSink = static_cast<double>(policy.size());
+        return tasks / seconds;
+    }});
+    return suite;
+}
+
+BenchmarkRun runSuite(int repeats) {
+    BenchmarkRun run = describeCurrentRun();
+    Workload base = makeWorkload();
+    for (const auto& benchmark : benchmarkSuite(base)) {
+        BenchmarkSeries series{benchmark.name, benchmark.unit, benchmark.higherIsBetter, {}};
+        benchmark.sample(); // Warm-up
+        // Peak and steady-state (checkpointed before teardown) bytes of the subsystem, and its allocations, per sample
+        int tag = benchmark.memoryTag ? memoryTagId(benchmark.memoryTag) : 0;
+        std::string memoryName = std::string("mem.") + (benchmark.memoryTag ? benchmark.memoryTag : "");
+        BenchmarkSeries peak{memoryName + ".peak", "bytes", false, {}};
+        BenchmarkSeries steady{memoryName + ".steady", "bytes", false, {}};
+        BenchmarkSeries allocations{memoryName + ".allocations", "count", false, {}};
+        for (int r = 0; r < repeats; ++r) {
+            int64_t liveBefore = memoryTags[tag].liveBytes.load();
+            uint64_t allocationsBefore = memoryTags[tag].allocations.load();
+            resetMemoryPeak(tag);
+            series.samples.push_back(benchmark.sample());
+            peak.samples.push_back(static_cast<double>(memoryTags[tag].peakBytes.load() - liveBefore));
+            steady.samples.push_back(static_cast<double>(memoryTags[tag].steadyBytes.load() - liveBefore));
+            allocations.samples.push_back(static_cast<double>(memoryTags[tag].allocations.load() - allocationsBefore));
+        }
+        std::cout << std::left << std::setw(24) << series.name << std::right << std::setw(14) << std::setprecision(4)
+                  << quantile(series.samples, 0.5) << " " << std::left << std::setw(14) << series.unit << std::right
+                  << " IQR " << quantile(series.samples, 0.25) << " - " << quantile(series.samples, 0.75) << std::endl;
+        run.series.push_back(std::move(series));
+        if (benchmark.memoryTag) {
+            std::cout << "  " << std::left << std::setw(22) << benchmark.memoryTag << std::right << "peak " << formatBytes(static_cast<int64_t>(quantile(peak.samples, 0.5)))
+                      << ", steady " << formatBytes(static_cast<int64_t>(quantile(steady.samples, 0.5))) << ", "
+                      << static_cast<uint64_t>(quantile(allocations.samples, 0.5)) << " allocations" << std::endl;
+            run.series.push_back(std::move(peak));
+            run.series.push_back(std::move(steady));
+            run.series.push_back(std::move(allocations));
+        }
+    }
+    return run;
+}
+
+// ---------------------------------------------------------------------------
+// Command line
+// ---------------------------------------------------------------------------
+
+std::string runLabel(const BenchmarkRun& run) {
+    char when[32];
+    std::time_t time = static_cast<std::time_t>(run.timestamp);
+    std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", std::localtime(&time));
+    return std::string(when) + "  " + run.commit.substr(0, 12) + (run.dirty ? "+dirty" : "") + "  machine " + run.fingerprint.substr(0, 8);
+}
+
+// A run file path, or the newest run of a commit prefix (preferring this machine)
+bool resolveRun(const std::string& spec, const std::vector<BenchmarkRun>& runs, const std::string& fingerprint, BenchmarkRun& run) {
+    if (loadRun(spec, run)) return true;
+    const BenchmarkRun* found = nullptr;
+    for (const auto& candidate : runs) {
+        if (candidate.commit.compare(0, spec.size(), spec) != 0) continue;
+        if (!found || candidate.fingerprint == fingerprint || found->fingerprint != fingerprint) found = &candidate;
+    }
+    if (found) run = *found;
+    return found != nullptr;
+}
+
+// Prints the comparison table; returns the number of regressions
+int printComparison(const BenchmarkRun& baseline, const BenchmarkRun& candidate) {
+    std::cout << "Baseline : " << runLabel(baseline) << "\nCandidate: " << runLabel(candidate) << std::endl;
+    if (baseline.fingerprint != candidate.fingerprint) {
+        std::cout << "Warning: runs are from different machines; differences may not be caused by the code\n  " << baseline.machine
+                  << "\n  " << candidate.machine << std::endl;
+    }
+    std::cout << "\n" << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "baseline" << std::setw(14) << "candidate"
+              << std::setw(10) << "change" << std::setw(10) << "p" << "  verdict" << std::endl;
+    int regressions = 0;
+    for (const auto& c : compareRuns(baseline, candidate)) {
+        std::cout << std::left << std::setw(36) << c.name << std::right << std::setprecision(4) << std::setw(14) << c.baseline << std::setw(14)
+                  << c.candidate << std::setw(9) << std::fixed << std::setprecision(1) << std::showpos << c.change * 100.0 << "%" << std::noshowpos
+                  << std::setw(10) << std::defaultfloat << std::setprecision(2) << c.p << "  "
+                  << (c.verdict < 0 ? "REGRESSION" : c.verdict > 0 ? "improvement" : "no significant change") << std::endl;
+        if (c.verdict < 0) regressions++;
+    }
+    std::cout << "\nFlagged when two-sided Mann-Whitney p < " << ALPHA << " and the median moves by at least " << MIN_EFFECT * 100 << "%: "
+              << regressions << " regression" << (regressions == 1 ? "" : "s") << std::endl;
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    BenchmarkRun here = describeCurrentRun();
+
+    if (mode == "list") {
+        std::string dir = argc > 2 ? argv[2] : DEFAULT_DIR;
+        for (const auto& run : loadRuns(dir)) std::cout << runLabel(run) << "  " << run.series.size() << " benchmarks  " << run.path << std::endl;
+        return 0;
+    }
+
+    if (mode == "compare" && argc >= 4) {
+        std::string dir = argc > 4 ? argv[4] : DEFAULT_DIR;
+        std::vector<BenchmarkRun> runs = loadRuns(dir);
+        BenchmarkRun baseline, candidate;
+        if (!resolveRun(argv[2], runs, here.fingerprint, baseline) || !resolveRun(argv[3], runs, here.fingerprint, candidate)) {
+            std::cerr << "No run matches " << (resolveRun(argv[2], runs, here.fingerprint, baseline) ? argv[3] : argv[2]) << " in " << dir << std::endl;
+            return 2;
+        }
+        return printComparison(baseline, candidate) > 0 ? 1 : 0;
+    }
+
+    // CSV of every stored sample summary, e.g. for the illustrations notebook
+    if (mode == "export") {
+        std::string dir = argc > 2 ? argv[2] : DEFAULT_DIR;
+        std::cout << "timestamp,commit,dirty,machine,benchmark,unit,higher_is_better,samples,median,q1,q3" << std::endl;
+        for (const auto& run : loadRuns(dir)) {
+            for (const auto& series : run.series) {
+                std::cout << run.timestamp << "," << run.commit << "," << run.dirty << "," << run.fingerprint << "," << series.name << ","
+                          << series.unit << "," << series.higherIsBetter << "," << series.samples.size() << "," << quantile(series.samples, 0.5)
+                          << "," << quantile(series.samples, 0.25) << "," << quantile(series.samples, 0.75) << std::endl;
+            }
+        }
+        return 0;
+    }
+
+    if (!mode.empty() && mode != "run") {
+        std::cerr << "Usage: " << argv[0] << " [run [dir] [repeats]] | list [dir] | compare <baseline> <candidate> [dir] | export [dir]\n"
+                  << "  <baseline>/<candidate>: a .bench file or a commit prefix (newest run, this machine preferred)" << std::endl;
+        return 2;
+    }
+
+    // Run the suite, store it, and compare with the previous run on this machine
+    std::string dir = argc > 2 ? argv[2] : DEFAULT_DIR;
+    int repeats = argc > 3 ? std::max(2, std::atoi(argv[3])) : DEFAULT_REPEATS;
+    std::cout << "Commit " << here.commit.substr(0, 12) << (here.dirty ? " (uncommitted changes)" : "") << ", machine " << here.fingerprint.substr(0, 8)
+              << ": " << here.machine << "\n" << repeats << " samples per benchmark\n" << std::endl;
+    std::vector<BenchmarkRun> previous = loadRuns(dir);
+    BenchmarkRun run = runSuite(repeats);
+    if (!saveRun(run, dir)) {
+        std::cerr << "Could not write " << run.path << std::endl;
+        return 2;
+    }
+    std::cout << "\nStored " << run.path << std::endl;
+    for (auto it = previous.rbegin(); it != previous.rend(); ++it) {
+        if (it->fingerprint == run.fingerprint) {
+            std::cout << std::endl;
+            return printComparison(*it, run) > 0 ? 1 : 0;
+        }
+    }
+    std::cout << "No earlier run on this machine to compare with" << std::endl;
+    return 0;
+}
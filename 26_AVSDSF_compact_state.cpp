@@ -0,0 +1,419 @@
+/*
+AVSDSF - Compact float32 / scaled int32 state for RSU and request tables
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include "avsdsf_model.h"
+#include "avsdsf_perf.h"
+
+const int DEFAULT_STREAM_REQUESTS = 10000000; // Requests in the streaming (bandwidth) experiment
+const int PRECISION_RSUS = 2000;
+const int PRECISION_REQUESTS = 20000;
+const double PRECISION_CAPACITY_FACTOR = 1.2;  // Capacity binds, so rounding can change feasibility
+const long long ARGMIN_EVALUATIONS = 40000000; // RSU evaluations per argmin measurement
+const int REPEATS = 5;                         // Best of, per measurement
+
+using Clock = std::chrono::steady_clock;
+
+// Signed fixed point in an int32 with FractionBits fractional bits, rounded
+// to nearest and saturated at the range ends. Converts to double for cost
+// arithmetic; capacity sums, checks and updates stay in integers (exact).
+template <int FractionBits>
+struct Fixed32 {
+    static constexpr double SCALE = static_cast<double>(1LL << FractionBits);
+    static constexpr double MAX = std::numeric_limits<int32_t>::max() / SCALE;
+
+    int32_t raw;
+
+    Fixed32() = default;
+    explicit Fixed32(double value) : raw(static_cast<int32_t>(std::llround(std::clamp(value, -MAX, MAX) * SCALE))) {}
+
+    static Fixed32 fromRaw(int64_t value) {
+        Fixed32 fixed;
+        fixed.raw = static_cast<int32_t>(std::clamp<int64_t>(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+        return fixed;
+    }
+    static Fixed32 below(double value) { return fromRaw(static_cast<int64_t>(std::floor(std::clamp(value, -MAX, MAX) * SCALE))); }
+    static Fixed32 above(double value) { return fromRaw(static_cast<int64_t>(std::ceil(std::clamp(value, -MAX, MAX) * SCALE))); }
+
+    operator double() const { return raw * (1.0 / SCALE); }
+
+    Fixed32& operator+=(Fixed32 other) {
+        raw += other.raw;
+        return *this;
+    }
+    friend Fixed32 operator+(Fixed32 a, Fixed32 b) { return fromRaw(static_cast<int64_t>(a.raw) + b.raw); }
+    friend bool operator<=(Fixed32 a, Fixed32 b) { return a.raw <= b.raw; }
+};
+
+// Scales of the int32 layout (value ranges in the model's units):
+using FixedCapacity = Fixed32<10>; // capacity, load, demand: up to ~2.1e6, step ~0.001
+using FixedCost = Fixed32<24>;     // per-unit costs: up to 128, step 6e-8
+using FixedDistance = Fixed32<16>; // distance (m) and deadline (s): up to 32767, step 1.5e-5
+
+// Capacities round down and loads up in fixed point, so a placement that
+// fits in int32 also fits on the exact values; other types round to nearest
+template <typename T>
+T capacityLimit(double value) { return static_cast<T>(value); }
+template <typename T>
+T capacityUse(double value) { return static_cast<T>(value); }
+template <>
+FixedCapacity capacityLimit<FixedCapacity>(double value) { return FixedCapacity::below(value); }
+template <>
+FixedCapacity capacityUse<FixedCapacity>(double value) { return FixedCapacity::above(value); }
+
+// Same fields and names as RSU, in the given field types (all 4 bytes, so packed)
+template <typename Capacity, typename Cost>
+struct PackedRSU {
+    int32_t id;
+    Capacity maxCapacity;
+    Capacity usedCapacity;
+    Cost retentionCost;
+    Cost computationCost;
+    Cost preparationCost;
+
+    PackedRSU() = default;
+    explicit PackedRSU(const RSU& rsu)
+        : id(rsu.id), maxCapacity(capacityLimit<Capacity>(rsu.maxCapacity)), usedCapacity(capacityUse<Capacity>(rsu.usedCapacity)),
+          retentionCost(static_cast<Cost>(rsu.retentionCost)), computationCost(static_cast<Cost>(rsu.computationCost)),
+          preparationCost(static_cast<Cost>(rsu.preparationCost)) {}
+};
+
+// Same fields and names as ServiceRequest
+template <typename Time, typename Capacity, typename Cost, typename Distance>
+struct PackedRequest {
+    int32_t id;
+    Time deadline;
+    Capacity computationLoad;
+    Cost transferCost;
+    Cost preparationCost;
+    Capacity demand;
+    Distance distanceToRSU;
+
+    PackedRequest() = default;
+    explicit PackedRequest(const ServiceRequest& request)
+        : id(request.id), deadline(static_cast<Time>(request.deadline)), computationLoad(capacityUse<Capacity>(request.computationLoad)),
+          transferCost(static_cast<Cost>(request.transferCost)), preparationCost(static_cast<Cost>(request.preparationCost)),
+          demand(capacityUse<Capacity>(request.demand)), distanceToRSU(static_cast<Distance>(request.distanceToRSU)) {}
+};
+
+// Storage layouts the scheduler is instantiated with. Real is the type the
+// cost arithmetic runs in.
+struct DoubleLayout {
+    using Real = double;
+    using RSUType = RSU;
+    using RequestType = ServiceRequest;
+    static constexpr const char* name = "double";
+};
+
+struct FloatLayout {
+    using Real = float;
+    using RSUType = PackedRSU<float, float>;
+    using RequestType = PackedRequest<float, float, float, float>;
+    static constexpr const char* name = "float32";
+};
+
+struct FixedLayout {
+    using Real = double;
+    using RSUType = PackedRSU<FixedCapacity, FixedCost>;
+    using RequestType = PackedRequest<FixedDistance, FixedCapacity, FixedCost, FixedDistance>;
+    static constexpr const char* name = "int32 fixed";
+};
+
+static_assert(sizeof(FloatLayout::RSUType) == 24 && sizeof(FixedLayout::RSUType) == 24, "compact RSU is 6 x 4 bytes");
+static_assert(sizeof(FloatLayout::RequestType) == 28 && sizeof(FixedLayout::RequestType) == 28, "compact request is 7 x 4 bytes");
+
+template <typename Layout>
+struct Tables {
+    std::vector<typename Layout::RSUType> rsus;
+    std::vector<typename Layout::RequestType> requests;
+};
+
+template <typename Layout>
+Tables<Layout> convertTables(const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests) {
+    Tables<Layout> tables;
+    tables.rsus.reserve(rsus.size());
+    for (const auto& rsu : rsus) tables.rsus.push_back(typename Layout::RSUType(rsu));
+    tables.requests.reserve(requests.size());
+    for (const auto& request : requests) tables.requests.push_back(typename Layout::RequestType(request));
+    return tables;
+}
+
+// ---------------------------------------------------------------------------
+// Scheduler code, identical for every layout (schedule and transfer phases of
+// 6_AVSDSF_final.cpp, and its cost accounting)
+// ---------------------------------------------------------------------------
+
+template <typename Layout>
+void scheduleRequests(const std::vector<typename Layout::RequestType>& requests, std::vector<typename Layout::RSUType>& rsus,
+                      const std::vector<double>& weights, std::vector<int32_t>& X) {
+    using Real = typename Layout::Real;
+    const Real w0 = static_cast<Real>(weights[0]), w1 = static_cast<Real>(weights[1]);
+    const Real w2 = static_cast<Real>(weights[2]), w3 = static_cast<Real>(weights[3]);
+    for (const auto& request : requests) {
+        Real minCost = std::numeric_limits<Real>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.computationLoad <= rsu.maxCapacity) {
+                Real cost = w0 * rsu.computationCost * request.computationLoad + w1 * rsu.retentionCost + w2 * request.transferCost +
+                            w3 * request.preparationCost;
+                if (cost < minCost) {
+                    minCost = cost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        X[request.id] = bestRSU;
+        if (bestRSU != -1) rsus[bestRSU].usedCapacity += request.computationLoad;
+    }
+}
+
+template <typename Layout>
+void transferRequests(const std::vector<typename Layout::RequestType>& requests, std::vector<typename Layout::RSUType>& rsus, std::vector<int32_t>& T) {
+    using Real = typename Layout::Real;
+    const Real multiplier = static_cast<Real>(TRANSFER_COST_MULTIPLIER);
+    for (const auto& request : requests) {
+        Real minTransferCost = std::numeric_limits<Real>::max();
+        int bestRSU = -1;
+        for (const auto& rsu : rsus) {
+            if (rsu.usedCapacity + request.demand <= rsu.maxCapacity) {
+                Real transferCost = request.distanceToRSU + multiplier * rsu.usedCapacity / rsu.maxCapacity;
+                if (transferCost < minTransferCost) {
+                    minTransferCost = transferCost;
+                    bestRSU = rsu.id;
+                }
+            }
+        }
+        T[request.id] = bestRSU;
+        if (bestRSU != -1) rsus[bestRSU].usedCapacity += request.demand;
+    }
+}
+
+// Per-request cost in the layout's arithmetic, summed in double (a float
+// running sum over millions of requests would lose the small terms)
+template <typename Layout>
+double accountCost(const std::vector<typename Layout::RequestType>& requests, const std::vector<typename Layout::RSUType>& rsus,
+                   const std::vector<int32_t>& X) {
+    using Real = typename Layout::Real;
+    double totalCost = 0.0;
+    for (const auto& request : requests) {
+        int assigned = X[request.id];
+        if (assigned < 0) continue;
+        const auto& rsu = rsus[assigned];
+        Real cost = rsu.computationCost * request.computationLoad + rsu.retentionCost + request.transferCost + request.preparationCost;
+        totalCost += cost;
+    }
+    return totalCost;
+}
+
+// ---------------------------------------------------------------------------
+// Experiments
+// ---------------------------------------------------------------------------
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct PrecisionResult {
+    double agreementX;         // Fraction of schedule decisions equal to the double run
+    double agreementT;
+    double exactCost;          // Cost of this layout's decisions, evaluated on double data
+    double reportedCost;       // Same decisions, evaluated in the layout's own arithmetic
+    double maxOvercommit;      // Largest (used - max) / max over RSUs, on double data
+    int overcommittedRSUs;
+    int dropped;
+};
+
+// Schedules the whole scenario in one layout and judges the decisions on the double data
+template <typename Layout>
+PrecisionResult runPrecision(const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests, const std::vector<int32_t>* referenceX,
+                             const std::vector<int32_t>* referenceT, std::vector<int32_t>& X, std::vector<int32_t>& T) {
+    Tables<Layout> tables = convertTables<Layout>(rsus, requests);
+    std::vector<double> weights = computeDynamicWeights(computeSystemLoad(rsus));
+    X.assign(requests.size(), -1);
+    T.assign(requests.size(), -1);
+    scheduleRequests<Layout>(tables.requests, tables.rsus, weights, X);
+    transferRequests<Layout>(tables.requests, tables.rsus, T);
+
+    PrecisionResult result{1.0, 1.0, 0.0, 0.0, 0.0, 0, 0};
+    Tables<Layout> fresh = convertTables<Layout>(rsus, requests);
+    result.reportedCost = accountCost<Layout>(fresh.requests, fresh.rsus, X);
+    result.exactCost = accountCost<DoubleLayout>(requests, rsus, X);
+
+    std::vector<double> used(rsus.size(), 0.0);
+    size_t sameX = 0, sameT = 0;
+    for (const auto& request : requests) {
+        if (X[request.id] >= 0) used[X[request.id]] += request.computationLoad;
+        else result.dropped++;
+        if (T[request.id] >= 0) used[T[request.id]] += request.demand;
+        if (referenceX && (*referenceX)[request.id] == X[request.id]) sameX++;
+        if (referenceT && (*referenceT)[request.id] == T[request.id]) sameT++;
+    }
+    if (referenceX) result.agreementX = static_cast<double>(sameX) / requests.size();
+    if (referenceT) result.agreementT = static_cast<double>(sameT) / requests.size();
+    for (const auto& rsu : rsus) {
+        double over = (used[rsu.id] - rsu.maxCapacity) / rsu.maxCapacity;
+        if (over > 0.0) {
+            result.overcommittedRSUs++;
+            result.maxOvercommit = std::max(result.maxOvercommit, over);
+        }
+    }
+    return result;
+}
+
+struct Measurement {
+    double seconds = std::numeric_limits<double>::max(); // Best of REPEATS
+    CounterSample counters;
+};
+
+// Cost accounting over a large request table: a streaming, bandwidth-bound pass
+template <typename Layout>
+Measurement measureStreaming(const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests, const std::vector<int32_t>& X,
+                             double& totalCost, size_t& tableBytes) {
+    Tables<Layout> tables = convertTables<Layout>(rsus, requests);
+    tableBytes = tables.requests.size() * sizeof(typename Layout::RequestType);
+    Measurement best;
+    bool counting = PerfCounters::requested();
+    for (int r = 0; r < REPEATS; ++r) {
+        CounterSample countersStart;
+        if (counting) countersStart = PerfCounters::forThread().read();
+        auto start = Clock::now();
+        totalCost = accountCost<Layout>(tables.requests, tables.rsus, X);
+        double seconds = secondsSince(start);
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            if (counting) best.counters = PerfCounters::forThread().read() - countersStart;
+        }
+    }
+    return best;
+}
+
+// RS-MAS argmin over an RSU table of the given size: cache-bound once the table leaves L1/L2
+template <typename Layout>
+Measurement measureArgmin(const std::vector<RSU>& rsus, const std::vector<ServiceRequest>& requests, long long& placed) {
+    Tables<Layout> base = convertTables<Layout>(rsus, requests);
+    std::vector<double> weights = computeDynamicWeights(0.5);
+    std::vector<int32_t> X(requests.size(), -1);
+    Measurement best;
+    bool counting = PerfCounters::requested();
+    for (int r = 0; r < REPEATS; ++r) {
+        std::vector<typename Layout::RSUType> table = base.rsus;
+        CounterSample countersStart;
+        if (counting) countersStart = PerfCounters::forThread().read();
+        auto start = Clock::now();
+        scheduleRequests<Layout>(base.requests, table, weights, X);
+        double seconds = secondsSince(start);
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            if (counting) best.counters = PerfCounters::forThread().read() - countersStart;
+        }
+    }
+    placed = std::count_if(X.begin(), X.end(), [](int32_t x) { return x >= 0; });
+    return best;
+}
+
+template <typename Layout>
+void printPrecision(const PrecisionResult& result, double referenceCost) {
+    std::cout << std::left << std::setw(13) << Layout::name << std::right << std::fixed << std::setprecision(2) << std::setw(9)
+              << result.agreementX * 100.0 << "%" << std::setw(9) << result.agreementT * 100.0 << "%" << std::setprecision(4) << std::setw(13)
+              << result.exactCost << std::scientific << std::setprecision(2) << std::setw(12) << (result.exactCost - referenceCost) / referenceCost
+              << std::setw(12) << std::fabs(result.reportedCost - result.exactCost) / result.exactCost << std::fixed << std::setw(8)
+              << result.overcommittedRSUs << std::scientific << std::setw(11) << result.maxOvercommit << std::defaultfloat << std::setw(9)
+              << result.dropped << std::endl;
+}
+
+template <typename Layout>
+void printMeasurement(const char* label, const Measurement& measurement, double baselineSeconds, size_t bytes, long long passes, long long items,
+                      const char* itemName) {
+    std::cout << "  " << std::left << std::setw(13) << Layout::name << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+              << bytes / (1024.0 * 1024.0) << " MiB" << std::setw(11) << std::setprecision(3) << measurement.seconds * 1000.0 << " ms"
+              << std::setw(10) << std::setprecision(2) << measurement.seconds * 1e9 / items << " ns/" << itemName << std::setw(9)
+              << static_cast<double>(bytes) * passes / measurement.seconds / 1e9 << " GB/s" << std::setw(8) << baselineSeconds / measurement.seconds << "x" << std::defaultfloat
+              << std::endl;
+    if (PerfCounters::requested() && PerfCounters::forThread().ok()) std::cout << "    " << label << ": " << describeCounters(measurement.counters, items) << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int streamRequests = argc > 1 ? std::max(1000, std::atoi(argv[1])) : DEFAULT_STREAM_REQUESTS;
+
+    std::cout << "Record sizes: RSU " << sizeof(RSU) << " -> " << sizeof(FloatLayout::RSUType) << " bytes, ServiceRequest " << sizeof(ServiceRequest)
+              << " -> " << sizeof(FloatLayout::RequestType) << " bytes (float32 and scaled int32 alike)" << std::endl;
+    if (PerfCounters::requested() && !PerfCounters::forThread().ok()) {
+        std::cout << "Hardware counters unavailable (" << PerfCounters::forThread().unavailableReason << "); wall-clock only" << std::endl;
+    }
+
+    // 1. Precision: same scenario, same scheduler code, three layouts
+    {
+        std::vector<RSU> rsus;
+        std::vector<ServiceRequest> requests;
+        std::vector<PrefetchedService> services;
+        generateScenario(PRECISION_RSUS, PRECISION_REQUESTS, 20, 41, rsus, requests, services, PRECISION_CAPACITY_FACTOR);
+        std::vector<int32_t> referenceX, referenceT, X, T;
+        PrecisionResult reference = runPrecision<DoubleLayout>(rsus, requests, nullptr, nullptr, referenceX, referenceT);
+        PrecisionResult single = runPrecision<FloatLayout>(rsus, requests, &referenceX, &referenceT, X, T);
+        PrecisionResult fixed = runPrecision<FixedLayout>(rsus, requests, &referenceX, &referenceT, X, T);
+
+        std::cout << "\nPrecision (" << PRECISION_RSUS << " RSUs, " << PRECISION_REQUESTS << " requests, capacity factor " << PRECISION_CAPACITY_FACTOR
+                  << "; costs of each layout's decisions evaluated on the double data)\n"
+                  << std::left << std::setw(13) << "layout" << std::right << std::setw(10) << "same X" << std::setw(10) << "same T" << std::setw(13)
+                  << "total cost" << std::setw(12) << "vs double" << std::setw(12) << "own error" << std::setw(8) << "overRSU" << std::setw(11)
+                  << "max over" << std::setw(9) << "dropped" << std::endl;
+        printPrecision<DoubleLayout>(reference, reference.exactCost);
+        printPrecision<FloatLayout>(single, reference.exactCost);
+        printPrecision<FixedLayout>(fixed, reference.exactCost);
+    }
+
+    // 2. Bandwidth: cost accounting streams the whole request table once
+    {
+        std::vector<RSU> rsus;
+        std::vector<ServiceRequest> requests;
+        std::vector<PrefetchedService> services;
+        generateScenario(1000, streamRequests, 20, 43, rsus, requests, services);
+        std::vector<int32_t> X(requests.size());
+        for (size_t i = 0; i < X.size(); ++i) X[i] = static_cast<int32_t>((i * 2654435761u) % rsus.size());
+
+        std::cout << "\nStreaming cost accounting over " << streamRequests << " requests (request table, best of " << REPEATS << ")" << std::endl;
+        double costDouble, costFloat, costFixed;
+        size_t bytesDouble, bytesFloat, bytesFixed;
+        Measurement wide = measureStreaming<DoubleLayout>(rsus, requests, X, costDouble, bytesDouble);
+        Measurement single = measureStreaming<FloatLayout>(rsus, requests, X, costFloat, bytesFloat);
+        Measurement fixed = measureStreaming<FixedLayout>(rsus, requests, X, costFixed, bytesFixed);
+        printMeasurement<DoubleLayout>("accounting", wide, wide.seconds, bytesDouble, 1, streamRequests, "request");
+        printMeasurement<FloatLayout>("accounting", single, wide.seconds, bytesFloat, 1, streamRequests, "request");
+        printMeasurement<FixedLayout>("accounting", fixed, wide.seconds, bytesFixed, 1, streamRequests, "request");
+        std::cout << "  total cost relative difference: float32 " << std::scientific << std::setprecision(2) << (costFloat - costDouble) / costDouble
+                  << ", int32 fixed " << (costFixed - costDouble) / costDouble << std::defaultfloat << std::endl;
+    }
+
+    // 3. Cache footprint: argmin over RSU tables from L1-sized to larger than L2
+    std::cout << "\nRS-MAS argmin by RSU table size (" << ARGMIN_EVALUATIONS / 1000000 << "M RSU evaluations each, best of " << REPEATS << ")" << std::endl;
+    for (int numRSUs : {1000, 16000, 250000}) {
+        std::vector<RSU> rsus;
+        std::vector<ServiceRequest> requests;
+        std::vector<PrefetchedService> services;
+        int numRequests = static_cast<int>(ARGMIN_EVALUATIONS / numRSUs);
+        generateScenario(numRSUs, numRequests, 20, 47, rsus, requests, services);
+        long long placedDouble, placedFloat, placedFixed;
+        Measurement wide = measureArgmin<DoubleLayout>(rsus, requests, placedDouble);
+        Measurement single = measureArgmin<FloatLayout>(rsus, requests, placedFloat);
+        Measurement fixed = measureArgmin<FixedLayout>(rsus, requests, placedFixed);
+        long long evaluations = static_cast<long long>(numRSUs) * numRequests;
+        std::cout << " " << numRSUs << " RSUs x " << numRequests << " requests" << std::endl;
+        printMeasurement<DoubleLayout>("argmin", wide, wide.seconds, numRSUs * sizeof(DoubleLayout::RSUType), numRequests, evaluations, "RSU");
+        printMeasurement<FloatLayout>("argmin", single, wide.seconds, numRSUs * sizeof(FloatLayout::RSUType), numRequests, evaluations, "RSU");
+        printMeasurement<FixedLayout>("argmin", fixed, wide.seconds, numRSUs * sizeof(FixedLayout::RSUType), numRequests, evaluations, "RSU");
+        if (placedFloat != placedDouble || placedFixed != placedDouble) {
+            std::cout << "  placed: double " << placedDouble << ", float32 " << placedFloat << ", int32 fixed " << placedFixed << std::endl;
+        }
+    }
+    std::cout << "(argmin GB/s: RSU table bytes read per request times requests, over the measured time)" << std::endl;
+    return 0;
+}
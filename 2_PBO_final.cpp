@@ -8,13 +8,15 @@ Pressure Based Optimization
 #include <algorithm>
 #include <chrono> // For measuring execution time
 #include <random> // Include the random library for introducing randomness
+#include "avsdsf_trace.h"
+#include "avsdsf_intern.h"
 
 using namespace std;
 using namespace std::chrono;
 
 // Structure to represent a Compute Unit (Edge/Cloud Server)
 struct ComputeUnit {
-    string id;
+    NameId id;                // Interned unit name (nameOf for output)
     double cpu_usage;         // Resource pressure
     double network_latency;   // Latency to other compute units
     int function_replicas;    // Number of running function instances
@@ -23,7 +25,7 @@ struct ComputeUnit {
 
 // Structure to represent a Serverless Function
 struct FunctionInstance {
-    string id;
+    NameId id;
     ComputeUnit* host;
 };
 
@@ -74,6 +76,7 @@ double computeLatency(double dataSize, double transferRate) {
 
 // Scaling Function Based on Pressure
 void scaleFunctions(vector<ComputeUnit>& units, double threshold_max, double threshold_min) {
+    TracePhase phase("scaling");
     for (auto& unit : units) {
         double pREQ = calculateRequestPressure(unit.function_replicas, unit.max_capacity);
         double pRTT = calculatePerformancePressure(unit.network_latency, 70.0);
@@ -81,10 +84,10 @@ void scaleFunctions(vector<ComputeUnit>& units, double threshold_max, double thr
         double pressure = computePressure(pREQ, pRTT, pRES);
         
         if (pressure > threshold_max && unit.function_replicas < unit.max_capacity) {
-            // cout << "Scaling UP on: " << unit.id << endl;
+            // cout << "Scaling UP on: " << nameOf(unit.id) << endl;
             unit.function_replicas++;
         } else if (pressure < threshold_min && unit.function_replicas > 1) {
-            // cout << "Scaling DOWN on: " << unit.id << endl;
+            // cout << "Scaling DOWN on: " << nameOf(unit.id) << endl;
             unit.function_replicas--;
         }
     }
@@ -92,6 +95,7 @@ void scaleFunctions(vector<ComputeUnit>& units, double threshold_max, double thr
 
 // Placement Decision: Find the Best Compute Unit for Deployment
 ComputeUnit* findBestPlacement(vector<ComputeUnit>& units, double threshold_max) {
+    TracePhase phase("schedule");
     ComputeUnit* bestUnit = nullptr;
     double lowestPressure = threshold_max;
 
@@ -113,7 +117,8 @@ ComputeUnit* findBestPlacement(vector<ComputeUnit>& units, double threshold_max)
 }
 
 // Router Optimization: Load Balancing Based on Latency & Resources
-void optimizeRouting(vector<ComputeUnit>& units, unordered_map<string, vector<FunctionInstance>>& functionMap) {
+void optimizeRouting(vector<ComputeUnit>& units, unordered_map<NameId, vector<FunctionInstance>>& functionMap) {
+    TracePhase phase("routing");
     for (auto& [funcId, instances] : functionMap) {
         double totalWeight = 0;
         unordered_map<ComputeUnit*, double> weights;
@@ -127,20 +132,21 @@ void optimizeRouting(vector<ComputeUnit>& units, unordered_map<string, vector<Fu
             totalWeight += weight;
         }
 
-        // cout << "Routing Weights for Function " << funcId << ":\n";
+        // cout << "Routing Weights for Function " << nameOf(funcId) << ":\n";
         for (auto& [unit, weight] : weights) {
-            // cout << "  " << unit->id << " -> " << (weight / totalWeight) * 100 << "% traffic\n";
+            // cout << "  " << nameOf(unit->id) << " -> " << (weight / totalWeight) * 100 << "% traffic\n";
         }
     }
 }
 
 // Function to simulate time slots and measure performance
-void simulateTimeSlots(vector<ComputeUnit>& units, unordered_map<string, vector<FunctionInstance>>& functionMap, int numSlots) {
+void simulateTimeSlots(vector<ComputeUnit>& units, unordered_map<NameId, vector<FunctionInstance>>& functionMap, int numSlots) {
     random_device rd;
     mt19937 gen(rd()); // Mersenne Twister random number generator
     uniform_real_distribution<> dis(0.01, 0.05); // Uniform distribution for small fluctuations (5% range)
 
     for (int timeSlot = 0; timeSlot < numSlots; ++timeSlot) {
+        TracePhase slot("slot");
         
 
         cout << "\n--- Time Slot " << timeSlot << " ---\n";
@@ -152,14 +158,15 @@ void simulateTimeSlots(vector<ComputeUnit>& units, unordered_map<string, vector<
         // Placement decisions
         ComputeUnit* bestUnit = findBestPlacement(units, 0.5);
         if (bestUnit) {
-            // functionMap["funcA"].push_back({"inst_new", bestUnit});
-            // cout << "New Function Instance placed on: " << bestUnit->id << endl;
+            // functionMap[internName("funcA")].push_back({internName("inst_new"), bestUnit});
+            // cout << "New Function Instance placed on: " << nameOf(bestUnit->id) << endl;
         }
 
         // Optimize routing
         optimizeRouting(units, functionMap);
 
         // Compute total cost and latency
+        traceBegin("cost");
         double totalCost = 0.0;
         double totalLatency = 0.0;
 
@@ -180,6 +187,7 @@ void simulateTimeSlots(vector<ComputeUnit>& units, unordered_map<string, vector<
                 totalLatency += latency;
             }
         }
+        traceEnd();
 
         cout << "Total Cost: " << totalCost << endl;
         cout << "Total Latency: " << totalLatency * 1000000 << " microseconds" << endl; // Latency in microseconds
@@ -191,16 +199,16 @@ void simulateTimeSlots(vector<ComputeUnit>& units, unordered_map<string, vector<
 }
 
 int main() {
-    // Example Compute Units
+    // Example Compute Units (names are interned here, at the input boundary)
     vector<ComputeUnit> compute_units = {
-        {"Edge-1", 30.0, 50.0, 3, 10},
-        {"Edge-2", 40.0, 60.0, 2, 10},
-        {"Cloud", 70.0, 150.0, 5, 20}
+        {internName("Edge-1"), 30.0, 50.0, 3, 10},
+        {internName("Edge-2"), 40.0, 60.0, 2, 10},
+        {internName("Cloud"), 70.0, 150.0, 5, 20}
     };
 
     // Serverless Functions and Instances
-    unordered_map<string, vector<FunctionInstance>> functionInstances;
-    functionInstances["funcA"] = {{"inst1", &compute_units[0]}, {"inst2", &compute_units[1]}};
+    unordered_map<NameId, vector<FunctionInstance>> functionInstances;
+    functionInstances[internName("funcA")] = {{internName("inst1"), &compute_units[0]}, {internName("inst2"), &compute_units[1]}};
 
     // Simulate time slots and performance measurement
     simulateTimeSlots(compute_units, functionInstances, 5);
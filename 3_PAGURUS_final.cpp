@@ -9,20 +9,30 @@ PAGURUS
 #include <chrono>
 #include <set>
 #include <iomanip>
+#include "avsdsf_trace.h"
+#include "avsdsf_memory.h"
+#include "avsdsf_pool.h"
+#include "avsdsf_intern.h"
+
+// Container types, interned like function names
+const NameId PRIVATE_CONTAINER = internName("private");
+const NameId ZYGOTE_CONTAINER = internName("zygote");
+const NameId HELPER_CONTAINER = internName("helper");
 
 // Structure to represent a function container
 struct Container {
-    std::string functionName;
-    std::string type; // "private", "zygote", "helper"
+    NameId functionName;
+    NameId type; // PRIVATE_CONTAINER, ZYGOTE_CONTAINER or HELPER_CONTAINER
     bool isIdle;
     
-    Container(std::string name, std::string t, bool idle) : functionName(name), type(t), isIdle(idle) {}
+    Container(NameId name, NameId t, bool idle) : functionName(name), type(t), isIdle(idle) {}
 };
 
 class PagurusManager {
 private:
-    std::unordered_map<std::string, std::vector<Container>> functionContainers; // Map of function name to its containers
-    std::unordered_map<std::string, std::set<std::string>> functionDependencies; // Tracks function dependencies
+    IndexPool<Container> containerPool; // Storage of all containers; freed slots are reused
+    std::unordered_map<NameId, PoolList> functionContainers; // Map of function to its containers (linked through the pool)
+    std::unordered_map<NameId, std::set<NameId>> functionDependencies; // Tracks function dependencies
     std::vector<double> costPerSlot; // Tracks costs for each time slot
     std::vector<double> latencies; // Tracks latencies for each time slot
     std::random_device rd;
@@ -34,12 +44,13 @@ public:
 
     // Identify idle containers and convert them to zygote
     void identifyIdleContainers(int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+        TracePhase phase("retention");
         double cost = 0.0;
         auto start = std::chrono::high_resolution_clock::now();  // Start latency measurement
         for (auto& func : functionContainers) {
-            for (auto& container : func.second) {
-                if (container.isIdle && container.type == "private") {
-                    container.type = "zygote"; // Convert idle private container to zygote
+            for (auto& container : containerPool.items(func.second)) {
+                if (container.isIdle && container.type == PRIVATE_CONTAINER) {
+                    container.type = ZYGOTE_CONTAINER; // Convert idle private container to zygote
                     double dynamicCost = 0.1 + costVariation(gen);
                     cost += dynamicCost;
                 }
@@ -51,12 +62,14 @@ public:
     }
 
     // Function to fork a zygote container into a helper container
-    void forkZygote(std::string functionName, std::string targetFunction, int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+    void forkZygote(NameId functionName, NameId targetFunction, int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+        TracePhase phase("scaling");
         double cost = 0.0;
         auto start = std::chrono::high_resolution_clock::now();  // Start latency measurement
-        for (auto& container : functionContainers[functionName]) {
-            if (container.type == "zygote") {
-                functionContainers[targetFunction].push_back(Container(targetFunction, "helper", false));
+        for (auto& container : containerPool.items(functionContainers[functionName])) {
+            if (container.type == ZYGOTE_CONTAINER) {
+                MemoryTag memory("pagurus.containers");
+                containerPool.append(functionContainers[targetFunction], Container(targetFunction, HELPER_CONTAINER, false)); // May relocate `container`; not used after this
                 double dynamicCost = 0.05 + costVariation(gen);
                 cost += dynamicCost;
                 costPerSlot[timeSlot] += cost;
@@ -68,12 +81,12 @@ public:
     }
 
     // Implementing SF-WRS selection
-    std::string selectFunctionToHelp(std::string functionName) {
-        std::vector<std::string> candidates;
+    NameId selectFunctionToHelp(NameId functionName) {
+        std::vector<NameId> candidates;
         for (const auto& func : functionDependencies[functionName]) {
             candidates.push_back(func);
         }
-        if (candidates.empty()) return "";
+        if (candidates.empty()) return NO_NAME;
 
         std::uniform_int_distribution<> dis(0, candidates.size() - 1);
         return candidates[dis(gen)];
@@ -81,26 +94,30 @@ public:
 
     // Load balancer to distribute functions efficiently
     void balanceFunctions(int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+        TracePhase phase("routing");
         double dynamicCost = 0.05 + costVariation(gen);
         costPerSlot[timeSlot] += dynamicCost;
     }
 
     // Function to add a new container
-    void addContainer(std::string functionName, std::string type) {
-        functionContainers[functionName].push_back(Container(functionName, type, true));
+    void addContainer(NameId functionName, NameId type) {
+        MemoryTag memory("pagurus.containers");
+        containerPool.append(functionContainers[functionName], Container(functionName, type, true));
     }
 
     // Establish function dependencies to enable helper containers
     void setupFunctionDependencies() {
-        functionDependencies["FunctionA"].insert("FunctionB"); // FunctionA can help FunctionB
-        functionDependencies["FunctionB"].insert("FunctionA"); // FunctionB can help FunctionA
+        MemoryTag memory("pagurus.dependencies");
+        functionDependencies[internName("FunctionA")].insert(internName("FunctionB")); // FunctionA can help FunctionB
+        functionDependencies[internName("FunctionB")].insert(internName("FunctionA")); // FunctionB can help FunctionA
     }
 
     // Simulating function invocation and container utilization
-    void simulateFunctionInvocation(std::string functionName, int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+    void simulateFunctionInvocation(NameId functionName, int timeSlot, std::chrono::time_point<std::chrono::high_resolution_clock>& slotStartTime) {
+        TracePhase phase("schedule");
         double cost = 0.0;
         auto start = std::chrono::high_resolution_clock::now();  // Start latency measurement
-        for (auto& container : functionContainers[functionName]) {
+        for (auto& container : containerPool.items(functionContainers[functionName])) {
             if (!container.isIdle) {
                 double dynamicCost = 0.02 + costVariation(gen);
                 cost += dynamicCost;
@@ -110,12 +127,12 @@ public:
                 return;
             }
         }
-        std::string helperFunction = selectFunctionToHelp(functionName);
-        if (!helperFunction.empty()) {
+        NameId helperFunction = selectFunctionToHelp(functionName);
+        if (helperFunction != NO_NAME) {
             forkZygote(helperFunction, functionName, timeSlot, slotStartTime);
         } else {
             double dynamicCost = 0.3 + costVariation(gen);
-            addContainer(functionName, "private");
+            addContainer(functionName, PRIVATE_CONTAINER);
             cost += dynamicCost;
         }
         costPerSlot[timeSlot] += cost;
@@ -133,24 +150,31 @@ public:
 };
 
 int main() {
+    // Function names are interned once here; the manager works on ids
+    NameId functionA = internName("FunctionA");
+    NameId functionB = internName("FunctionB");
+
     PagurusManager manager;
     manager.setupFunctionDependencies();
-    manager.addContainer("FunctionA", "private");
-    manager.addContainer("FunctionB", "private");
+    manager.addContainer(functionA, PRIVATE_CONTAINER);
+    manager.addContainer(functionB, PRIVATE_CONTAINER);
 
     auto start = std::chrono::high_resolution_clock::now();
     for (int timeSlot = 0; timeSlot < 5; ++timeSlot) {
+        TracePhase slot("slot");
         auto slotStartTime = std::chrono::high_resolution_clock::now(); // Start time for this time slot
         manager.identifyIdleContainers(timeSlot, slotStartTime);
-        manager.simulateFunctionInvocation("FunctionA", timeSlot, slotStartTime);
-        manager.simulateFunctionInvocation("FunctionB", timeSlot, slotStartTime);
+        manager.simulateFunctionInvocation(functionA, timeSlot, slotStartTime);
+        manager.simulateFunctionInvocation(functionB, timeSlot, slotStartTime);
         manager.balanceFunctions(timeSlot, slotStartTime);
+        memoryCheckpoint();
     }
     auto end = std::chrono::high_resolution_clock::now();  // Get end time
 
     std::chrono::duration<double> duration = end - start;  // Calculate the total duration
 
     manager.displayCostsAndLatencies();
+    printMemoryReport(std::cout);
     // std::cout << "Total time taken for the entire operation: " << duration.count() << " seconds" << std::endl;
     return 0;
 }
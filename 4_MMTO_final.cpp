@@ -9,6 +9,7 @@ MMTO
 #include <limits>
 #include <random>
 #include <chrono>
+#include "avsdsf_trace.h"
 
 // Constants and parameters
 const double GAMMA = 1.0; // Sensitivity for dynamic weight adjustment
@@ -79,6 +80,8 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
     double totalOverallLatency = 0.0;  // To accumulate the overall latency over time slots
 
     for (int t = 0; t < T; ++t) {
+        TracePhase slot("slot");
+
         // Simulate varying request loads and RSU parameters over time
         for (auto& request : requests) {
             double y = dis(gen);
@@ -105,6 +108,7 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
         weights = computeDynamicWeights(load);
 
         // Prefetch services (just a simulation, no need to output anything)
+        traceBegin("prefetch");
         for (auto& rsu : rsus) {
             double remainingCapacity = rsu.maxCapacity - rsu.usedCapacity;
             for (auto& service : services) {
@@ -115,8 +119,10 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
                 }
             }
         }
+        traceEnd();
 
         // Record start time of request scheduling
+        traceBegin("schedule");
         auto startScheduling = std::chrono::high_resolution_clock::now();
 
         // Schedule requests (without any output)
@@ -143,12 +149,14 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
                 rsus[bestRSU].usedCapacity += request.computationLoad;
             }
         }
+        traceEnd();
 
         // Measure scheduling latency
         auto endScheduling = std::chrono::high_resolution_clock::now();
         double schedulingLatency = std::chrono::duration<double, std::micro>(endScheduling - startScheduling).count(); // in microseconds
 
         // Transfer requests (without any output)
+        traceBegin("transfer");
         for (auto& request : requests) {
             double minTransferCost = std::numeric_limits<double>::max();
             int bestRSU = -1;
@@ -169,8 +177,10 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
                 rsus[bestRSU].usedCapacity += request.demand;
             }
         }
+        traceEnd();
 
         // Compute total cost and total latency (including request scheduling latency)
+        traceBegin("cost");
         double totalCost = 0.0;
         double totalLatency = 0.0;
 
@@ -192,6 +202,7 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
                 totalCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
             }
         }
+        traceEnd();
 
         // Add the scheduling latency to the total latency
         totalLatency += schedulingLatency;
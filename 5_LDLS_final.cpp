@@ -9,6 +9,9 @@ LDLS
 #include <limits>
 #include <algorithm>
 #include <chrono> // For time measurement
+#include "avsdsf_trace.h"
+#include "avsdsf_memory.h"
+#include "avsdsf_pool.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -52,7 +55,8 @@ private:
     vector<EdgeNode> nodes;
     vector<Image> images;
     unordered_map<int, Layer> layers;
-    vector<Task> tasks;
+    IndexPool<Task> taskPool; // Storage of all tasks; freed slots are reused
+    PoolList tasks; // Tasks to schedule, linked through the pool
     
     // Random number generator
     random_device rd;
@@ -79,7 +83,11 @@ private:
 
 public:
     LDLS(vector<EdgeNode> n, vector<Image> i, vector<Layer> l, vector<Task> t)
-        : nodes(n), images(i), tasks(t), gen(rd()) {
+        : nodes(std::move(n)), images(std::move(i)), gen(rd()) {
+        taskPool.reserve(t.size());
+        for (auto& task : t) {
+            taskPool.append(tasks, std::move(task));
+        }
         for (const auto& layer : l) {
             layers[layer.id] = layer;
         }
@@ -100,6 +108,7 @@ public:
 
     // RL-based Scheduling Decision
     int scheduleTask(const Task& task) {
+        TracePhase phase("schedule");
         int bestNode = -1;
         double bestScore = -numeric_limits<double>::infinity();
         
@@ -161,11 +170,12 @@ public:
 
     // Calculate Total Cost for each time slot
     double calculateTotalCost(int timeSlot) {
+        TracePhase phase("cost");
         double totalCost = 0.0;
         std::srand(std::time(0));
         double rn = generateRandomDecimal(0.1, 1.5);
         // Update task properties and schedule tasks for each time slot
-        for (auto& task : tasks) {
+        for (auto& task : taskPool.items(tasks)) {
             double taskComputationCost = 0.0;
             double taskRetentionCost = 0.0;
             double taskTransferCost = 0.0;
@@ -199,8 +209,10 @@ public:
 
     // Reinforcement Learning Optimization
     void optimizePolicy() {
+        TracePhase phase("policy training");
+        MemoryTag memory("ldls.policy");
         for (int i = 0; i < maxIterations; ++i) {
-            for (auto& task : tasks) {
+            for (auto& task : taskPool.items(tasks)) {
                 int selectedNode = scheduleTask(task);
                 if (selectedNode != -1) {
                     policy[selectedNode] += learningRate * (1.0 / (i + 1));
@@ -214,23 +226,28 @@ public:
         optimizePolicy();
         
         for (int timeSlot = 0; timeSlot < 5; ++timeSlot) { // Loop through 5 time slots
+            TracePhase slot("slot");
             auto start = high_resolution_clock::now();
 
             double totalCost = calculateTotalCost(timeSlot);
             cout << "Time Slot " << timeSlot << ": Total Cost = " << totalCost << endl;
 
             // Measure the total latency
+            traceBegin("transfer");
             double totalLatency = 0.0;
-            for (auto& task : tasks) {
+            for (auto& task : taskPool.items(tasks)) {
                 for (auto& node : nodes) {
                     double latency = calculateLatency(task, node);
                     totalLatency += latency;
                 }
             }
 
+            traceEnd();
+
             auto end = high_resolution_clock::now();
             auto duration = duration_cast<microseconds>(end - start);
             cout << "Time Slot " << timeSlot << " Total Latency = " << totalLatency << " seconds" << endl;
+            memoryCheckpoint();
             // cout << "Execution time: " << duration.count() << " microseconds." << endl;
         }
     }
@@ -250,8 +267,9 @@ int main() {
     vector<Task> tasks = {{0, 0, 0.8, 1000, 50.0}, {1, 1, 1.0, 1500, 100.0}};
     
     // Run LDLS Scheduler
-    LDLS scheduler(nodes, images, layers, tasks);
+    LDLS scheduler(std::move(nodes), std::move(images), std::move(layers), std::move(tasks));
     scheduler.executeScheduling();
+    printMemoryReport(cout);
     
     return 0;
 }
@@ -9,6 +9,8 @@ DRAJO
 #include <limits>
 #include <random>
 #include <chrono>
+#include "avsdsf_trace.h"
+#include "avsdsf_memory.h"
 
 // Constants and parameters
 const double GAMMA = 1.0; // Sensitivity for dynamic weight adjustment
@@ -77,6 +79,8 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
     std::uniform_real_distribution<> dis(0.1, 0.3);  // Vary parameters like load and costs slightly to simulate realtime scenarios.
 
     for (int t = 0; t < T; ++t) {
+        TracePhase slot("slot");
+
         // Simulate varying request loads and RSU parameters over time
         for (auto& request : requests) {
             double y = dis(gen);
@@ -103,18 +107,22 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
         weights = computeDynamicWeights(load);
 
         // Prefetch services (just a simulation, no need to output anything)
+        traceBegin("prefetch");
         for (auto& rsu : rsus) {
             double remainingCapacity = rsu.maxCapacity - rsu.usedCapacity;
             for (auto& service : services) {
                 if (service.size <= remainingCapacity) {
+                    MemoryTag memory("avsdsf.decisions"); // Charge the map insertion to the decisions
                     decisions.P[service.id] = 1; // Prefetch service
                     remainingCapacity -= service.size;
                     rsu.usedCapacity += service.size;
                 }
             }
         }
+        traceEnd();
 
         // Schedule requests (without any output)
+        traceBegin("schedule");
         for (auto& request : requests) {
             double minCost = std::numeric_limits<double>::max();
             int bestRSU = -1;
@@ -134,12 +142,15 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
             }
 
             if (bestRSU != -1) {
+                MemoryTag memory("avsdsf.decisions");
                 decisions.X[request.id] = bestRSU;
                 rsus[bestRSU].usedCapacity += request.computationLoad;
             }
         }
+        traceEnd();
 
         // Transfer requests (without any output)
+        traceBegin("transfer");
         for (auto& request : requests) {
             double minTransferCost = std::numeric_limits<double>::max();
             int bestRSU = -1;
@@ -156,12 +167,15 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
             }
 
             if (bestRSU != -1) {
+                MemoryTag memory("avsdsf.decisions");
                 decisions.T[request.id] = bestRSU;
                 rsus[bestRSU].usedCapacity += request.demand;
             }
         }
+        traceEnd();
 
         // Compute total cost and total latency
+        traceBegin("cost");
         double totalCost = 0.0;
         double totalLatency = 0.0;
 
@@ -183,10 +197,12 @@ void main_algorithm(int T, std::vector<ServiceRequest>& requests, std::vector<RS
                 totalCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
             }
         }
+        traceEnd();
 
         // Output total cost and total latency
         std::cout << "Time Slot " << t << ": Total Cost = " << totalCost << std::endl;
         std::cout << "Time Slot " << t << ": Total Latency = " << totalLatency << " microseconds" << std::endl;
+        memoryCheckpoint();
     }
 }
 
@@ -212,6 +228,7 @@ int main() {
     int T = 5; // Number of time slots
 
     main_algorithm(T, requests, rsus, services);
+    printMemoryReport(std::cout);
 
     return 0;
 }
@@ -0,0 +1,424 @@
+/*
+AVSDSF - Content-addressed chunk store for service images
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include "avsdsf_model.h"
+
+// Content-defined chunking parameters (bytes)
+const size_t CHUNK_MIN_SIZE = 2 * 1024;
+const size_t CHUNK_AVG_MASK = 8 * 1024 - 1; // Cut point when (gear hash & mask) == 0, ~8 KiB average
+const size_t CHUNK_MAX_SIZE = 32 * 1024;
+const uint64_t MIB = 1024 * 1024;
+
+// Reference to one chunk inside an image manifest
+struct ChunkRef {
+    uint64_t hash;
+    uint32_t size;
+};
+
+// Image layer (same role as LDLS's Layer, but carrying its content)
+struct ImageLayer {
+    std::string name;
+    std::vector<uint8_t> data;
+    std::vector<ChunkRef> chunks;
+};
+
+// Service image described as a manifest of hashed chunks
+struct ImageManifest {
+    int serviceId;
+    std::string name;
+    std::vector<int> layers; // Indices into the layer catalog
+    std::vector<ChunkRef> chunks;
+    uint64_t totalBytes;
+};
+
+// Gear table for the rolling hash used by content-defined chunking
+static const std::vector<uint64_t>& gearTable() {
+    static std::vector<uint64_t> table = [] {
+        std::vector<uint64_t> t(256);
+        std::mt19937_64 gen(0x9E3779B97F4A7C15ULL);
+        for (auto& v : t) {
+            v = gen();
+        }
+        return t;
+    }();
+    return table;
+}
+
+// 64-bit content hash of a chunk (8 bytes per step, murmur-style finalizer)
+uint64_t hashChunk(const uint8_t* data, size_t length) {
+    uint64_t h = 0xCBF29CE484222325ULL ^ (length * 0x100000001B3ULL);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word = 0;
+        for (int b = 0; b < 8; ++b) {
+            word |= uint64_t(data[i + b]) << (8 * b);
+        }
+        h ^= word * 0x87C37B91114253D5ULL;
+        h = (h << 31) | (h >> 33);
+        h *= 0x4CF5AD432745937FULL;
+    }
+    for (; i < length; ++i) {
+        h ^= data[i];
+        h *= 0x100000001B3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Split a byte stream into content-defined chunks so that shared content
+// produces identical chunks even when it sits at different offsets.
+std::vector<ChunkRef> chunkContent(const std::vector<uint8_t>& data) {
+    const auto& gear = gearTable();
+    std::vector<ChunkRef> chunks;
+    size_t start = 0;
+    uint64_t rolling = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        rolling = (rolling << 1) + gear[data[i]];
+        size_t length = i - start + 1;
+        if ((length >= CHUNK_MIN_SIZE && (rolling & CHUNK_AVG_MASK) == 0) || length >= CHUNK_MAX_SIZE) {
+            chunks.push_back({hashChunk(&data[start], length), static_cast<uint32_t>(length)});
+            start = i + 1;
+            rolling = 0;
+        }
+    }
+    if (start < data.size()) {
+        chunks.push_back({hashChunk(&data[start], data.size() - start), static_cast<uint32_t>(data.size() - start)});
+    }
+    return chunks;
+}
+
+// Per-RSU content-addressed store: every distinct chunk is kept once and
+// reference counted by the images that use it.
+class ChunkStore {
+private:
+    struct ChunkEntry {
+        uint32_t size;
+        uint32_t refCount;
+    };
+
+    std::unordered_map<uint64_t, ChunkEntry> chunks;
+    std::unordered_map<int, const ImageManifest*> images;
+    uint64_t capacityBytes;
+    uint64_t physicalBytes = 0; // Bytes actually stored
+    uint64_t logicalBytes = 0;  // Sum of the full sizes of the stored images
+
+public:
+    explicit ChunkStore(uint64_t capacity) : capacityBytes(capacity) {}
+
+    bool hasImage(int serviceId) const {
+        return images.count(serviceId) != 0;
+    }
+
+    // Bytes that would have to be transferred to make the image available
+    uint64_t missingBytes(const ImageManifest& image) const {
+        uint64_t missing = 0;
+        std::unordered_map<uint64_t, bool> counted;
+        for (const auto& chunk : image.chunks) {
+            if (chunks.count(chunk.hash) == 0 && !counted[chunk.hash]) {
+                counted[chunk.hash] = true;
+                missing += chunk.size;
+            }
+        }
+        return missing;
+    }
+
+    // Prefetch an image, transferring only missing chunks. Returns false if
+    // the missing chunks do not fit in the remaining capacity.
+    bool prefetch(const ImageManifest& image, uint64_t& transferredBytes) {
+        transferredBytes = 0;
+        if (hasImage(image.serviceId)) {
+            return true;
+        }
+        uint64_t missing = missingBytes(image);
+        if (physicalBytes + missing > capacityBytes) {
+            return false;
+        }
+        for (const auto& chunk : image.chunks) {
+            auto it = chunks.find(chunk.hash);
+            if (it == chunks.end()) {
+                chunks[chunk.hash] = {chunk.size, 1};
+                physicalBytes += chunk.size;
+                transferredBytes += chunk.size;
+            } else {
+                it->second.refCount++;
+            }
+        }
+        images[image.serviceId] = &image;
+        logicalBytes += image.totalBytes;
+        return true;
+    }
+
+    // Drop an image; chunks are freed once no stored image references them
+    void release(int serviceId) {
+        auto it = images.find(serviceId);
+        if (it == images.end()) {
+            return;
+        }
+        for (const auto& chunk : it->second->chunks) {
+            auto entry = chunks.find(chunk.hash);
+            if (--entry->second.refCount == 0) {
+                physicalBytes -= entry->second.size;
+                chunks.erase(entry);
+            }
+        }
+        logicalBytes -= it->second->totalBytes;
+        images.erase(it);
+    }
+
+    uint64_t getPhysicalBytes() const { return physicalBytes; }
+    uint64_t getLogicalBytes() const { return logicalBytes; }
+    uint64_t getCapacityBytes() const { return capacityBytes; }
+    size_t getImageCount() const { return images.size(); }
+    size_t getChunkCount() const { return chunks.size(); }
+};
+
+// Same store with opaque images (the current PrefetchedService model)
+class OpaqueStore {
+private:
+    std::unordered_map<int, uint64_t> images;
+    uint64_t capacityBytes;
+    uint64_t usedBytes = 0;
+
+public:
+    explicit OpaqueStore(uint64_t capacity) : capacityBytes(capacity) {}
+
+    bool hasImage(int serviceId) const {
+        return images.count(serviceId) != 0;
+    }
+
+    bool prefetch(const ImageManifest& image, uint64_t& transferredBytes) {
+        transferredBytes = 0;
+        if (hasImage(image.serviceId)) {
+            return true;
+        }
+        if (usedBytes + image.totalBytes > capacityBytes) {
+            return false;
+        }
+        images[image.serviceId] = image.totalBytes;
+        usedBytes += image.totalBytes;
+        transferredBytes = image.totalBytes;
+        return true;
+    }
+
+    void release(int serviceId) {
+        auto it = images.find(serviceId);
+        if (it != images.end()) {
+            usedBytes -= it->second;
+            images.erase(it);
+        }
+    }
+
+    uint64_t getUsedBytes() const { return usedBytes; }
+    size_t getImageCount() const { return images.size(); }
+};
+
+// Deterministic pseudo-random layer content
+std::vector<uint8_t> makeLayerContent(uint64_t seed, size_t bytes) {
+    std::vector<uint8_t> data(bytes);
+    std::mt19937_64 gen(seed);
+    for (size_t i = 0; i < bytes; i += 8) {
+        uint64_t word = gen();
+        for (size_t b = 0; b < 8 && i + b < bytes; ++b) {
+            data[i + b] = static_cast<uint8_t>(word >> (8 * b));
+        }
+    }
+    return data;
+}
+
+// Application layer that embeds a shared library blob at an arbitrary
+// offset, so that sharing is only visible at chunk granularity.
+std::vector<uint8_t> makeAppLayer(uint64_t seed, size_t bytes, const std::vector<uint8_t>& sharedLib, size_t offset) {
+    std::vector<uint8_t> data = makeLayerContent(seed, bytes);
+    std::copy(sharedLib.begin(), sharedLib.end(), data.begin() + std::min(offset, bytes - sharedLib.size()));
+    return data;
+}
+
+// Build a catalog of AV service images where services share base layers
+void buildCatalog(std::vector<ImageLayer>& layers, std::vector<ImageManifest>& catalog) {
+    layers.clear();
+    layers.push_back({"os-base", makeLayerContent(1, 12 * MIB), {}});
+    layers.push_back({"ros-runtime", makeLayerContent(2, 8 * MIB), {}});
+    layers.push_back({"cuda-runtime", makeLayerContent(3, 16 * MIB), {}});
+
+    std::vector<uint8_t> sharedLib = makeLayerContent(4, 3 * MIB / 2); // Common perception/math library
+
+    struct ServiceSpec {
+        std::string name;
+        bool usesCuda;
+        size_t appBytes;
+    };
+    std::vector<ServiceSpec> specs = {
+        {"perception", true, 6 * MIB},
+        {"localization", false, 4 * MIB},
+        {"path-planning", false, 3 * MIB},
+        {"object-tracking", true, 5 * MIB},
+        {"hd-map-update", false, 2 * MIB},
+        {"v2x-messaging", false, 2 * MIB},
+        {"sensor-fusion", true, 4 * MIB},
+        {"infotainment", false, 5 * MIB}
+    };
+
+    catalog.clear();
+    for (size_t s = 0; s < specs.size(); ++s) {
+        layers.push_back({specs[s].name + "-app", makeAppLayer(100 + s, specs[s].appBytes, sharedLib, (s * 977 * 1024) % MIB), {}});
+
+        ImageManifest image{static_cast<int>(s), specs[s].name, {0, 1}, {}, 0};
+        if (specs[s].usesCuda) {
+            image.layers.push_back(2);
+        }
+        image.layers.push_back(static_cast<int>(layers.size() - 1));
+        catalog.push_back(image);
+    }
+
+    for (auto& layer : layers) {
+        layer.chunks = chunkContent(layer.data);
+    }
+    for (auto& image : catalog) {
+        for (int layerId : image.layers) {
+            const auto& layer = layers[layerId];
+            image.chunks.insert(image.chunks.end(), layer.chunks.begin(), layer.chunks.end());
+            image.totalBytes += layer.data.size();
+        }
+    }
+}
+
+double toMiB(uint64_t bytes) {
+    return static_cast<double>(bytes) / MIB;
+}
+
+// BS-PAD prefetch over time slots with chunk-level and opaque image stores
+void main_algorithm(int T, std::vector<RSU>& rsus, const std::vector<ImageManifest>& catalog) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<> dis(0.1, 1.0); // Per-slot service popularity
+
+    std::vector<ChunkStore> chunkStores;
+    std::vector<OpaqueStore> opaqueStores;
+    for (const auto& rsu : rsus) {
+        chunkStores.emplace_back(static_cast<uint64_t>(rsu.maxCapacity * MIB));
+        opaqueStores.emplace_back(static_cast<uint64_t>(rsu.maxCapacity * MIB));
+    }
+
+    uint64_t totalChunkTransfer = 0;
+    uint64_t totalOpaqueTransfer = 0;
+
+    for (int t = 0; t < T; ++t) {
+        // Popularity of each service in this slot drives the prefetch order
+        std::vector<std::pair<double, int>> ranking;
+        for (const auto& image : catalog) {
+            ranking.push_back({dis(gen), image.serviceId});
+        }
+        std::sort(ranking.rbegin(), ranking.rend());
+
+        uint64_t slotChunkTransfer = 0;
+        uint64_t slotOpaqueTransfer = 0;
+        int chunkPrefetched = 0;
+        int opaquePrefetched = 0;
+
+        for (size_t r = 0; r < rsus.size(); ++r) {
+            // Evict the least popular images held from the previous slot
+            for (size_t k = ranking.size() / 2; k < ranking.size(); ++k) {
+                chunkStores[r].release(ranking[k].second);
+                opaqueStores[r].release(ranking[k].second);
+            }
+
+            // Prefetch services in popularity order while they fit
+            for (const auto& [popularity, serviceId] : ranking) {
+                const auto& image = catalog[serviceId];
+                uint64_t transferred = 0;
+                bool wasHeld = chunkStores[r].hasImage(serviceId);
+                if (chunkStores[r].prefetch(image, transferred) && !wasHeld) {
+                    slotChunkTransfer += transferred;
+                    chunkPrefetched++;
+                }
+                wasHeld = opaqueStores[r].hasImage(serviceId);
+                if (opaqueStores[r].prefetch(image, transferred) && !wasHeld) {
+                    slotOpaqueTransfer += transferred;
+                    opaquePrefetched++;
+                }
+            }
+            rsus[r].usedCapacity = toMiB(chunkStores[r].getPhysicalBytes());
+        }
+
+        totalChunkTransfer += slotChunkTransfer;
+        totalOpaqueTransfer += slotOpaqueTransfer;
+
+        std::cout << "Time Slot " << t << ": Prefetched Images = " << chunkPrefetched
+                  << " (opaque: " << opaquePrefetched << ")"
+                  << ", Transfer = " << toMiB(slotChunkTransfer) << " MiB"
+                  << " (opaque: " << toMiB(slotOpaqueTransfer) << " MiB)" << std::endl;
+    }
+
+    std::cout << "\n--- RSU storage after " << T << " slots ---" << std::endl;
+    for (size_t r = 0; r < rsus.size(); ++r) {
+        const auto& store = chunkStores[r];
+        double savings = store.getLogicalBytes() == 0 ? 0.0 :
+            100.0 * (1.0 - static_cast<double>(store.getPhysicalBytes()) / store.getLogicalBytes());
+        std::cout << "RSU " << rsus[r].id << ": Images = " << store.getImageCount()
+                  << " (opaque: " << opaqueStores[r].getImageCount() << ")"
+                  << ", Logical = " << toMiB(store.getLogicalBytes()) << " MiB"
+                  << ", Physical = " << toMiB(store.getPhysicalBytes()) << " MiB"
+                  << ", Chunks = " << store.getChunkCount()
+                  << ", Storage Savings = " << savings << "%" << std::endl;
+    }
+
+    double transferSaved = totalOpaqueTransfer == 0 ? 0.0 :
+        100.0 * (1.0 - static_cast<double>(totalChunkTransfer) / totalOpaqueTransfer);
+    std::cout << "Total Transfer = " << toMiB(totalChunkTransfer) << " MiB (opaque: " << toMiB(totalOpaqueTransfer)
+              << " MiB), Transfer Bytes Saved = " << transferSaved << "%" << std::endl;
+}
+
+int main() {
+    std::vector<ImageLayer> layers;
+    std::vector<ImageManifest> catalog;
+    buildCatalog(layers, catalog);
+
+    // Catalog summary: sharing visible at layer level vs chunk level
+    uint64_t logical = 0;
+    std::unordered_map<int, bool> distinctLayers;
+    std::unordered_map<uint64_t, uint32_t> distinctChunks;
+    for (const auto& image : catalog) {
+        logical += image.totalBytes;
+        for (int layerId : image.layers) {
+            distinctLayers[layerId] = true;
+        }
+        for (const auto& chunk : image.chunks) {
+            distinctChunks[chunk.hash] = chunk.size;
+        }
+    }
+    uint64_t layerDedup = 0;
+    for (const auto& [layerId, used] : distinctLayers) {
+        layerDedup += layers[layerId].data.size();
+    }
+    uint64_t chunkDedup = 0;
+    for (const auto& [hash, size] : distinctChunks) {
+        chunkDedup += size;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Catalog: " << catalog.size() << " images, " << toMiB(logical) << " MiB logical, "
+              << toMiB(layerDedup) << " MiB after layer dedup, "
+              << toMiB(chunkDedup) << " MiB after chunk dedup (" << distinctChunks.size() << " chunks)\n" << std::endl;
+
+    // RSU capacity is interpreted in MiB of image storage
+    std::vector<RSU> rsus = {
+        {0, 70.0, 0.0, 0.02, 0.03, 0.01},
+        {1, 80.0, 0.0, 0.04, 0.02, 0.025},
+        {2, 90.0, 0.0, 0.025, 0.05, 0.02}
+    };
+
+    int T = 5; // Number of time slots
+
+    main_algorithm(T, rsus, catalog);
+
+    return 0;
+}
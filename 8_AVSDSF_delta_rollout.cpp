@@ -0,0 +1,398 @@
+/*
+AVSDSF - Delta transfer for service image version updates
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include "avsdsf_model.h"
+
+// Delta parameters
+const size_t DELTA_BLOCK_SIZE = 4 * 1024; // Block size of the old-version signature
+const size_t DELTA_OP_HEADER_BYTES = 9;   // Encoded size of one COPY/LITERAL header
+const uint64_t MIB = 1024 * 1024;
+
+// One version of a service image
+struct ImageVersion {
+    int serviceId;
+    int version;
+    std::vector<uint8_t> data;
+};
+
+// Signature of one block of the old version
+struct BlockSignature {
+    uint32_t weak;
+    uint64_t strong;
+    uint32_t index;
+};
+
+// Delta instruction: copy a block of the old version or insert literal bytes
+struct DeltaOp {
+    bool isCopy;
+    uint32_t blockIndex;
+    std::vector<uint8_t> literal;
+};
+
+struct ImageDelta {
+    int serviceId;
+    int fromVersion;
+    int toVersion;
+    size_t targetSize;
+    uint64_t targetHash;
+    std::vector<DeltaOp> ops;
+    size_t encodedBytes;
+};
+
+// Strong block hash (FNV-1a, 64 bit)
+uint64_t strongHash(const uint8_t* data, size_t length) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        h ^= data[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// rsync weak rolling checksum over a window
+struct RollingChecksum {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    size_t length = 0;
+
+    void reset(const uint8_t* data, size_t len) {
+        a = 0;
+        b = 0;
+        length = len;
+        for (size_t i = 0; i < len; ++i) {
+            a += data[i];
+            b += static_cast<uint32_t>(len - i) * data[i];
+        }
+    }
+
+    // Slide the window by one byte
+    void roll(uint8_t out, uint8_t in) {
+        a = a - out + in;
+        b = b - static_cast<uint32_t>(length) * out + a;
+    }
+
+    uint32_t value() const {
+        return (a & 0xFFFF) | (b << 16);
+    }
+};
+
+// Block signatures of the version an RSU already holds
+std::vector<BlockSignature> computeSignature(const std::vector<uint8_t>& oldData) {
+    std::vector<BlockSignature> signature;
+    RollingChecksum checksum;
+    for (size_t offset = 0; offset + DELTA_BLOCK_SIZE <= oldData.size(); offset += DELTA_BLOCK_SIZE) {
+        checksum.reset(&oldData[offset], DELTA_BLOCK_SIZE);
+        signature.push_back({checksum.value(), strongHash(&oldData[offset], DELTA_BLOCK_SIZE),
+                             static_cast<uint32_t>(offset / DELTA_BLOCK_SIZE)});
+    }
+    return signature;
+}
+
+// Generate a delta that rebuilds newVersion from the blocks of oldVersion
+ImageDelta generateDelta(const ImageVersion& oldVersion, const ImageVersion& newVersion) {
+    ImageDelta delta{newVersion.serviceId, oldVersion.version, newVersion.version, newVersion.data.size(),
+                     strongHash(newVersion.data.data(), newVersion.data.size()), {}, 0};
+
+    std::unordered_map<uint32_t, std::vector<BlockSignature>> lookup;
+    for (const auto& block : computeSignature(oldVersion.data)) {
+        lookup[block.weak].push_back(block);
+    }
+
+    const auto& data = newVersion.data;
+    std::vector<uint8_t> pending;
+    auto flushLiteral = [&]() {
+        if (!pending.empty()) {
+            delta.encodedBytes += DELTA_OP_HEADER_BYTES + pending.size();
+            delta.ops.push_back({false, 0, std::move(pending)});
+            pending.clear();
+        }
+    };
+
+    size_t pos = 0;
+    RollingChecksum checksum;
+    bool windowValid = false;
+    while (pos + DELTA_BLOCK_SIZE <= data.size()) {
+        if (!windowValid) {
+            checksum.reset(&data[pos], DELTA_BLOCK_SIZE);
+            windowValid = true;
+        }
+        int matched = -1;
+        auto it = lookup.find(checksum.value());
+        if (it != lookup.end()) {
+            uint64_t strong = strongHash(&data[pos], DELTA_BLOCK_SIZE);
+            for (const auto& block : it->second) {
+                if (block.strong == strong) {
+                    matched = static_cast<int>(block.index);
+                    break;
+                }
+            }
+        }
+        if (matched >= 0) {
+            flushLiteral();
+            delta.encodedBytes += DELTA_OP_HEADER_BYTES;
+            delta.ops.push_back({true, static_cast<uint32_t>(matched), {}});
+            pos += DELTA_BLOCK_SIZE;
+            windowValid = false;
+        } else {
+            pending.push_back(data[pos]);
+            if (pos + DELTA_BLOCK_SIZE < data.size()) {
+                checksum.roll(data[pos], data[pos + DELTA_BLOCK_SIZE]);
+            }
+            pos++;
+        }
+    }
+    pending.insert(pending.end(), data.begin() + pos, data.end());
+    flushLiteral();
+    return delta;
+}
+
+// Apply a delta on the RSU side. Returns false if the result does not match.
+bool applyDelta(const ImageVersion& oldVersion, const ImageDelta& delta, ImageVersion& result) {
+    result.serviceId = delta.serviceId;
+    result.version = delta.toVersion;
+    result.data.clear();
+    result.data.reserve(delta.targetSize);
+    for (const auto& op : delta.ops) {
+        if (op.isCopy) {
+            size_t offset = static_cast<size_t>(op.blockIndex) * DELTA_BLOCK_SIZE;
+            if (offset + DELTA_BLOCK_SIZE > oldVersion.data.size()) {
+                return false;
+            }
+            result.data.insert(result.data.end(), oldVersion.data.begin() + offset,
+                               oldVersion.data.begin() + offset + DELTA_BLOCK_SIZE);
+        } else {
+            result.data.insert(result.data.end(), op.literal.begin(), op.literal.end());
+        }
+    }
+    return result.data.size() == delta.targetSize &&
+           strongHash(result.data.data(), result.data.size()) == delta.targetHash;
+}
+
+// Produce the next version of an image: patched regions, insertions and deletions
+ImageVersion makeNextVersion(const ImageVersion& base, std::mt19937_64& gen) {
+    ImageVersion next{base.serviceId, base.version + 1, base.data};
+    std::uniform_int_distribution<size_t> editCount(4, 12);
+    std::uniform_int_distribution<size_t> editSize(256, 64 * 1024);
+    std::uniform_int_distribution<int> editKind(0, 2);
+    size_t edits = editCount(gen);
+    for (size_t e = 0; e < edits; ++e) {
+        size_t size = editSize(gen);
+        size_t offset = std::uniform_int_distribution<size_t>(0, next.data.size() - size - 1)(gen);
+        int kind = editKind(gen);
+        if (kind == 0) { // Patch in place
+            for (size_t i = 0; i < size; ++i) {
+                next.data[offset + i] = static_cast<uint8_t>(gen());
+            }
+        } else if (kind == 1) { // Insert new bytes
+            std::vector<uint8_t> inserted(size);
+            for (auto& byte : inserted) {
+                byte = static_cast<uint8_t>(gen());
+            }
+            next.data.insert(next.data.begin() + offset, inserted.begin(), inserted.end());
+        } else { // Delete bytes
+            next.data.erase(next.data.begin() + offset, next.data.begin() + offset + size);
+        }
+    }
+    return next;
+}
+
+double toMiB(uint64_t bytes) {
+    return static_cast<double>(bytes) / MIB;
+}
+
+// RSU-side image holdings: service id -> version currently stored
+struct RSUImageState {
+    int rsuId;
+    double linkMbps; // BS -> RSU link rate
+    std::map<int, int> versions;
+};
+
+// Transfer pushed by the rollout planner
+struct RolloutTransfer {
+    int rsuId;
+    int serviceId;
+    int fromVersion; // -1 for a full image
+    uint64_t bytes;
+    double seconds;
+};
+
+// Version rollout planner: RSUs that hold an old version receive a delta from
+// that version; the base station pushes at most `streams` transfers at once
+// over a shared backhaul. Returns the rollout makespan in seconds.
+double planRollout(std::vector<RSUImageState>& fleet, const std::vector<ImageVersion>& history,
+                   const ImageVersion& target, bool useDelta, double backhaulMbps, int streams,
+                   uint64_t& totalBytes, std::map<int, ImageDelta>& deltaCache, int& failedApplies) {
+    std::vector<RolloutTransfer> transfers;
+    for (auto& rsu : fleet) {
+        auto it = rsu.versions.find(target.serviceId);
+        if (it == rsu.versions.end() || it->second == target.version) {
+            continue; // Only RSUs holding an old version are updated
+        }
+        int fromVersion = it->second;
+        uint64_t bytes = target.data.size();
+        if (useDelta) {
+            // One delta per source version, verified by applying it once
+            auto cached = deltaCache.find(fromVersion);
+            if (cached == deltaCache.end()) {
+                ImageDelta delta = generateDelta(history[fromVersion], target);
+                ImageVersion rebuilt;
+                if (!applyDelta(history[fromVersion], delta, rebuilt)) {
+                    failedApplies++;
+                    delta.encodedBytes = target.data.size(); // Fall back to the full image
+                }
+                cached = deltaCache.emplace(fromVersion, std::move(delta)).first;
+            }
+            bytes = cached->second.encodedBytes;
+        } else {
+            fromVersion = -1;
+        }
+        double rateMbps = std::min(rsu.linkMbps, backhaulMbps / streams);
+        transfers.push_back({rsu.rsuId, target.serviceId, fromVersion, bytes, bytes * 8.0 / (rateMbps * 1e6)});
+        it->second = target.version;
+    }
+
+    // Shortest transfer first over the available streams
+    std::sort(transfers.begin(), transfers.end(), [](const RolloutTransfer& a, const RolloutTransfer& b) {
+        return a.seconds < b.seconds;
+    });
+    std::vector<double> streamBusyUntil(streams, 0.0);
+    double makespan = 0.0;
+    totalBytes = 0;
+    for (const auto& transfer : transfers) {
+        auto stream = std::min_element(streamBusyUntil.begin(), streamBusyUntil.end());
+        *stream += transfer.seconds;
+        makespan = std::max(makespan, *stream);
+        totalBytes += transfer.bytes;
+    }
+    return makespan;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+
+    // Service images and their version history (version index == position)
+    std::vector<std::pair<std::string, size_t>> specs = {
+        {"perception", 24 * MIB}, {"localization", 12 * MIB}, {"path-planning", 8 * MIB}, {"v2x-messaging", 6 * MIB}
+    };
+    std::vector<PrefetchedService> services;
+    std::vector<std::vector<ImageVersion>> history(specs.size());
+    for (size_t s = 0; s < specs.size(); ++s) {
+        ImageVersion v0{static_cast<int>(s), 0, std::vector<uint8_t>(specs[s].second)};
+        for (auto& byte : v0.data) {
+            byte = static_cast<uint8_t>(gen());
+        }
+        history[s].push_back(v0);
+        services.push_back({static_cast<int>(s), toMiB(specs[s].second), 2.0});
+    }
+
+    // Fleet: each RSU holds some version of some services
+    int numRSUs = 40;
+    std::vector<RSUImageState> deltaFleet;
+    std::uniform_real_distribution<> linkRate(100.0, 1000.0);
+    std::uniform_real_distribution<> holdProbability(0.0, 1.0);
+    for (int r = 0; r < numRSUs; ++r) {
+        RSUImageState rsu{r, linkRate(gen), {}};
+        for (size_t s = 0; s < specs.size(); ++s) {
+            if (holdProbability(gen) < 0.75) {
+                rsu.versions[static_cast<int>(s)] = 0;
+            }
+        }
+        deltaFleet.push_back(rsu);
+    }
+    std::vector<RSUImageState> fullFleet = deltaFleet;
+
+    double backhaulMbps = 2000.0;
+    int streams = 8;
+    int T = 5; // Number of update rounds (one new version of every service per round)
+    uint64_t totalDeltaBytes = 0;
+    uint64_t totalFullBytes = 0;
+    double totalDeltaTime = 0.0;
+    double totalFullTime = 0.0;
+    double deltaCost = 0.0, fullCost = 0.0;
+    std::uniform_int_distribution<int> lagging(0, 3);
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (int t = 0; t < T; ++t) {
+        uint64_t slotDeltaBytes = 0;
+        uint64_t slotFullBytes = 0;
+        double slotDeltaTime = 0.0;
+        double slotFullTime = 0.0;
+        double deltaGenMs = 0.0;
+        int failedApplies = 0;
+
+        for (size_t s = 0; s < specs.size(); ++s) {
+            history[s].push_back(makeNextVersion(history[s].back(), gen));
+            const ImageVersion& target = history[s].back();
+
+            // A few RSUs miss this round and stay a version behind
+            std::vector<int> skipped;
+            int laggingCount = lagging(gen);
+            for (int k = 0; k < laggingCount; ++k) {
+                skipped.push_back(static_cast<int>(gen() % numRSUs));
+            }
+            std::vector<RSUImageState> deltaRound, fullRound;
+            for (int r = 0; r < numRSUs; ++r) {
+                bool skip = std::find(skipped.begin(), skipped.end(), r) != skipped.end();
+                deltaRound.push_back(deltaFleet[r]);
+                fullRound.push_back(fullFleet[r]);
+                if (skip) {
+                    deltaRound.back().versions.erase(static_cast<int>(s));
+                    fullRound.back().versions.erase(static_cast<int>(s));
+                }
+            }
+
+            std::map<int, ImageDelta> deltaCache;
+            uint64_t deltaBytes = 0, fullBytes = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            slotDeltaTime += planRollout(deltaRound, history[s], target, true, backhaulMbps, streams, deltaBytes, deltaCache, failedApplies);
+            auto end = std::chrono::high_resolution_clock::now();
+            deltaGenMs += std::chrono::duration<double, std::milli>(end - start).count();
+            slotDeltaBytes += deltaBytes;
+            slotFullTime += planRollout(fullRound, history[s], target, false, backhaulMbps, streams, fullBytes, deltaCache, failedApplies);
+            slotFullBytes += fullBytes;
+
+            // Prefetch cost is charged per byte actually moved: a full rollout
+            // pays the service's prefetch cost, a delta rollout its byte share
+            double serviceCost = PREFETCH_COST_MULTIPLIER * services[s].prefetchCost;
+            fullCost += serviceCost;
+            if (fullBytes > 0) deltaCost += serviceCost * static_cast<double>(deltaBytes) / fullBytes;
+
+            // Skipped RSUs keep their old version
+            for (int r = 0; r < numRSUs; ++r) {
+                if (std::find(skipped.begin(), skipped.end(), r) == skipped.end()) {
+                    deltaFleet[r] = deltaRound[r];
+                    fullFleet[r] = fullRound[r];
+                }
+            }
+        }
+
+        totalDeltaBytes += slotDeltaBytes;
+        totalFullBytes += slotFullBytes;
+        totalDeltaTime += slotDeltaTime;
+        totalFullTime += slotFullTime;
+
+        std::cout << "Time Slot " << t << ": Update Bytes = " << toMiB(slotDeltaBytes) << " MiB (full: "
+                  << toMiB(slotFullBytes) << " MiB), Rollout Time = " << slotDeltaTime << " s (full: "
+                  << slotFullTime << " s), Delta Gen+Apply = " << deltaGenMs << " ms"
+                  << (failedApplies ? ", Failed Applies = " + std::to_string(failedApplies) : "") << std::endl;
+    }
+
+    double byteRatio = totalFullBytes == 0 ? 0.0 : static_cast<double>(totalDeltaBytes) / totalFullBytes;
+
+    std::cout << "Total Update Bytes = " << toMiB(totalDeltaBytes) << " MiB (full: " << toMiB(totalFullBytes)
+              << " MiB), Saved = " << 100.0 * (1.0 - byteRatio) << "%" << std::endl;
+    std::cout << "Total Rollout Time = " << totalDeltaTime << " s (full: " << totalFullTime << " s)" << std::endl;
+    std::cout << "Total Prefetch Cost = " << deltaCost << " (full: " << fullCost << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,403 @@
+/*
+AVSDSF - Route-corridor prefetching along predicted AV paths
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <set>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include "avsdsf_model.h"
+
+// Corridor prefetch parameters
+const double ROUTE_SAMPLE_STEP = 25.0;       // Metres between coverage samples along a route
+const double FETCH_SECONDS_PER_UNIT = 1.5;   // Image fetch time per unit of service size
+const double PREFETCH_MARGIN_SECONDS = 10.0; // Slack added to the fetch time before the ETA
+
+struct Point {
+    double x;
+    double y;
+};
+
+// One RSU on a vehicle's corridor, with the planned entry time
+struct CorridorEntry {
+    int rsuId;
+    double eta;
+};
+
+// AV with its planned route
+struct Vehicle {
+    int id;
+    int serviceId;
+    double speed;     // m/s
+    double startTime; // Time at which the vehicle is at route[0]
+    std::vector<Point> route;
+    int routeVersion;
+    std::vector<CorridorEntry> corridor;
+    size_t nextEntry; // First corridor entry not yet reached
+};
+
+// Prefetch state of one (RSU, service) pair
+struct PrefetchSlot {
+    std::set<std::pair<double, int>> pending; // (ETA, vehicle) of vehicles still heading here
+    bool issued = false;
+    bool used = false;       // At least one vehicle was served from this image
+    double readyTime = 0.0;
+    double lastUsed = 0.0;
+};
+
+// Pending prefetch, validated lazily against the vehicle's route version
+struct PrefetchJob {
+    double dueTime;
+    double eta;
+    int rsuId;
+    int vehicleId;
+    int routeVersion;
+    bool operator>(const PrefetchJob& other) const { return dueTime > other.dueTime; }
+};
+
+// Corridor statistics
+struct CorridorStats {
+    long long issued = 0;
+    long long cancelledBeforeIssue = 0;
+    long long cancelledInFlight = 0;
+    long long evictedUnused = 0;
+    long long evictedIdle = 0;
+    long long evictedDeferred = 0; // Evicted for a vehicle arriving sooner, re-queued
+    long long retriedCapacity = 0;
+    long long hits = 0;
+    long long misses = 0;
+    long long entriesTouched = 0; // Corridor entries added/removed by incremental updates
+    double prefetchCost = 0.0;
+};
+
+// Corridor prefetcher: schedules each image just in time for the vehicles
+// heading to an RSU and reacts to route changes by touching only the
+// corridor of the vehicle whose route changed. Images nobody is heading for
+// stay cached until their space is needed.
+class CorridorPrefetcher {
+private:
+    std::vector<RSU>& rsus;
+    const std::vector<PrefetchedService>& services;
+    const RSUGridIndex& index;
+    std::vector<Vehicle>& vehicles;
+    std::vector<std::unordered_map<int, PrefetchSlot>> slots; // Per RSU: service id -> slot
+    std::priority_queue<PrefetchJob, std::vector<PrefetchJob>, std::greater<PrefetchJob>> jobs;
+    CorridorStats stats;
+    double retrySeconds = 5.0;
+
+    double fetchSeconds(int serviceId) const {
+        return services[serviceId].size * FETCH_SECONDS_PER_UNIT;
+    }
+
+    // Walk the route from `startTime` and record every RSU the vehicle enters
+    std::vector<CorridorEntry> computeCorridor(const Vehicle& vehicle) const {
+        std::vector<CorridorEntry> corridor;
+        double travelled = 0.0;
+        int current = -1;
+        for (size_t i = 1; i < vehicle.route.size(); ++i) {
+            const Point& a = vehicle.route[i - 1];
+            const Point& b = vehicle.route[i];
+            double length = std::hypot(b.x - a.x, b.y - a.y);
+            for (double s = 0.0; s < length; s += ROUTE_SAMPLE_STEP) {
+                double f = s / length;
+                int rsu = index.coveringRSU(a.x + f * (b.x - a.x), a.y + f * (b.y - a.y));
+                if (rsu != -1 && rsu != current) {
+                    corridor.push_back({rsu, vehicle.startTime + (travelled + s) / vehicle.speed});
+                }
+                current = rsu;
+            }
+            travelled += length;
+        }
+        return corridor;
+    }
+
+    void addEntries(const Vehicle& vehicle, size_t from) {
+        for (size_t i = from; i < vehicle.corridor.size(); ++i) {
+            const auto& entry = vehicle.corridor[i];
+            slots[entry.rsuId][vehicle.serviceId].pending.insert({entry.eta, vehicle.id});
+            double due = entry.eta - fetchSeconds(vehicle.serviceId) - PREFETCH_MARGIN_SECONDS;
+            jobs.push({due, entry.eta, entry.rsuId, vehicle.id, vehicle.routeVersion});
+            stats.entriesTouched++;
+        }
+    }
+
+    void removeEntries(const Vehicle& vehicle, size_t from, double now) {
+        for (size_t i = from; i < vehicle.corridor.size(); ++i) {
+            releaseSlot(vehicle.corridor[i].rsuId, vehicle.serviceId, {vehicle.corridor[i].eta, vehicle.id}, now, false);
+            stats.entriesTouched++;
+        }
+    }
+
+    // Drop one vehicle's interest in a slot. A prefetch nobody needs any more
+    // is cancelled if it has not completed; a completed image stays cached.
+    // Only vehicles that left the corridor (not `consumed`) count as waste.
+    void releaseSlot(int rsuId, int serviceId, std::pair<double, int> arrival, double now, bool consumed) {
+        auto it = slots[rsuId].find(serviceId);
+        if (it == slots[rsuId].end()) return;
+        PrefetchSlot& slot = it->second;
+        if (consumed) {
+            slot.used = true;
+            slot.lastUsed = now;
+        }
+        slot.pending.erase(arrival);
+        if (!slot.pending.empty()) return;
+        if (!slot.issued) {
+            if (!consumed) stats.cancelledBeforeIssue++;
+            slots[rsuId].erase(it);
+        } else if (now < slot.readyTime) {
+            if (!consumed) stats.cancelledInFlight++;
+            rsus[rsuId].usedCapacity -= services[serviceId].size;
+            slots[rsuId].erase(it);
+        }
+    }
+
+    // Free space on an RSU for an image needed at `eta`. Cached images no
+    // vehicle is heading for go first (least recently used); otherwise the
+    // image whose next vehicle arrives last is dropped if that is late enough
+    // to fetch it again, and re-queued for that vehicle.
+    bool makeRoom(int rsuId, double size, double eta, double now) {
+        RSU& rsu = rsus[rsuId];
+        while (rsu.usedCapacity + size > rsu.maxCapacity) {
+            auto idle = slots[rsuId].end();
+            auto furthest = slots[rsuId].end();
+            for (auto it = slots[rsuId].begin(); it != slots[rsuId].end(); ++it) {
+                const PrefetchSlot& slot = it->second;
+                if (!slot.issued || now < slot.readyTime) continue;
+                if (slot.pending.empty()) {
+                    if (idle == slots[rsuId].end() || slot.lastUsed < idle->second.lastUsed) idle = it;
+                } else if (slot.pending.begin()->first > eta + fetchSeconds(it->first) + PREFETCH_MARGIN_SECONDS &&
+                           (furthest == slots[rsuId].end() || slot.pending.begin()->first > furthest->second.pending.begin()->first)) {
+                    furthest = it;
+                }
+            }
+            if (idle != slots[rsuId].end()) {
+                if (idle->second.used) stats.evictedIdle++;
+                else stats.evictedUnused++;
+                rsu.usedCapacity -= services[idle->first].size;
+                slots[rsuId].erase(idle);
+            } else if (furthest != slots[rsuId].end()) {
+                PrefetchSlot& slot = furthest->second;
+                auto [nextEta, vehicleId] = *slot.pending.begin();
+                jobs.push({nextEta - fetchSeconds(furthest->first) - PREFETCH_MARGIN_SECONDS, nextEta, rsuId,
+                           vehicleId, vehicles[vehicleId].routeVersion});
+                slot.issued = false;
+                slot.used = false;
+                rsu.usedCapacity -= services[furthest->first].size;
+                stats.evictedDeferred++;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    CorridorPrefetcher(std::vector<RSU>& r, const std::vector<PrefetchedService>& s, const RSUGridIndex& idx, std::vector<Vehicle>& v)
+        : rsus(r), services(s), index(idx), vehicles(v), slots(r.size()) {}
+
+    void addVehicle(Vehicle& vehicle) {
+        vehicle.corridor = computeCorridor(vehicle);
+        vehicle.nextEntry = 0;
+        addEntries(vehicle, 0);
+    }
+
+    // Incremental update: only the corridor of this vehicle is recomputed.
+    // New entries are added before old ones are released so RSUs that stay
+    // on the corridor keep their prefetch.
+    void updateRoute(Vehicle& vehicle, const std::vector<Point>& newRoute, double now) {
+        Vehicle old = vehicle;
+        vehicle.route = newRoute;
+        vehicle.startTime = now;
+        vehicle.routeVersion++;
+        vehicle.corridor = computeCorridor(vehicle);
+        vehicle.nextEntry = 0;
+        addEntries(vehicle, 0);
+        removeEntries(old, old.nextEntry, now);
+    }
+
+    // Issue prefetches that are due and account vehicles reaching their RSUs
+    void tick(double now) {
+        while (!jobs.empty() && jobs.top().dueTime <= now) {
+            PrefetchJob job = jobs.top();
+            jobs.pop();
+            const Vehicle& vehicle = vehicles[job.vehicleId];
+            if (job.routeVersion != vehicle.routeVersion) continue; // Superseded by a route change
+            auto it = slots[job.rsuId].find(vehicle.serviceId);
+            if (it == slots[job.rsuId].end() || it->second.issued) continue;
+            const auto& service = services[vehicle.serviceId];
+            if (!makeRoom(job.rsuId, service.size, job.eta, now)) {
+                // RSU full of images other vehicles are heading for; retry until the ETA
+                if (now + retrySeconds < job.eta) {
+                    job.dueTime = now + retrySeconds;
+                    jobs.push(job);
+                    stats.retriedCapacity++;
+                }
+                continue;
+            }
+            rsus[job.rsuId].usedCapacity += service.size;
+            it->second.issued = true;
+            it->second.readyTime = now + fetchSeconds(vehicle.serviceId);
+            stats.issued++;
+            stats.prefetchCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
+        }
+
+        for (auto& vehicle : vehicles) {
+            while (vehicle.nextEntry < vehicle.corridor.size() && vehicle.corridor[vehicle.nextEntry].eta <= now) {
+                const auto& entry = vehicle.corridor[vehicle.nextEntry];
+                auto it = slots[entry.rsuId].find(vehicle.serviceId);
+                if (it != slots[entry.rsuId].end() && it->second.issued && it->second.readyTime <= now) stats.hits++;
+                else stats.misses++;
+                releaseSlot(entry.rsuId, vehicle.serviceId, {entry.eta, vehicle.id}, now, true);
+                vehicle.nextEntry++;
+            }
+        }
+    }
+
+    const CorridorStats& getStats() const { return stats; }
+};
+
+// Position of a vehicle along its route at time `now`
+Point positionAt(const Vehicle& vehicle, double now) {
+    double distance = std::max(0.0, (now - vehicle.startTime) * vehicle.speed);
+    for (size_t i = 1; i < vehicle.route.size(); ++i) {
+        const Point& a = vehicle.route[i - 1];
+        const Point& b = vehicle.route[i];
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        if (distance <= length) {
+            double f = length == 0.0 ? 0.0 : distance / length;
+            return {a.x + f * (b.x - a.x), a.y + f * (b.y - a.y)};
+        }
+        distance -= length;
+    }
+    return vehicle.route.back();
+}
+
+// Manhattan route between two points (horizontal leg, then vertical leg)
+std::vector<Point> manhattanRoute(Point from, Point to) {
+    return {from, {to.x, from.y}, to};
+}
+
+int main() {
+    const int numRSUs = 100;
+    const int numVehicles = 2000;
+    const double spacing = 1000.0;
+    const double citySize = spacing * 10;
+    const double simSeconds = 900.0;
+    const double divergeFraction = 0.15;
+
+    std::mt19937 gen(7);
+    std::vector<RSU> rsus;
+    std::vector<ServiceRequest> requests;
+    std::vector<PrefetchedService> services;
+    generateScenario(numRSUs, 0, 12, 7, rsus, requests, services);
+    for (auto& rsu : rsus) {
+        rsu.maxCapacity = 60.0; // Image storage per RSU (same units as service size)
+    }
+    std::vector<RSULocation> locations = generateRSUGrid(rsus, spacing, 400.0);
+    RSUGridIndex index(locations, spacing, citySize, citySize);
+
+    // Vehicles with Zipf-like service popularity
+    std::uniform_real_distribution<> coord(0.0, citySize);
+    std::uniform_real_distribution<> speedKmh(30.0, 80.0);
+    std::uniform_real_distribution<> startTime(0.0, 300.0);
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    std::vector<double> popularity;
+    for (size_t s = 0; s < services.size(); ++s) popularity.push_back(1.0 / (s + 1));
+    std::discrete_distribution<int> serviceOf(popularity.begin(), popularity.end());
+
+    std::vector<Vehicle> vehicles;
+    std::vector<double> divergeAt(numVehicles, -1.0);
+    for (int v = 0; v < numVehicles; ++v) {
+        Point from{coord(gen), coord(gen)}, to{coord(gen), coord(gen)};
+        vehicles.push_back({v, serviceOf(gen), speedKmh(gen) / 3.6, startTime(gen), manhattanRoute(from, to), 0, {}, 0});
+        if (unit(gen) < divergeFraction) {
+            divergeAt[v] = vehicles.back().startTime + 60.0 + unit(gen) * 240.0;
+        }
+    }
+
+    // Baseline: BS-PAD static prefetch, services in catalog order while they fit
+    std::vector<RSU> baselineRsus = rsus;
+    std::vector<std::vector<bool>> baselineHeld(numRSUs, std::vector<bool>(services.size(), false));
+    double baselineCost = 0.0;
+    for (auto& rsu : baselineRsus) {
+        double remainingCapacity = rsu.maxCapacity - rsu.usedCapacity;
+        for (const auto& service : services) {
+            if (service.size <= remainingCapacity) {
+                baselineHeld[rsu.id][service.id] = true;
+                remainingCapacity -= service.size;
+                rsu.usedCapacity += service.size;
+                baselineCost += PREFETCH_COST_MULTIPLIER * service.prefetchCost;
+            }
+        }
+    }
+
+    CorridorPrefetcher prefetcher(rsus, services, index, vehicles);
+    for (auto& vehicle : vehicles) {
+        prefetcher.addVehicle(vehicle);
+    }
+    long long initialEntries = prefetcher.getStats().entriesTouched;
+
+    long long baselineHits = 0, baselineMisses = 0;
+    long long routeChanges = 0;
+    long long fullRecomputeEntries = 0; // Work a non-incremental prefetcher would redo per change
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t <= static_cast<int>(simSeconds); ++t) {
+        double now = t;
+        for (auto& vehicle : vehicles) {
+            if (divergeAt[vehicle.id] >= 0.0 && divergeAt[vehicle.id] <= now) {
+                divergeAt[vehicle.id] = -1.0;
+                Point here = positionAt(vehicle, now);
+                Point destination{coord(gen), coord(gen)};
+                prefetcher.updateRoute(vehicle, manhattanRoute(here, destination), now);
+                routeChanges++;
+                for (const auto& other : vehicles) fullRecomputeEntries += other.corridor.size();
+            }
+        }
+
+        // Baseline is judged on the same corridor arrivals
+        for (const auto& vehicle : vehicles) {
+            for (size_t e = vehicle.nextEntry; e < vehicle.corridor.size() && vehicle.corridor[e].eta <= now; ++e) {
+                if (baselineHeld[vehicle.corridor[e].rsuId][vehicle.serviceId]) baselineHits++;
+                else baselineMisses++;
+            }
+        }
+        prefetcher.tick(now);
+
+        if (t % 180 == 0 && t > 0) {
+            const auto& stats = prefetcher.getStats();
+            std::cout << "Time Slot " << t / 180 - 1 << ": Hits = " << stats.hits << ", Misses = " << stats.misses
+                      << ", Issued = " << stats.issued << ", Cancelled = "
+                      << stats.cancelledBeforeIssue + stats.cancelledInFlight << std::endl;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsedMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    const auto& stats = prefetcher.getStats();
+    double hitRate = 100.0 * stats.hits / std::max(1LL, stats.hits + stats.misses);
+    double baselineHitRate = 100.0 * baselineHits / std::max(1LL, baselineHits + baselineMisses);
+    long long incrementalEntries = stats.entriesTouched - initialEntries;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\nCorridor Prefetch: Hit Rate = " << hitRate << "%, Issued = " << stats.issued
+              << ", Prefetch Cost = " << stats.prefetchCost << std::endl;
+    std::cout << "  Cancelled before issue = " << stats.cancelledBeforeIssue << ", cancelled in flight = "
+              << stats.cancelledInFlight << ", evicted unused = " << stats.evictedUnused
+              << ", evicted idle = " << stats.evictedIdle << ", evicted deferred = " << stats.evictedDeferred
+              << ", capacity retries = " << stats.retriedCapacity << std::endl;
+    std::cout << "BS-PAD Static Prefetch: Hit Rate = " << baselineHitRate << "%, Prefetch Cost = " << baselineCost << std::endl;
+    std::cout << "Route Changes = " << routeChanges << ", Corridor Entries Touched = " << incrementalEntries
+              << " (full recompute: " << fullRecomputeEntries << ")" << std::endl;
+    std::cout << "Simulation Time = " << elapsedMs << " ms for " << numVehicles << " vehicles over "
+              << simSeconds << " s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+AVSDSF name interning
+
+One process-wide table that maps function, service, unit and instance names
+to dense 32-bit ids (0, 1, 2, ... in order of first appearance). Names are
+interned where they enter a simulator (configuration, public API); from
+there on, identity is the id, so comparisons, hashing and map keys are
+plain integer operations. Names are looked up again only for output:
+
+    NameId funcA = internName("funcA");   // same id on every call
+    std::cout << nameOf(funcA);
+
+The table is open addressing with linear probing over (hash, id) pairs,
+kept at most half full. Names are stored once in a deque, so references
+returned by nameOf stay valid. A mutex guards the table; it is only taken
+at the boundaries, never on the scheduling path.
+*/
+#ifndef AVSDSF_INTERN_H
+#define AVSDSF_INTERN_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using NameId = uint32_t;
+const NameId NO_NAME = 0xFFFFFFFFu;
+
+class StringInterner {
+private:
+    struct Entry {
+        uint32_t hash;
+        NameId id; // NO_NAME marks an empty slot
+    };
+
+    std::vector<Entry> table = std::vector<Entry>(64, Entry{0, NO_NAME});
+    std::deque<std::string> names;
+    mutable std::mutex lock;
+
+    static uint32_t hashName(std::string_view name) {
+        uint32_t hash = 2166136261u; // FNV-1a
+        for (unsigned char c : name) {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Slot holding `name`, or the empty slot where it would go
+    size_t probe(std::string_view name, uint32_t hash) const {
+        size_t mask = table.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const Entry& entry = table[slot];
+            if (entry.id == NO_NAME || (entry.hash == hash && names[entry.id] == name)) return slot;
+        }
+    }
+
+    void grow() {
+        std::vector<Entry> old(table.size() * 2, Entry{0, NO_NAME});
+        old.swap(table);
+        size_t mask = table.size() - 1;
+        for (const Entry& entry : old) {
+            if (entry.id == NO_NAME) continue;
+            size_t slot = entry.hash & mask;
+            while (table[slot].id != NO_NAME) slot = (slot + 1) & mask;
+            table[slot] = entry;
+        }
+    }
+
+public:
+    NameId intern(std::string_view name) {
+        std::lock_guard<std::mutex> guard(lock);
+        uint32_t hash = hashName(name);
+        size_t slot = probe(name, hash);
+        if (table[slot].id != NO_NAME) return table[slot].id;
+        NameId id = static_cast<NameId>(names.size());
+        names.emplace_back(name);
+        table[slot] = Entry{hash, id};
+        if (names.size() * 2 > table.size()) grow();
+        return id;
+    }
+
+    // Id of an already interned name, or NO_NAME
+    NameId find(std::string_view name) const {
+        std::lock_guard<std::mutex> guard(lock);
+        return table[probe(name, hashName(name))].id;
+    }
+
+    const std::string& name(NameId id) const {
+        static const std::string unknown = "<unnamed>";
+        std::lock_guard<std::mutex> guard(lock);
+        return id < names.size() ? names[id] : unknown;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return names.size();
+    }
+};
+
+// The table shared by all simulators of the process
+inline StringInterner& nameTable() {
+    static StringInterner table;
+    return table;
+}
+
+inline NameId internName(std::string_view name) { return nameTable().intern(name); }
+inline const std::string& nameOf(NameId id) { return nameTable().name(id); }
+
+#endif
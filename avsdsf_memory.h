@@ -0,0 +1,214 @@
+/*
+AVSDSF memory accounting
+
+Replaces the global operator new/delete so that every allocation is
+attributed to the subsystem tag active on the allocating thread. Tags nest
+as a per-thread stack of RAII scopes; untagged allocations go to "other":
+
+    {
+        MemoryTag memory("pagurus.containers");
+        containers.push_back(...);        // bytes and count charged to the tag
+    }
+    memoryCheckpoint();                   // end of slot: steady-state sample
+
+Each block carries a 16-byte header with its size and tag, so a block freed
+under another tag (or on another thread) is still returned to its owner.
+Per-tag live, peak and steady-state bytes are relaxed atomics. The report is
+printed only when AVSDSF_MEMORY is set:
+
+    AVSDSF_MEMORY=1 ./pagurus
+
+Include this header in exactly one translation unit of a program, since it
+defines the replacement allocation functions.
+*/
+#ifndef AVSDSF_MEMORY_H
+#define AVSDSF_MEMORY_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+const int MAX_MEMORY_TAGS = 32;
+
+struct alignas(64) MemoryTagStats {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<int64_t> steadyBytes{0};  // Live bytes at the last checkpoint
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+};
+
+// Constant-initialised, so usable by allocations made before main
+inline MemoryTagStats memoryTags[MAX_MEMORY_TAGS];
+inline std::atomic<int> memoryTagCount{1};
+inline std::mutex memoryTagLock;
+inline thread_local int currentMemoryTag = 0;
+
+// Id of a tag name (a string literal), registered on first use; tags past
+// the table size share slot 0 with untagged allocations
+inline int memoryTagId(const char* name) {
+    int count = memoryTagCount.load(std::memory_order_acquire);
+    for (int i = 1; i < count; ++i) {
+        if (std::strcmp(memoryTags[i].name.load(std::memory_order_relaxed), name) == 0) return i;
+    }
+    std::lock_guard<std::mutex> guard(memoryTagLock);
+    count = memoryTagCount.load(std::memory_order_relaxed);
+    for (int i = 1; i < count; ++i) {
+        if (std::strcmp(memoryTags[i].name.load(std::memory_order_relaxed), name) == 0) return i;
+    }
+    if (count == MAX_MEMORY_TAGS) return 0;
+    memoryTags[count].name.store(name, std::memory_order_relaxed);
+    memoryTagCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+// Attributes allocations of the calling thread to `name` while in scope
+class MemoryTag {
+private:
+    int previous;
+
+public:
+    explicit MemoryTag(const char* name) : previous(currentMemoryTag) { currentMemoryTag = memoryTagId(name); }
+    ~MemoryTag() { currentMemoryTag = previous; }
+
+    MemoryTag(const MemoryTag&) = delete;
+    MemoryTag& operator=(const MemoryTag&) = delete;
+};
+
+struct MemoryBlockHeader {
+    uint64_t size;
+    uint32_t tag;
+    uint32_t alignment; // 0 for blocks from the unaligned operators
+};
+static_assert(sizeof(MemoryBlockHeader) == 16, "header must keep max_align_t alignment");
+
+inline void recordAllocation(int tag, uint64_t size) {
+    MemoryTagStats& stats = memoryTags[tag];
+    int64_t live = stats.liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    int64_t peak = stats.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !stats.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    stats.allocations.fetch_add(1, std::memory_order_relaxed);
+    stats.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+inline void* accountedAllocate(std::size_t size, std::size_t alignment) {
+    std::size_t offset = alignment > sizeof(MemoryBlockHeader) ? alignment : sizeof(MemoryBlockHeader);
+    void* base;
+    if (alignment > sizeof(MemoryBlockHeader)) {
+        std::size_t total = (size + offset + alignment - 1) / alignment * alignment;
+        base = std::aligned_alloc(alignment, total);
+    } else {
+        base = std::malloc(size + offset);
+    }
+    if (!base) return nullptr;
+    char* block = static_cast<char*>(base) + offset;
+    int tag = currentMemoryTag;
+    MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(block) - 1;
+    header->size = size;
+    header->tag = static_cast<uint32_t>(tag);
+    header->alignment = static_cast<uint32_t>(alignment > sizeof(MemoryBlockHeader) ? alignment : 0);
+    recordAllocation(tag, size);
+    return block;
+}
+
+inline void accountedFree(void* block) {
+    if (!block) return;
+    MemoryBlockHeader* header = static_cast<MemoryBlockHeader*>(block) - 1;
+    memoryTags[header->tag].liveBytes.fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+    std::size_t offset = header->alignment ? header->alignment : sizeof(MemoryBlockHeader);
+    std::free(static_cast<char*>(block) - offset);
+}
+
+inline void* accountedAllocateOrThrow(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        if (void* block = accountedAllocate(size, alignment)) return block;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(std::size_t size) { return accountedAllocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return accountedAllocateOrThrow(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return accountedAllocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return accountedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return accountedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return accountedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return accountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return accountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept { accountedFree(block); }
+void operator delete[](void* block) noexcept { accountedFree(block); }
+void operator delete(void* block, std::size_t) noexcept { accountedFree(block); }
+void operator delete[](void* block, std::size_t) noexcept { accountedFree(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { accountedFree(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { accountedFree(block); }
+void operator delete(void* block, std::align_val_t) noexcept { accountedFree(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { accountedFree(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { accountedFree(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { accountedFree(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { accountedFree(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { accountedFree(block); }
+
+// Records every tag's live bytes as its steady-state usage (call between slots)
+inline void memoryCheckpoint() {
+    int count = memoryTagCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) memoryTags[i].steadyBytes.store(memoryTags[i].liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// Restarts peak tracking of a tag from its current live bytes
+inline void resetMemoryPeak(int tag) {
+    memoryTags[tag].peakBytes.store(memoryTags[tag].liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+inline bool memoryReportRequested() {
+    static const bool on = [] {
+        const char* value = std::getenv("AVSDSF_MEMORY");
+        return value && *value && std::strcmp(value, "0") != 0;
+    }();
+    return on;
+}
+
+inline std::string formatBytes(int64_t bytes) {
+    static const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (unit < 3 && (value >= 1024.0 || value <= -1024.0)) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return out.str();
+}
+
+// Peak, steady-state (last checkpoint) and live bytes plus allocation counts per tag
+inline void printMemoryReport(std::ostream& out) {
+    if (!memoryReportRequested()) return;
+    out << "Memory by subsystem:\n  " << std::left << std::setw(22) << "tag" << std::right << std::setw(12) << "peak" << std::setw(12) << "steady"
+        << std::setw(12) << "live" << std::setw(14) << "allocations" << std::setw(14) << "allocated" << std::endl;
+    int count = memoryTagCount.load(std::memory_order_acquire);
+    for (int i = 1; i <= count; ++i) {
+        const MemoryTagStats& stats = memoryTags[i % count]; // "other" last
+        const char* name = i % count ? stats.name.load(std::memory_order_relaxed) : "other";
+        out << "  " << std::left << std::setw(22) << name << std::right << std::setw(12) << formatBytes(stats.peakBytes.load(std::memory_order_relaxed))
+            << std::setw(12) << formatBytes(stats.steadyBytes.load(std::memory_order_relaxed)) << std::setw(12)
+            << formatBytes(stats.liveBytes.load(std::memory_order_relaxed)) << std::setw(14) << stats.allocations.load(std::memory_order_relaxed)
+            << std::setw(14) << formatBytes(static_cast<int64_t>(stats.allocatedBytes.load(std::memory_order_relaxed))) << std::endl;
+    }
+}
+
+#endif
@@ -0,0 +1,294 @@
+/*
+AVSDSF live metrics
+
+In-process registry of counters, gauges and histograms, served in the
+Prometheus text exposition format over HTTP on localhost:
+
+    MetricsRegistry metrics;
+    Counter& scheduled = metrics.counter("avsdsf_requests_scheduled_total", "Requests placed on an RSU");
+    MetricsServer server(metrics, 9464);   // curl http://127.0.0.1:9464/metrics
+
+Updates are relaxed atomic operations on per-thread shards, each on its own
+cache line, so scheduling threads never share a line or take a lock. The
+registry mutex only orders registration against scrapes; a scrape sums the
+shards while the scheduler keeps running.
+*/
+#ifndef AVSDSF_METRICS_H
+#define AVSDSF_METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+const int METRIC_SHARDS = 16;
+
+// Shard of the calling thread, assigned round-robin on first use
+inline int metricShard() {
+    static std::atomic<int> nextShard{0};
+    thread_local int shard = nextShard.fetch_add(1) % METRIC_SHARDS;
+    return shard;
+}
+
+inline uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double bitsDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Lock-free add to a double stored as bits (uncontended within a shard)
+inline void atomicAdd(std::atomic<uint64_t>& target, double delta) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, doubleBits(bitsDouble(current) + delta), std::memory_order_relaxed)) {
+    }
+}
+
+struct alignas(64) MetricCell {
+    std::atomic<uint64_t> value{0};
+};
+
+// Monotonic count, summed over shards when scraped
+class Counter {
+private:
+    MetricCell shards[METRIC_SHARDS];
+
+public:
+    void inc(uint64_t amount = 1) { shards[metricShard()].value.fetch_add(amount, std::memory_order_relaxed); }
+
+    uint64_t value() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards) total += shard.value.load(std::memory_order_relaxed);
+        return total;
+    }
+};
+
+// Current value; usually written by one thread (e.g. the RSU's owner)
+class Gauge {
+private:
+    MetricCell cell;
+
+public:
+    void set(double value) { cell.value.store(doubleBits(value), std::memory_order_relaxed); }
+    void add(double delta) { atomicAdd(cell.value, delta); }
+    double value() const { return bitsDouble(cell.value.load(std::memory_order_relaxed)); }
+};
+
+// Distribution over fixed upper bounds (plus +Inf), sharded like Counter
+class Histogram {
+private:
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets; // Non-cumulative; last bucket is +Inf
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};                     // double bits
+    };
+
+    std::vector<double> bounds;
+    Shard shards[METRIC_SHARDS];
+
+public:
+    explicit Histogram(std::vector<double> upperBounds) : bounds(std::move(upperBounds)) {
+        std::sort(bounds.begin(), bounds.end());
+        for (auto& shard : shards) {
+            shard.buckets.reset(new std::atomic<uint64_t>[bounds.size() + 1]);
+            for (size_t b = 0; b <= bounds.size(); ++b) shard.buckets[b].store(0);
+        }
+    }
+
+    void observe(double value) {
+        Shard& shard = shards[metricShard()];
+        size_t bucket = static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+        shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        atomicAdd(shard.sum, value);
+    }
+
+    // Prometheus samples: cumulative buckets, _sum and _count
+    void render(std::ostringstream& out, const std::string& name, const std::string& labels) const {
+        std::vector<uint64_t> buckets(bounds.size() + 1, 0);
+        uint64_t count = 0;
+        double sum = 0.0;
+        for (const auto& shard : shards) {
+            for (size_t b = 0; b <= bounds.size(); ++b) buckets[b] += shard.buckets[b].load(std::memory_order_relaxed);
+            count += shard.count.load(std::memory_order_relaxed);
+            sum += bitsDouble(shard.sum.load(std::memory_order_relaxed));
+        }
+        std::string prefix = labels.empty() ? "" : labels + ",";
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b <= bounds.size(); ++b) {
+            cumulative += buckets[b];
+            out << name << "_bucket{" << prefix << "le=\"";
+            if (b < bounds.size()) out << bounds[b];
+            else out << "+Inf";
+            out << "\"} " << cumulative << "\n";
+        }
+        std::string braces = labels.empty() ? "" : "{" + labels + "}";
+        out << name << "_sum" << braces << " " << sum << "\n";
+        out << name << "_count" << braces << " " << count << "\n";
+    }
+};
+
+class MetricsRegistry {
+private:
+    struct Family {
+        std::string help;
+        const char* type;
+        std::vector<std::pair<std::string, Counter*>> counters;     // (labels, metric)
+        std::vector<std::pair<std::string, Gauge*>> gauges;
+        std::vector<std::pair<std::string, Histogram*>> histograms;
+    };
+
+    std::mutex lock; // Registration and scraping only
+    std::map<std::string, Family> families;
+    std::vector<std::unique_ptr<Counter>> ownedCounters;
+    std::vector<std::unique_ptr<Gauge>> ownedGauges;
+    std::vector<std::unique_ptr<Histogram>> ownedHistograms;
+
+    Family& family(const std::string& name, const std::string& help, const char* type) {
+        Family& entry = families[name];
+        entry.help = help;
+        entry.type = type;
+        return entry;
+    }
+
+public:
+    // `labels` is the inside of the braces, e.g. rsu="17"
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> guard(lock);
+        ownedCounters.push_back(std::make_unique<Counter>());
+        family(name, help, "counter").counters.push_back({labels, ownedCounters.back().get()});
+        return *ownedCounters.back();
+    }
+
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> guard(lock);
+        ownedGauges.push_back(std::make_unique<Gauge>());
+        family(name, help, "gauge").gauges.push_back({labels, ownedGauges.back().get()});
+        return *ownedGauges.back();
+    }
+
+    Histogram& histogram(const std::string& name, const std::string& help, std::vector<double> bounds, const std::string& labels = "") {
+        std::lock_guard<std::mutex> guard(lock);
+        ownedHistograms.push_back(std::make_unique<Histogram>(std::move(bounds)));
+        family(name, help, "histogram").histograms.push_back({labels, ownedHistograms.back().get()});
+        return *ownedHistograms.back();
+    }
+
+    // Prometheus text exposition format 0.0.4
+    std::string render() {
+        std::lock_guard<std::mutex> guard(lock);
+        std::ostringstream out;
+        out.precision(12);
+        for (const auto& [name, entry] : families) {
+            out << "# HELP " << name << " " << entry.help << "\n# TYPE " << name << " " << entry.type << "\n";
+            for (const auto& [labels, metric] : entry.counters) {
+                out << name << (labels.empty() ? "" : "{" + labels + "}") << " " << metric->value() << "\n";
+            }
+            for (const auto& [labels, metric] : entry.gauges) {
+                out << name << (labels.empty() ? "" : "{" + labels + "}") << " " << metric->value() << "\n";
+            }
+            for (const auto& [labels, metric] : entry.histograms) metric->render(out, name, labels);
+        }
+        return out.str();
+    }
+};
+
+// Minimal HTTP/1.0 responder for GET /metrics on 127.0.0.1, on its own thread
+class MetricsServer {
+private:
+    MetricsRegistry& registry;
+    int listener = -1;
+    int boundPort = 0;
+    std::atomic<bool> running{true};
+    std::thread thread;
+
+    void serve(int fd) {
+        std::string request;
+        char buffer[2048];
+        pollfd readable{fd, POLLIN, 0};
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192 && poll(&readable, 1, 1000) > 0) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            request.append(buffer, static_cast<size_t>(n));
+        }
+        bool metrics = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0;
+        std::string body = metrics ? registry.render() : "Not found; metrics are at /metrics\n";
+        std::string response = std::string(metrics ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n") +
+                               "Content-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(body.size()) +
+                               "\r\nConnection: close\r\n\r\n" + body;
+        for (size_t sent = 0; sent < response.size();) {
+            ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+        close(fd);
+    }
+
+    void run() {
+        pollfd incoming{listener, POLLIN, 0};
+        while (running.load()) {
+            if (poll(&incoming, 1, 200) <= 0) continue;
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0) continue;
+            serve(fd);
+            scrapes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    std::string error;              // Set if the endpoint could not be opened
+    std::atomic<uint64_t> scrapes{0};
+
+    // Port 0 picks a free port; see port()
+    MetricsServer(MetricsRegistry& metrics, int port) : registry(metrics) {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 16) < 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+            error = "metrics endpoint on port " + std::to_string(port) + ": " + std::strerror(errno);
+            if (listener >= 0) close(listener);
+            listener = -1;
+            return;
+        }
+        boundPort = ntohs(address.sin_port);
+        thread = std::thread(&MetricsServer::run, this);
+    }
+
+    ~MetricsServer() {
+        running.store(false);
+        if (thread.joinable()) thread.join();
+        if (listener >= 0) close(listener);
+    }
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool ok() const { return listener >= 0; }
+    int port() const { return boundPort; }
+};
+
+#endif
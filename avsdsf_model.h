@@ -0,0 +1,198 @@
+/*
+AVSDSF shared model
+*/
+#ifndef AVSDSF_MODEL_H
+#define AVSDSF_MODEL_H
+
+#include <vector>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <random>
+#include <algorithm>
+#include <limits>
+
+// Constants and parameters (same values as 6_AVSDSF_final.cpp)
+const double GAMMA = 1.0; // Sensitivity for dynamic weight adjustment
+const double DELTA_C = 0.3;  // Load threshold for weight adjustment
+const double PREFETCH_COST_MULTIPLIER = 0.05; // Prefetching cost multiplier
+const double TRANSFER_COST_MULTIPLIER = 0.1; // Transfer workload penalty
+
+// RSU structure
+struct RSU {
+    int id;
+    double maxCapacity;
+    double usedCapacity;
+    double retentionCost;
+    double computationCost;
+    double preparationCost;
+};
+
+// Service request structure
+struct ServiceRequest {
+    int id;
+    double deadline;
+    double computationLoad;
+    double transferCost;
+    double preparationCost;
+    double demand;
+    double distanceToRSU;
+};
+
+// Prefetched service structure
+struct PrefetchedService {
+    int id;
+    double size; // Storage size of the service
+    double prefetchCost; // Prefetching cost
+};
+
+// RSU position on the road plane (metres)
+struct RSULocation {
+    int rsuId;
+    double x;
+    double y;
+    double coverageRadius;
+};
+
+// Decision variables
+struct DecisionVariables {
+    std::unordered_map<int, int> X; // Request scheduling
+    std::unordered_map<int, int> A; // Container retention
+    std::unordered_map<int, int> P; // Prefetching decisions
+    std::unordered_map<int, int> T; // Transfer decisions
+};
+
+// Compute dynamic weights based on system load
+inline std::vector<double> computeDynamicWeights(double load) {
+    std::vector<double> weights(4);
+    weights[0] = 1.0 / (1.0 + std::exp(-GAMMA * (load - DELTA_C))); // alpha_c
+    weights[1] = 1.0 / (1.0 + std::exp(-GAMMA * (load - DELTA_C - 0.1))); // alpha_r
+    weights[2] = 1.0 / (1.0 + std::exp(-GAMMA * (load - DELTA_C - 0.2))); // alpha_tr
+    weights[3] = 1.0 / (1.0 + std::exp(-GAMMA * (load - DELTA_C - 0.3))); // alpha_p
+    double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    for (auto& weight : weights) {
+        weight /= sum;
+    }
+    return weights;
+}
+
+// Compute system load (used / total capacity over all RSUs)
+inline double computeSystemLoad(const std::vector<RSU>& rsus) {
+    double totalCapacity = std::accumulate(rsus.begin(), rsus.end(), 0.0, [](double sum, const RSU& rsu) {
+        return sum + rsu.maxCapacity;
+    });
+    double usedCapacity = std::accumulate(rsus.begin(), rsus.end(), 0.0, [](double sum, const RSU& rsu) {
+        return sum + rsu.usedCapacity;
+    });
+    return usedCapacity / totalCapacity;
+}
+
+// RS-MAS weighted placement cost of a request on an RSU
+inline double computePlacementCost(const ServiceRequest& request, const RSU& rsu, const std::vector<double>& weights) {
+    return weights[0] * rsu.computationCost * request.computationLoad +
+           weights[1] * rsu.retentionCost +
+           weights[2] * request.transferCost +
+           weights[3] * request.preparationCost;
+}
+
+// Seeded scenario generator. Values are drawn around the example setup in
+// 6_AVSDSF_final.cpp; RSU capacity is scaled so the fleet can hold
+// `capacityFactor` times the total computation load of all requests.
+inline void generateScenario(int numRSUs, int numRequests, int numServices, unsigned seed,
+                             std::vector<RSU>& rsus, std::vector<ServiceRequest>& requests,
+                             std::vector<PrefetchedService>& services, double capacityFactor = 1.5) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> capacity(110.0, 130.0);
+    std::uniform_real_distribution<> rsuCost(0.01, 0.05);
+    std::uniform_real_distribution<> deadline(2.0, 5.0);
+    std::uniform_real_distribution<> load(12.0, 35.0);
+    std::uniform_real_distribution<> requestCost(0.008, 0.035);
+    std::uniform_real_distribution<> demand(5.0, 15.0);
+    std::uniform_real_distribution<> distance(90.0, 130.0);
+    std::uniform_real_distribution<> serviceSize(8.0, 15.0);
+    std::uniform_real_distribution<> prefetchCost(1.5, 3.0);
+
+    requests.clear();
+    double totalLoad = 0.0;
+    for (int i = 0; i < numRequests; ++i) {
+        ServiceRequest request{i, deadline(gen), load(gen), requestCost(gen), requestCost(gen), demand(gen), distance(gen)};
+        totalLoad += request.computationLoad;
+        requests.push_back(request);
+    }
+
+    rsus.clear();
+    double capacityScale = std::max(1.0, capacityFactor * totalLoad / (numRSUs * 120.0));
+    for (int i = 0; i < numRSUs; ++i) {
+        rsus.push_back({i, capacity(gen) * capacityScale, 0.0, rsuCost(gen), rsuCost(gen), rsuCost(gen)});
+    }
+
+    services.clear();
+    for (int i = 0; i < numServices; ++i) {
+        services.push_back({i, serviceSize(gen), prefetchCost(gen)});
+    }
+}
+
+// Place RSUs row-major on a square grid with the given spacing (metres)
+inline std::vector<RSULocation> generateRSUGrid(const std::vector<RSU>& rsus, double spacing, double coverageRadius) {
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(rsus.size()))));
+    std::vector<RSULocation> locations;
+    for (const auto& rsu : rsus) {
+        int row = rsu.id / columns;
+        int column = rsu.id % columns;
+        locations.push_back({rsu.id, (column + 0.5) * spacing, (row + 0.5) * spacing, coverageRadius});
+    }
+    return locations;
+}
+
+// Uniform grid index over RSU locations for nearest-covering-RSU lookups.
+// The cell size must be at least the largest coverage radius.
+class RSUGridIndex {
+private:
+    const std::vector<RSULocation>& locations;
+    double cellSize;
+    int columns;
+    int rows;
+    std::vector<std::vector<int>> cells;
+
+public:
+    RSUGridIndex(const std::vector<RSULocation>& locs, double cell, double width, double height)
+        : locations(locs), cellSize(cell) {
+        columns = static_cast<int>(std::ceil(width / cellSize)) + 1;
+        rows = static_cast<int>(std::ceil(height / cellSize)) + 1;
+        cells.resize(columns * rows);
+        for (size_t i = 0; i < locations.size(); ++i) {
+            cells[cellOf(locations[i].x, locations[i].y)].push_back(static_cast<int>(i));
+        }
+    }
+
+    int cellOf(double x, double y) const {
+        int cx = std::clamp(static_cast<int>(x / cellSize), 0, columns - 1);
+        int cy = std::clamp(static_cast<int>(y / cellSize), 0, rows - 1);
+        return cy * columns + cx;
+    }
+
+    // RSU whose coverage contains the point (nearest one), or -1
+    int coveringRSU(double x, double y) const {
+        int cx = std::clamp(static_cast<int>(x / cellSize), 0, columns - 1);
+        int cy = std::clamp(static_cast<int>(y / cellSize), 0, rows - 1);
+        int best = -1;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= columns || ny >= rows) continue;
+                for (int index : cells[ny * columns + nx]) {
+                    const auto& loc = locations[index];
+                    double d = std::hypot(loc.x - x, loc.y - y);
+                    if (d <= loc.coverageRadius && d < bestDistance) {
+                        bestDistance = d;
+                        best = loc.rsuId;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+};
+
+#endif
@@ -0,0 +1,240 @@
+/*
+AVSDSF hardware performance counters
+
+Optional per-phase counting of cycles, instructions, L1D read misses, LLC
+misses and branch misses through Linux perf_event_open. Collection is off
+unless AVSDSF_PERF is set (to anything but "0"):
+
+    AVSDSF_PERF=1 ./sampled_placement
+
+Each thread opens its own counter group on first use, so counts are per
+thread. Events the CPU, kernel or container does not provide are reported
+as unavailable (perf_event_paranoid, missing PMU in a VM), and if the group
+cannot be opened at all only wall-clock figures are printed.
+*/
+#ifndef AVSDSF_PERF_H
+#define AVSDSF_PERF_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+enum CounterIndex { Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, NUM_COUNTERS };
+
+inline const char* counterName(int counter) {
+    static const char* names[NUM_COUNTERS] = {"cycles", "instructions", "L1D misses", "LLC misses", "branch misses"};
+    return names[counter];
+}
+
+struct CounterSample {
+    uint64_t value[NUM_COUNTERS] = {};
+    bool available[NUM_COUNTERS] = {};
+    double seconds = 0.0;
+    bool accumulated = false; // Holds a += total, whose flags are set by its first sample
+
+    CounterSample operator-(const CounterSample& start) const {
+        CounterSample delta;
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            delta.available[i] = available[i] && start.available[i];
+            delta.value[i] = delta.available[i] ? value[i] - start.value[i] : 0;
+        }
+        delta.seconds = seconds - start.seconds;
+        return delta;
+    }
+
+    // A total reports a counter only if every sample added to it had that
+    // counter, so a multiplexed-out sample cannot leave a partial sum
+    CounterSample& operator+=(const CounterSample& other) {
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            available[i] = accumulated ? available[i] && other.available[i] : other.available[i];
+            value[i] += other.value[i];
+        }
+        seconds += other.seconds;
+        accumulated = true;
+        return *this;
+    }
+};
+
+// Counter group of the calling thread (user-space events only)
+class PerfCounters {
+private:
+    int leader = -1;
+    int fds[NUM_COUNTERS];
+    int order[NUM_COUNTERS]; // Counter index of each group member in read order
+    int members = 0;
+
+    static int open(uint32_t type, uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+
+    PerfCounters() {
+        static const std::pair<uint32_t, uint64_t> events[NUM_COUNTERS] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+        };
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            fds[i] = open(events[i].first, events[i].second, leader);
+            if (fds[i] < 0) {
+                if (i == Cycles) {
+                    unavailableReason = std::strerror(errno);
+                    if (errno == EACCES || errno == EPERM) unavailableReason += " (check /proc/sys/kernel/perf_event_paranoid)";
+                    return;
+                }
+                continue; // Event not supported here; the rest of the group still counts
+            }
+            if (i == Cycles) leader = fds[i];
+            order[members++] = i;
+        }
+    }
+
+public:
+    std::string unavailableReason;
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            if (leader >= 0 && fds[i] >= 0) close(fds[i]);
+        }
+    }
+
+    static PerfCounters& forThread() {
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    // Counters are collected only when AVSDSF_PERF is set
+    static bool requested() {
+        static const bool on = [] {
+            const char* value = std::getenv("AVSDSF_PERF");
+            return value && *value && std::strcmp(value, "0") != 0;
+        }();
+        return on;
+    }
+
+    bool ok() const { return leader >= 0; }
+
+    // Current totals, scaled up if the kernel multiplexed the group
+    CounterSample read() const {
+        CounterSample sample;
+        sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (leader < 0) return sample;
+        uint64_t buffer[3 + NUM_COUNTERS];
+        if (::read(leader, buffer, sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(uint64_t))) return sample;
+        uint64_t enabled = buffer[1], running = buffer[2];
+        if (running == 0) return sample; // Group never got onto the PMU
+        for (uint64_t m = 0; m < buffer[0] && m < static_cast<uint64_t>(members); ++m) {
+            uint64_t value = buffer[3 + m];
+            if (running < enabled) value = static_cast<uint64_t>(static_cast<double>(value) * enabled / running);
+            sample.value[order[m]] = value;
+            sample.available[order[m]] = true;
+        }
+        return sample;
+    }
+};
+
+// "IPC = ..., L1D misses = ... per decision" for one measured region
+inline std::string describeCounters(const CounterSample& delta, long long decisions) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    double perDecision = 1.0 / std::max(1LL, decisions);
+    if (delta.available[Cycles] && delta.available[Instructions] && delta.value[Cycles] > 0) {
+        out << "IPC = " << static_cast<double>(delta.value[Instructions]) / delta.value[Cycles];
+    } else {
+        out << "IPC = n/a";
+    }
+    out << ", per decision:";
+    for (int i : {Cycles, L1DMisses, LLCMisses, BranchMisses}) {
+        out << " " << counterName(i) << " = ";
+        if (delta.available[i]) out << delta.value[i] * perDecision;
+        else out << "n/a";
+    }
+    return out.str();
+}
+
+// Counter totals per (phase, thread), filled by Scope objects from any thread
+class PhaseCounters {
+private:
+    struct Totals {
+        CounterSample counts;
+        long long decisions = 0;
+        long long calls = 0;
+    };
+
+    std::mutex lock;
+    std::map<std::pair<std::string, std::string>, Totals> totals;
+
+public:
+    class Scope {
+    private:
+        PhaseCounters& owner;
+        const char* phase;
+        const char* thread;
+        CounterSample start;
+        bool active;
+
+    public:
+        long long decisions;
+
+        Scope(PhaseCounters& counters, const char* phaseName, const char* threadName, long long decisionCount = 0)
+            : owner(counters), phase(phaseName), thread(threadName), active(PerfCounters::requested()), decisions(decisionCount) {
+            if (active) start = PerfCounters::forThread().read();
+        }
+
+        ~Scope() {
+            if (active) owner.add(phase, thread, PerfCounters::forThread().read() - start, decisions);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    void add(const char* phase, const char* thread, const CounterSample& delta, long long decisions) {
+        std::lock_guard<std::mutex> guard(lock);
+        Totals& entry = totals[{phase, thread}];
+        entry.counts += delta;
+        entry.decisions += decisions;
+        entry.calls++;
+    }
+
+    void report(std::ostream& out) {
+        if (!PerfCounters::requested()) return;
+        std::lock_guard<std::mutex> guard(lock);
+        const PerfCounters& counters = PerfCounters::forThread();
+        if (!counters.ok()) out << "Hardware counters unavailable (" << counters.unavailableReason << "); wall-clock only" << std::endl;
+        for (const auto& [key, entry] : totals) {
+            out << "  " << std::left << std::setw(12) << key.first << std::setw(12) << key.second << std::right
+                << std::fixed << std::setprecision(3) << entry.counts.seconds * 1000.0 / std::max(1LL, entry.calls) << " ms/call, "
+                << entry.counts.seconds * 1e9 / std::max(1LL, entry.decisions) << " ns/decision";
+            if (counters.ok()) out << ", " << describeCounters(entry.counts, entry.decisions);
+            out << std::endl;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+AVSDSF object pools
+
+Index-addressed storage for objects that are created and destroyed at high
+rates (PAGURUS containers, LDLS tasks). Objects live in one slot array and
+are named by 32-bit indices, which stay valid until the object is destroyed.
+Destroyed slots go on a free list and are reused before the array grows, so
+once the pool has reached its working size, creating an object does not call
+the allocator (its own members aside). Each slot also carries intrusive
+prev/next links, so an object can sit in one PoolList, such as the
+containers of a function, without a list node of its own:
+
+    IndexPool<Container> containers;
+    PoolList functionA;
+    Container container(internName("FunctionA"), PRIVATE_CONTAINER, true);
+    uint32_t id = containers.append(functionA, std::move(container));
+    for (Container& container : containers.items(functionA)) ...
+    containers.remove(functionA, id);
+
+Indices survive growth of the pool; references do not, so do not hold a
+reference across append().
+*/
+#ifndef AVSDSF_POOL_H
+#define AVSDSF_POOL_H
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+const uint32_t POOL_NIL = 0xFFFFFFFFu;
+
+// Head of an intrusive list of pool slots
+struct PoolList {
+    uint32_t head = POOL_NIL;
+    uint32_t tail = POOL_NIL;
+    uint32_t size = 0;
+};
+
+template <typename T>
+class IndexPool {
+private:
+    struct Slot {
+        std::optional<T> value;   // Empty while the slot is free
+        uint32_t prev = POOL_NIL;
+        uint32_t next = POOL_NIL; // Next in its list, or next free slot
+    };
+
+    std::vector<Slot> slots;
+    uint32_t freeHead = POOL_NIL;
+    uint32_t live = 0;
+
+public:
+    template <bool Const>
+    class Iterator {
+    private:
+        using Pool = std::conditional_t<Const, const IndexPool, IndexPool>;
+        Pool* pool;
+        uint32_t index;
+
+    public:
+        Iterator(Pool* owner, uint32_t at) : pool(owner), index(at) {}
+        auto& operator*() const { return (*pool)[index]; }
+        Iterator& operator++() {
+            index = pool->next(index);
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+        uint32_t id() const { return index; }
+    };
+
+    template <bool Const>
+    struct Range {
+        Iterator<Const> first;
+        Iterator<Const> begin() const { return first; }
+        Iterator<Const> end() const { return {nullptr, POOL_NIL}; }
+    };
+
+    // Stores the object (taking ownership) in a free slot, or a new one
+    template <typename... Args>
+    uint32_t create(Args&&... args) {
+        uint32_t index;
+        if (freeHead != POOL_NIL) {
+            index = freeHead;
+            freeHead = slots[index].next;
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        Slot& slot = slots[index];
+        slot.value.emplace(std::forward<Args>(args)...);
+        slot.prev = slot.next = POOL_NIL;
+        live++;
+        return index;
+    }
+
+    // Destroys an object that is in no list and puts its slot on the free list
+    void destroy(uint32_t index) {
+        assert(slots[index].value);
+        slots[index].value.reset();
+        slots[index].next = freeHead;
+        freeHead = index;
+        live--;
+    }
+
+    void linkBack(PoolList& list, uint32_t index) {
+        slots[index].prev = list.tail;
+        slots[index].next = POOL_NIL;
+        if (list.tail != POOL_NIL) slots[list.tail].next = index;
+        else list.head = index;
+        list.tail = index;
+        list.size++;
+    }
+
+    void unlink(PoolList& list, uint32_t index) {
+        Slot& slot = slots[index];
+        if (slot.prev != POOL_NIL) slots[slot.prev].next = slot.next;
+        else list.head = slot.next;
+        if (slot.next != POOL_NIL) slots[slot.next].prev = slot.prev;
+        else list.tail = slot.prev;
+        slot.prev = slot.next = POOL_NIL;
+        list.size--;
+    }
+
+    uint32_t append(PoolList& list, T value) {
+        uint32_t index = create(std::move(value));
+        linkBack(list, index);
+        return index;
+    }
+
+    void remove(PoolList& list, uint32_t index) {
+        unlink(list, index);
+        destroy(index);
+    }
+
+    T& operator[](uint32_t index) { return *slots[index].value; }
+    const T& operator[](uint32_t index) const { return *slots[index].value; }
+    uint32_t next(uint32_t index) const { return slots[index].next; }
+
+    Range<false> items(const PoolList& list) { return {{this, list.head}}; }
+    Range<true> items(const PoolList& list) const { return {{this, list.head}}; }
+
+    void reserve(size_t count) { slots.reserve(count); }
+    size_t size() const { return live; }
+    size_t capacity() const { return slots.size(); }
+};
+
+#endif
@@ -0,0 +1,241 @@
+/*
+AVSDSF phase tracing
+
+Records begin/end events of scheduler phases into per-thread buffers and
+writes them at exit as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+or, for a path ending in ".pftrace", as a Perfetto protobuf trace.
+Tracing is off unless AVSDSF_TRACE names the output file, so programs print
+exactly the same output without it:
+
+    AVSDSF_TRACE=onco.json ./onco
+
+Each thread appends only to its own buffer, so recording takes no lock;
+buffers are linked into a global list with a compare-and-swap on first use
+and outlive their thread until the trace is written.
+*/
+#ifndef AVSDSF_TRACE_H
+#define AVSDSF_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+struct TraceEvent {
+    uint64_t timestamp; // Nanoseconds since the trace started
+    const char* name;   // String literal; nullptr for an end event
+};
+
+// Events of one thread, in fixed-size chunks so appending never relocates
+// events the writer may be reading
+class TraceBuffer {
+public:
+    static constexpr size_t CHUNK_EVENTS = 16384;
+
+    struct Chunk {
+        TraceEvent events[CHUNK_EVENTS];
+        std::atomic<size_t> count{0};
+        std::atomic<Chunk*> next{nullptr};
+    };
+
+    Chunk* head;
+    Chunk* tail;
+    long threadId;
+    std::atomic<const char*> threadName{nullptr};
+    TraceBuffer* nextBuffer = nullptr;
+
+    explicit TraceBuffer(long tid) : head(new Chunk), tail(head), threadId(tid) {}
+
+    ~TraceBuffer() {
+        for (Chunk* chunk = head; chunk;) {
+            Chunk* next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    void append(uint64_t timestamp, const char* name) {
+        size_t count = tail->count.load(std::memory_order_relaxed);
+        if (count == CHUNK_EVENTS) {
+            Chunk* chunk = new Chunk;
+            tail->next.store(chunk, std::memory_order_release);
+            tail = chunk;
+            count = 0;
+        }
+        tail->events[count] = {timestamp, name};
+        tail->count.store(count + 1, std::memory_order_release);
+    }
+};
+
+class TraceLog {
+private:
+    std::atomic<TraceBuffer*> buffers{nullptr};
+    std::string path;
+    std::chrono::steady_clock::time_point origin;
+
+    TraceLog() : origin(std::chrono::steady_clock::now()) {
+        const char* file = std::getenv("AVSDSF_TRACE");
+        if (file && *file) {
+            path = file;
+            enabled = true;
+        }
+    }
+
+    static void appendVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static void appendField(std::string& out, int field, uint64_t value) {
+        appendVarint(out, static_cast<uint64_t>(field) << 3);
+        appendVarint(out, value);
+    }
+
+    static void appendField(std::string& out, int field, const std::string& bytes) {
+        appendVarint(out, (static_cast<uint64_t>(field) << 3) | 2);
+        appendVarint(out, bytes.size());
+        out += bytes;
+    }
+
+    static std::string threadLabel(const TraceBuffer& buffer) {
+        const char* name = buffer.threadName.load();
+        return name ? name : "thread " + std::to_string(buffer.threadId);
+    }
+
+    // Chrome trace event format, timestamps in microseconds
+    void writeJson(std::FILE* file, long pid) const {
+        std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        bool first = true;
+        for (TraceBuffer* buffer = buffers.load(); buffer; buffer = buffer->nextBuffer) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+                         first ? "" : ",\n", pid, buffer->threadId, threadLabel(*buffer).c_str());
+            first = false;
+            for (TraceBuffer::Chunk* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+                size_t count = chunk->count.load(std::memory_order_acquire);
+                for (size_t i = 0; i < count; ++i) {
+                    const TraceEvent& event = chunk->events[i];
+                    if (event.name) {
+                        std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%ld}",
+                                     event.name, event.timestamp / 1000.0, pid, buffer->threadId);
+                    } else {
+                        std::fprintf(file, ",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%ld}",
+                                     event.timestamp / 1000.0, pid, buffer->threadId);
+                    }
+                }
+            }
+        }
+        std::fprintf(file, "\n]}\n");
+    }
+
+    // Perfetto Trace proto: one thread track per buffer, slice begin/end track events
+    void writeProto(std::FILE* file, long pid) const {
+        const uint64_t trackBase = 0x41565344ull << 16;
+        for (TraceBuffer* buffer = buffers.load(); buffer; buffer = buffer->nextBuffer) {
+            uint64_t track = trackBase + static_cast<uint64_t>(buffer->threadId);
+            std::string thread, descriptor, packet, out;
+            appendField(thread, 1, static_cast<uint64_t>(pid));             // ThreadDescriptor.pid
+            appendField(thread, 2, static_cast<uint64_t>(buffer->threadId)); // ThreadDescriptor.tid
+            appendField(thread, 5, threadLabel(*buffer));                     // ThreadDescriptor.thread_name
+            appendField(descriptor, 1, track);                                // TrackDescriptor.uuid
+            appendField(descriptor, 4, thread);                               // TrackDescriptor.thread
+            appendField(packet, 60, descriptor);                              // TracePacket.track_descriptor
+            appendField(out, 1, packet);                                      // Trace.packet
+            for (TraceBuffer::Chunk* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+                size_t count = chunk->count.load(std::memory_order_acquire);
+                for (size_t i = 0; i < count; ++i) {
+                    const TraceEvent& event = chunk->events[i];
+                    std::string trackEvent;
+                    appendField(trackEvent, 9, event.name ? 1 : 2);           // TrackEvent.type: SLICE_BEGIN / SLICE_END
+                    appendField(trackEvent, 11, track);                       // TrackEvent.track_uuid
+                    if (event.name) appendField(trackEvent, 23, std::string(event.name)); // TrackEvent.name
+                    packet.clear();
+                    appendField(packet, 8, event.timestamp);                  // TracePacket.timestamp
+                    appendField(packet, 10, 1);                               // TracePacket.trusted_packet_sequence_id
+                    appendField(packet, 11, trackEvent);                      // TracePacket.track_event
+                    appendField(out, 1, packet);
+                }
+            }
+            std::fwrite(out.data(), 1, out.size(), file);
+        }
+    }
+
+public:
+    bool enabled = false;
+
+    static TraceLog& instance() {
+        static TraceLog log;
+        return log;
+    }
+
+    ~TraceLog() {
+        if (!enabled) return;
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::fprintf(stderr, "Could not write trace to %s\n", path.c_str());
+        } else {
+            bool proto = path.size() >= 8 && path.compare(path.size() - 8, 8, ".pftrace") == 0;
+            long pid = static_cast<long>(getpid());
+            if (proto) writeProto(file, pid);
+            else writeJson(file, pid);
+            std::fclose(file);
+        }
+        for (TraceBuffer* buffer = buffers.load(); buffer;) {
+            TraceBuffer* next = buffer->nextBuffer;
+            delete buffer;
+            buffer = next;
+        }
+    }
+
+    uint64_t now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+    }
+
+    TraceBuffer& local() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (!buffer) {
+            long tid = static_cast<long>(syscall(SYS_gettid));
+            buffer = new TraceBuffer(tid);
+            if (tid == static_cast<long>(getpid())) buffer->threadName.store("main");
+            TraceBuffer* head = buffers.load();
+            do {
+                buffer->nextBuffer = head;
+            } while (!buffers.compare_exchange_weak(head, buffer));
+        }
+        return *buffer;
+    }
+};
+
+// Start a phase on the calling thread; phases nest and end innermost first
+inline void traceBegin(const char* phase) {
+    TraceLog& log = TraceLog::instance();
+    if (log.enabled) log.local().append(log.now(), phase);
+}
+
+inline void traceEnd() {
+    TraceLog& log = TraceLog::instance();
+    if (log.enabled) log.local().append(log.now(), nullptr);
+}
+
+// Label the calling thread's track (string literal)
+inline void traceThreadName(const char* name) {
+    TraceLog& log = TraceLog::instance();
+    if (log.enabled) log.local().threadName.store(name);
+}
+
+// Phase covering the rest of the enclosing scope
+class TracePhase {
+public:
+    explicit TracePhase(const char* phase) { traceBegin(phase); }
+    ~TracePhase() { traceEnd(); }
+    TracePhase(const TracePhase&) = delete;
+    TracePhase& operator=(const TracePhase&) = delete;
+};
+
+#endif